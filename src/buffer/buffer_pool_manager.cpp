@@ -47,6 +47,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
     frame_id_t frame_id = page_table_[page_id];
     Page *ans = &(pages_[frame_id]);
     ans->pin_count_++;
+    replacer_->Pin(frame_id);
     return ans;
   }
   // P不在pagetable中(说明page不在缓冲池中，而在磁盘中)
@@ -83,7 +84,7 @@ Page *BufferPoolManager::FetchPageImpl(page_id_t page_id) {
 
 bool BufferPoolManager::UnpinPageImpl(page_id_t page_id, bool is_dirty) {
   std::scoped_lock lock{latch_};
-  if (page_table_.count(page_id) ==1) {
+  if (page_table_.count(page_id) == 0) {
     return false;
   }
   frame_id_t frame_id = page_table_[page_id];
@@ -107,7 +108,7 @@ bool BufferPoolManager::FlushPageImpl(page_id_t page_id) {
   if (page_id == INVALID_PAGE_ID) {
     return false;
   }
-  if (page_table_.count(page_id) ==1) {
+  if (page_table_.count(page_id) == 0) {
     return false;
   }
   frame_id_t frame_id = page_table_[page_id];
@@ -157,8 +158,8 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
   std::scoped_lock lock{latch_};
-  disk_manager_->DeallocatePage(page_id);
   if (page_table_.count(page_id) == 0) {
+    disk_manager_->DeallocatePage(page_id);
     return true;
   }
   frame_id_t frame_id = page_table_[page_id];
@@ -166,8 +167,14 @@ bool BufferPoolManager::DeletePageImpl(page_id_t page_id) {
   if (page->pin_count_ != 0) {
     return false;
   }
+  disk_manager_->DeallocatePage(page_id);
   page_table_.erase(page_id);
-  free_list_.push_back(page_id);
+  // the frame goes back to the free list, so it must no longer be a victim candidate
+  replacer_->Pin(frame_id);
+  page->ResetMemory();
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  free_list_.push_back(frame_id);
 
   return true;
 }
@@ -0,0 +1,443 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.cpp
+//
+// Identification: src/container/hash/extendible_hash_table.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "container/hash/extendible_hash_table.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_TYPE::ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                                                bool unique_keys)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      unique_keys_(unique_keys) {
+  page_id_t bucket_page_id;
+  Page *bucket_page = buffer_pool_manager_->NewPage(&bucket_page_id);
+  Page *directory_page = buffer_pool_manager_->NewPage(&directory_page_id_);
+  if (bucket_page == nullptr || directory_page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  reinterpret_cast<BucketPage *>(bucket_page->GetData())->Init();
+  reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())->Init(directory_page_id_, bucket_page_id);
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+}
+
+/*****************************************************************************
+ * HELPERS
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::Hash(const KeyType &key) {
+  return static_cast<uint32_t>(hash_fn_.GetHash(key));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+HashTableDirectoryPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchDirectoryPage() {
+  Page *page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  if (page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  return reinterpret_cast<HashTableDirectoryPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename EXTENDIBLE_HASH_TABLE_TYPE::BucketPage *EXTENDIBLE_HASH_TABLE_TYPE::FetchBucketPage(page_id_t bucket_page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  if (page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  return reinterpret_cast<BucketPage *>(page->GetData());
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+typename EXTENDIBLE_HASH_TABLE_TYPE::InsertResult EXTENDIBLE_HASH_TABLE_TYPE::InsertIntoBucket(
+    page_id_t bucket_page_id, const KeyType &key, const ValueType &value, bool overflow) {
+  page_id_t page_id = bucket_page_id;
+  while (true) {
+    BucketPage *bucket = FetchBucketPage(page_id);
+    for (uint32_t i = 0; i < bucket->GetSize(); i++) {
+      if (comparator_(bucket->KeyAt(i), key) == 0 && (unique_keys_ || bucket->ValueAt(i) == value)) {
+        buffer_pool_manager_->UnpinPage(page_id, false);
+        return InsertResult::DUPLICATE;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+      continue;
+    }
+    if (!bucket->IsFull()) {
+      bucket->Append(key, value);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      return InsertResult::INSERTED;
+    }
+    if (!overflow) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return InsertResult::FULL;
+    }
+    page_id_t overflow_page_id;
+    Page *overflow_page = buffer_pool_manager_->NewPage(&overflow_page_id);
+    if (overflow_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      throw std::runtime_error("out of memory");
+    }
+    auto overflow_bucket = reinterpret_cast<BucketPage *>(overflow_page->GetData());
+    overflow_bucket->Init();
+    overflow_bucket->Append(key, value);
+    bucket->SetNextPageId(overflow_page_id);
+    buffer_pool_manager_->UnpinPage(overflow_page_id, true);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return InsertResult::INSERTED;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::RemoveFromBucket(page_id_t bucket_page_id, const KeyType &key,
+                                                  const ValueType &value) {
+  std::vector<page_id_t> chain;
+  page_id_t found_page_id = INVALID_PAGE_ID;
+  uint32_t found_ind = 0;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    chain.push_back(page_id);
+    BucketPage *bucket = FetchBucketPage(page_id);
+    for (uint32_t i = 0; found_page_id == INVALID_PAGE_ID && i < bucket->GetSize(); i++) {
+      if (comparator_(bucket->KeyAt(i), key) == 0 && bucket->ValueAt(i) == value) {
+        found_page_id = page_id;
+        found_ind = i;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  if (found_page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+
+  // every page but the last one stays full, so the hole is filled from the last page
+  page_id_t last_page_id = chain.back();
+  BucketPage *last = FetchBucketPage(last_page_id);
+  MappingType item = last->PopBack();
+  bool filled = found_page_id == last_page_id && found_ind == last->GetSize();
+  bool last_empty = last->GetSize() == 0;
+  buffer_pool_manager_->UnpinPage(last_page_id, true);
+  if (!filled) {
+    BucketPage *bucket = FetchBucketPage(found_page_id);
+    bucket->SetItem(found_ind, item);
+    buffer_pool_manager_->UnpinPage(found_page_id, true);
+  }
+  if (last_empty && chain.size() > 1) {
+    page_id_t prev_page_id = chain[chain.size() - 2];
+    FetchBucketPage(prev_page_id)->SetNextPageId(INVALID_PAGE_ID);
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    buffer_pool_manager_->DeletePage(last_page_id);
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::vector<MappingType> EXTENDIBLE_HASH_TABLE_TYPE::ReadBucket(page_id_t bucket_page_id) {
+  std::vector<MappingType> items;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    BucketPage *bucket = FetchBucketPage(page_id);
+    for (uint32_t i = 0; i < bucket->GetSize(); i++) {
+      items.emplace_back(bucket->KeyAt(i), bucket->ValueAt(i));
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return items;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::RefillBucket(page_id_t bucket_page_id, const std::vector<MappingType> &items) {
+  BucketPage *bucket = FetchBucketPage(bucket_page_id);
+  for (page_id_t page_id = bucket->GetNextPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id_t next_page_id = FetchBucketPage(page_id)->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    buffer_pool_manager_->DeletePage(page_id);
+    page_id = next_page_id;
+  }
+  bucket->Init();
+  page_id_t page_id = bucket_page_id;
+  for (const auto &item : items) {
+    if (bucket->IsFull()) {
+      page_id_t overflow_page_id;
+      Page *overflow_page = buffer_pool_manager_->NewPage(&overflow_page_id);
+      if (overflow_page == nullptr) {
+        buffer_pool_manager_->UnpinPage(page_id, true);
+        throw std::runtime_error("out of memory");
+      }
+      bucket->SetNextPageId(overflow_page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      bucket = reinterpret_cast<BucketPage *>(overflow_page->GetData());
+      bucket->Init();
+      page_id = overflow_page_id;
+    }
+    bucket->Append(item.first, item.second);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx) {
+  uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+  if (local_depth == HashTableDirectoryPage::MAX_DEPTH) {
+    return false;
+  }
+  page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+  std::vector<MappingType> items = ReadBucket(bucket_page_id);
+  // keys that agree in all hash bits the directory can still tell apart stay in one bucket, with overflow pages
+  uint32_t split_bits = (HashTableDirectoryPage::DIRECTORY_ARRAY_SIZE - 1) & ~((1U << local_depth) - 1);
+  bool separable = false;
+  for (const auto &item : items) {
+    separable = separable || ((Hash(item.first) ^ Hash(items[0].first)) & split_bits) != 0;
+  }
+  if (!separable) {
+    return false;
+  }
+
+  if (local_depth == directory->GetGlobalDepth()) {
+    directory->IncrGlobalDepth();
+  }
+  page_id_t image_page_id;
+  Page *image_page = buffer_pool_manager_->NewPage(&image_page_id);
+  if (image_page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  reinterpret_cast<BucketPage *>(image_page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(image_page_id, true);
+  uint32_t high_bit = 1U << local_depth;
+  std::vector<MappingType> stay;
+  std::vector<MappingType> move;
+  for (const auto &item : items) {
+    ((Hash(item.first) & high_bit) != 0 ? move : stay).push_back(item);
+  }
+  RefillBucket(bucket_page_id, stay);
+  RefillBucket(image_page_id, move);
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    if (directory->GetBucketPageId(i) == bucket_page_id) {
+      directory->SetLocalDepth(i, local_depth + 1);
+      if ((i & high_bit) != 0) {
+        directory->SetBucketPageId(i, image_page_id);
+      }
+    }
+  }
+  return true;
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key,
+                                          std::vector<ValueType> *result) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  // the latch of the first page of a bucket covers its overflow pages
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket_page->RLatch();
+  bool found = false;
+  for (page_id_t page_id = bucket_page_id; page_id != INVALID_PAGE_ID;) {
+    BucketPage *bucket = FetchBucketPage(page_id);
+    for (uint32_t i = 0; i < bucket->GetSize(); i++) {
+      if (comparator_(bucket->KeyAt(i), key) == 0) {
+        result->push_back(bucket->ValueAt(i));
+        found = true;
+      }
+    }
+    page_id_t next_page_id = bucket->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  bucket_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  InsertResult result = InsertIntoBucket(bucket_page_id, key, value, false);
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (result == InsertResult::FULL) {
+    return SplitInsert(key, value);
+  }
+  return result == InsertResult::INSERTED;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::SplitInsert(const KeyType &key, const ValueType &value) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  InsertResult result;
+  // the bucket may have been split or emptied since the latches were released, so everything is checked again
+  while (true) {
+    uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+    result = InsertIntoBucket(directory->GetBucketPageId(bucket_idx), key, value, false);
+    if (result != InsertResult::FULL) {
+      break;
+    }
+    if (!SplitBucket(directory, bucket_idx)) {
+      result = InsertIntoBucket(directory->GetBucketPageId(bucket_idx), key, value, true);
+      break;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+  return result == InsertResult::INSERTED;
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  page_id_t bucket_page_id = directory->GetBucketPageId(Hash(key) & directory->GetGlobalDepthMask());
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  bool removed = RemoveFromBucket(bucket_page_id, key, value);
+  auto bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+  bool empty = bucket->GetSize() == 0 && bucket->GetNextPageId() == INVALID_PAGE_ID;
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  if (removed && empty) {
+    Merge(key);
+  }
+  return removed;
+}
+
+/*****************************************************************************
+ * MERGE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_TYPE::Merge(const KeyType &key) {
+  table_latch_.WLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  uint32_t bucket_idx = Hash(key) & directory->GetGlobalDepthMask();
+  // a merged bucket may be empty as well, so keep merging while either side of a pair is empty
+  while (directory->GetLocalDepth(bucket_idx) > 0) {
+    uint32_t local_depth = directory->GetLocalDepth(bucket_idx);
+    uint32_t image_idx = directory->GetSplitImageIndex(bucket_idx);
+    if (directory->GetLocalDepth(image_idx) != local_depth) {
+      break;
+    }
+    page_id_t bucket_page_id = directory->GetBucketPageId(bucket_idx);
+    page_id_t image_page_id = directory->GetBucketPageId(image_idx);
+    auto is_empty = [this](page_id_t page_id) {
+      BucketPage *bucket = FetchBucketPage(page_id);
+      bool empty = bucket->GetSize() == 0 && bucket->GetNextPageId() == INVALID_PAGE_ID;
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      return empty;
+    };
+    if (!is_empty(bucket_page_id)) {
+      if (!is_empty(image_page_id)) {
+        break;
+      }
+      std::swap(bucket_page_id, image_page_id);
+    }
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) == bucket_page_id || directory->GetBucketPageId(i) == image_page_id) {
+        directory->SetBucketPageId(i, image_page_id);
+        directory->SetLocalDepth(i, local_depth - 1);
+      }
+    }
+    buffer_pool_manager_->DeletePage(bucket_page_id);
+  }
+  while (directory->CanShrink()) {
+    directory->DecrGlobalDepth();
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+}
+
+/*****************************************************************************
+ * GETGLOBALDEPTH
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t EXTENDIBLE_HASH_TABLE_TYPE::GetGlobalDepth() {
+  table_latch_.RLock();
+  uint32_t global_depth = FetchDirectoryPage()->GetGlobalDepth();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return global_depth;
+}
+
+/*****************************************************************************
+ * VERIFY INTEGRITY
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool EXTENDIBLE_HASH_TABLE_TYPE::VerifyIntegrity() {
+  table_latch_.RLock();
+  HashTableDirectoryPage *directory = FetchDirectoryPage();
+  bool valid = true;
+  std::unordered_map<page_id_t, uint32_t> slot_count;
+  std::unordered_map<page_id_t, uint32_t> local_depth_of;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    page_id_t bucket_page_id = directory->GetBucketPageId(i);
+    uint32_t local_depth = directory->GetLocalDepth(i);
+    valid = valid && local_depth <= directory->GetGlobalDepth();
+    if (slot_count[bucket_page_id]++ == 0) {
+      local_depth_of[bucket_page_id] = local_depth;
+      uint32_t local_mask = (1U << local_depth) - 1;
+      for (const auto &item : ReadBucket(bucket_page_id)) {
+        valid = valid && (Hash(item.first) & local_mask) == (i & local_mask);
+      }
+    }
+    valid = valid && local_depth_of[bucket_page_id] == local_depth;
+  }
+  for (const auto &[bucket_page_id, count] : slot_count) {
+    valid = valid && count == 1U << (directory->GetGlobalDepth() - local_depth_of[bucket_page_id]);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  table_latch_.RUnlock();
+  return valid;
+}
+
+template class ExtendibleHashTable<int, int, IntComparator>;
+
+template class ExtendibleHashTable<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTable<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTable<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTable<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTable<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -22,25 +25,174 @@
 
 namespace bustub {
 
+namespace {
+/**
+ * Walk the slots [begin, end) of a block page 64 at a time, calling visit(slot) for the readable slots of the probe
+ * run until it returns true.
+ * @return the slot visit stopped at, the never occupied slot that ends the run, or end
+ */
+template <typename BlockPage, typename Visit>
+slot_offset_t ProbeBlock(const BlockPage *block, slot_offset_t begin, slot_offset_t end, Visit &&visit) {
+  for (slot_offset_t base = begin / 64 * 64; base < end; base += 64) {
+    uint64_t range = ~uint64_t{0} << (begin > base ? begin - base : 0);
+    if (end - base < 64) {
+      range &= (uint64_t{1} << (end - base)) - 1;
+    }
+    uint64_t empty = ~block->OccupiedWord(base / 64) & range;
+    // the run ends at the lowest empty slot, only the readable slots before it belong to it
+    uint64_t run = empty == 0 ? range : range & ((empty & -empty) - 1);
+    for (uint64_t readable = block->ReadableWord(base / 64) & run; readable != 0; readable &= readable - 1) {
+      slot_offset_t slot = base + __builtin_ctzll(readable);
+      if (visit(slot)) {
+        return slot;
+      }
+    }
+    if (empty != 0) {
+      return base + __builtin_ctzll(empty);
+    }
+  }
+  return end;
+}
+}  // namespace
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 HASH_TABLE_TYPE::LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
                                       const KeyComparator &comparator, size_t num_buckets,
-                                      HashFunction<KeyType> hash_fn)
-    : buffer_pool_manager_(buffer_pool_manager), comparator_(comparator), hash_fn_(std::move(hash_fn)) {}
+                                      HashFunction<KeyType> hash_fn, bool unique_keys)
+    : buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      hash_fn_(std::move(hash_fn)),
+      unique_keys_(unique_keys) {
+  CreateTable(num_buckets);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::CreateTable(size_t num_buckets) {
+  size_t num_blocks = (num_buckets + BLOCK_ARRAY_SIZE - 1) / BLOCK_ARRAY_SIZE;
+  num_blocks = std::min(std::max<size_t>(num_blocks, 1), HashTableHeaderPage::MAX_BLOCK_COUNT);
+  page_id_t header_page_id;
+  Page *header_page = buffer_pool_manager_->NewPage(&header_page_id);
+  if (header_page == nullptr) {
+    throw std::runtime_error("out of memory");
+  }
+  auto header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+  header->SetPageId(header_page_id);
+  header->SetSize(num_blocks * BLOCK_ARRAY_SIZE);
+  for (size_t i = 0; i < num_blocks; i++) {
+    page_id_t block_page_id;
+    if (buffer_pool_manager_->NewPage(&block_page_id) == nullptr) {
+      throw std::runtime_error("out of memory");
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    header->AddBlockPageId(block_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id, true);
+  header_page_id_ = header_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+template <typename Visit, typename AtEnd>
+bool HASH_TABLE_TYPE::Probe(HashTableHeaderPage *header, const KeyType &key, bool exclusive, Visit &&visit,
+                            AtEnd &&at_end) {
+  size_t num_blocks = header->NumBlocks();
+  size_t start = hash_fn_.GetHash(key) % header->GetSize();
+  size_t block_ind = start / BLOCK_ARRAY_SIZE;
+  slot_offset_t begin = start % BLOCK_ARRAY_SIZE;
+  // a run that wraps around the whole table walks the first block twice, the last time up to the start slot
+  for (size_t i = 0; i <= num_blocks; i++) {
+    slot_offset_t end = i == num_blocks ? start % BLOCK_ARRAY_SIZE : BLOCK_ARRAY_SIZE;
+    page_id_t block_page_id = header->GetBlockPageId(block_ind);
+    Page *page = buffer_pool_manager_->FetchPage(block_page_id);
+    if (page == nullptr) {
+      throw std::runtime_error("out of memory");
+    }
+    exclusive ? page->WLatch() : page->RLatch();
+    auto block = reinterpret_cast<BlockPage *>(page->GetData());
+    slot_offset_t slot = ProbeBlock(block, begin, end, [&](slot_offset_t readable) { return visit(block, readable); });
+    bool run_ended = slot < end && !block->IsOccupied(slot);
+    if (run_ended) {
+      at_end(block, slot);
+    }
+    exclusive ? page->WUnlatch() : page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(block_page_id, exclusive && slot < end);
+    if (slot < end) {
+      return !run_ended;
+    }
+    block_ind = (block_ind + 1) % num_blocks;
+    begin = 0;
+  }
+  return false;
+}
 
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) {
-  return false;
+  table_latch_.RLock();
+  bool found = false;
+  auto visit = [&](BlockPage *block, slot_offset_t slot) {
+    if (comparator_(block->KeyAt(slot), key) == 0) {
+      result->push_back(block->ValueAt(slot));
+      found = true;
+    }
+    return false;
+  };
+  // the entries not migrated yet are still in the old table
+  for (page_id_t header_page_id : {header_page_id_, old_header_page_id_}) {
+    if (header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto header = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+    Probe(header, key, false, visit, [](BlockPage *block, slot_offset_t slot) {});
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+  }
+  table_latch_.RUnlock();
+  return found;
 }
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  MigrateStep();
+  bool can_grow = true;
+  auto duplicate = [&](BlockPage *block, slot_offset_t slot) {
+    return comparator_(block->KeyAt(slot), key) == 0 && (unique_keys_ || block->ValueAt(slot) == value);
+  };
+  while (true) {
+    table_latch_.RLock();
+    Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+    auto header = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData());
+    size_t size = header->GetSize();
+    // tombstones lengthen the probe runs too, so they count towards the load factor of 3/4
+    if (can_grow && (occupied_count_ + 1) * 4 > size * 3) {
+      buffer_pool_manager_->UnpinPage(header_page_id_, false);
+      table_latch_.RUnlock();
+      can_grow = Grow(size);
+      continue;
+    }
+    bool inserted = false;
+    bool in_old_table = false;
+    if (old_header_page_id_ != INVALID_PAGE_ID) {
+      // nothing is inserted into the old table any more, so a shared walk is enough
+      auto old_header =
+          reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_)->GetData());
+      in_old_table = Probe(old_header, key, false, duplicate, [](BlockPage *block, slot_offset_t slot) {});
+      buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    }
+    if (!in_old_table) {
+      Probe(header, key, true, duplicate,
+            [&](BlockPage *block, slot_offset_t slot) { inserted = block->Insert(slot, key, value); });
+    }
+    if (inserted) {
+      occupied_count_++;
+      entry_count_++;
+    }
+    buffer_pool_manager_->UnpinPage(header_page_id_, false);
+    table_latch_.RUnlock();
+    return inserted;
+  }
 }
 
 /*****************************************************************************
@@ -48,21 +200,149 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::Remove(Transaction *transaction, const KeyType &key, const ValueType &value) {
-  return false;
+  MigrateStep();
+  table_latch_.RLock();
+  // the slot stays occupied as a tombstone, so that the probe runs through it stay intact
+  auto remove = [&](BlockPage *block, slot_offset_t slot) {
+    if (comparator_(block->KeyAt(slot), key) != 0 || !(block->ValueAt(slot) == value)) {
+      return false;
+    }
+    block->Remove(slot);
+    return true;
+  };
+  bool removed = false;
+  for (page_id_t header_page_id : {header_page_id_, old_header_page_id_}) {
+    if (removed || header_page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto header = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id)->GetData());
+    removed = Probe(header, key, true, remove, [](BlockPage *block, slot_offset_t slot) {});
+    buffer_pool_manager_->UnpinPage(header_page_id, false);
+  }
+  if (removed) {
+    entry_count_--;
+  }
+  table_latch_.RUnlock();
+  return removed;
 }
 
 /*****************************************************************************
  * RESIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
-void HASH_TABLE_TYPE::Resize(size_t initial_size) {}
+void HASH_TABLE_TYPE::Resize(size_t initial_size) {
+  table_latch_.WLock();
+  StartResize(std::max(2 * initial_size, 2 * entry_count_.load()));
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_TYPE::Grow(size_t size) {
+  table_latch_.WLock();
+  Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  size_t current_size = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  size_t max_size = HashTableHeaderPage::MAX_BLOCK_COUNT * BLOCK_ARRAY_SIZE;
+  bool grown = true;
+  // another insert may have grown the table already
+  if (current_size == size && (occupied_count_ + 1) * 4 > size * 3) {
+    if (entry_count_ * 2 <= size) {
+      // mostly tombstones, dropping them makes enough room
+      StartResize(size);
+    } else if (size < max_size) {
+      StartResize(std::min(2 * size, max_size));
+    } else {
+      grown = false;
+    }
+  }
+  table_latch_.WUnlock();
+  return grown;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::StartResize(size_t num_buckets) {
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    // the new table filled up before the last resize was done, finish that one first
+    MigrateBuckets(SIZE_MAX);
+  }
+  old_header_page_id_ = header_page_id_;
+  migrate_cursor_ = 0;
+  CreateTable(num_buckets);
+  occupied_count_ = 0;
+  migrating_ = true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateStep() {
+  if (!migrating_) {
+    return;
+  }
+  table_latch_.WLock();
+  if (old_header_page_id_ != INVALID_PAGE_ID) {
+    MigrateBuckets(MIGRATE_BUCKETS);
+  }
+  table_latch_.WUnlock();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_TYPE::MigrateBuckets(size_t count) {
+  auto old_header =
+      reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(old_header_page_id_)->GetData());
+  auto header = reinterpret_cast<HashTableHeaderPage *>(buffer_pool_manager_->FetchPage(header_page_id_)->GetData());
+  size_t old_size = old_header->GetSize();
+  size_t end = old_size - migrate_cursor_ > count ? migrate_cursor_ + count : old_size;
+  while (migrate_cursor_ < end) {
+    size_t block_ind = migrate_cursor_ / BLOCK_ARRAY_SIZE;
+    slot_offset_t begin = migrate_cursor_ % BLOCK_ARRAY_SIZE;
+    slot_offset_t block_end = std::min<size_t>(BLOCK_ARRAY_SIZE, end - block_ind * BLOCK_ARRAY_SIZE);
+    page_id_t block_page_id = old_header->GetBlockPageId(block_ind);
+    auto block = reinterpret_cast<BlockPage *>(buffer_pool_manager_->FetchPage(block_page_id)->GetData());
+    for (slot_offset_t base = begin / 64 * 64; base < block_end; base += 64) {
+      uint64_t range = ~uint64_t{0} << (begin > base ? begin - base : 0);
+      if (block_end - base < 64) {
+        range &= (uint64_t{1} << (block_end - base)) - 1;
+      }
+      for (uint64_t readable = block->ReadableWord(base / 64) & range; readable != 0; readable &= readable - 1) {
+        slot_offset_t slot = base + __builtin_ctzll(readable);
+        KeyType key = block->KeyAt(slot);
+        ValueType value = block->ValueAt(slot);
+        // the entry is unique across both tables already, and leaves a tombstone so the old runs stay intact
+        Probe(
+            header, key, true, [](BlockPage *new_block, slot_offset_t new_slot) { return false; },
+            [&](BlockPage *new_block, slot_offset_t new_slot) { new_block->Insert(new_slot, key, value); });
+        block->Remove(slot);
+        occupied_count_++;
+      }
+    }
+    buffer_pool_manager_->UnpinPage(block_page_id, true);
+    migrate_cursor_ = block_ind * BLOCK_ARRAY_SIZE + block_end;
+  }
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+
+  if (migrate_cursor_ == old_size) {
+    for (size_t i = 0; i < old_header->NumBlocks(); i++) {
+      buffer_pool_manager_->DeletePage(old_header->GetBlockPageId(i));
+    }
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+    buffer_pool_manager_->DeletePage(old_header_page_id_);
+    old_header_page_id_ = INVALID_PAGE_ID;
+    migrating_ = false;
+  } else {
+    buffer_pool_manager_->UnpinPage(old_header_page_id_, false);
+  }
+}
 
 /*****************************************************************************
  * GETSIZE
  *****************************************************************************/
 template <typename KeyType, typename ValueType, typename KeyComparator>
 size_t HASH_TABLE_TYPE::GetSize() {
-  return 0;
+  table_latch_.RLock();
+  Page *header_page = buffer_pool_manager_->FetchPage(header_page_id_);
+  size_t size = reinterpret_cast<HashTableHeaderPage *>(header_page->GetData())->GetSize();
+  buffer_pool_manager_->UnpinPage(header_page_id_, false);
+  table_latch_.RUnlock();
+  return size;
 }
 
 template class LinearProbeHashTable<int, int, IntComparator>;
@@ -9,34 +9,302 @@
 // Copyright (c) 2015-19, Carnegie Mellon University Database Group
 //
 //===----------------------------------------------------------------------===//
+#include <atomic>
+#include <future>  // NOLINT
 #include <memory>
 #include <vector>
 
+#include "common/exception.h"
+#include "execution/executor_factory.h"
 #include "execution/executors/aggregation_executor.h"
+#include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
 
 AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                                          std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)), aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
-    aht_iterator_(aht_.Begin()){}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_(std::move(child)),
+    aht_iterator_(std::unordered_map<AggregateKey, AggregateValue>::const_iterator()){
+    std::vector<Column> columns;
+    for(auto expr : plan_->GetGroupBys()){
+        TypeId type = expr->GetReturnType();
+        columns.push_back(type == TypeId::VARCHAR ? Column("", type, PAGE_SIZE) : Column("", type));
+    }
+    for(size_t i = 0; i < plan_->GetAggregates().size(); i++){
+        // partial results are at least integers, the type the aggregates start at
+        TypeId type = plan_->GetAggregateTypes()[i] == AggregationType::CountAggregate ? TypeId::INTEGER
+                                                                                       : plan_->GetAggregateAt(i)->GetReturnType();
+        if(type == TypeId::TINYINT || type == TypeId::SMALLINT){
+            type = TypeId::INTEGER;
+        }
+        columns.emplace_back("", type);
+    }
+    partial_schema_ = std::make_unique<Schema>(columns);
+    partitions_.reserve(PARTITION_COUNT);
+    for(uint32_t i = 0; i < PARTITION_COUNT; i++){
+        partitions_.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+    }
+}
+
+AggregationExecutor::~AggregationExecutor() { DropSpilledPages(); }
 
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
 
+size_t AggregationExecutor::GetSpilledPartitionCount() const {
+    size_t count = 0;
+    for(bool spilled : spilled_){
+        count += spilled ? 1 : 0;
+    }
+    return count;
+}
+
 void AggregationExecutor::Init() {
-    child_->Init();
-    Tuple tuple;
-    RID rid;
-    while(child_->Next(&tuple, &rid)){
-        AggregateKey key = MakeKey(&tuple);
-        AggregateValue value = MakeVal(&tuple);
-        aht_.InsertCombine(key, value);
+    DropSpilledPages();
+    for(auto &partition : partitions_){
+        partition.Clear();
+    }
+    uint32_t workers = plan_->GetParallelism();
+    size_t budget = plan_->GetMemoryBudget() / workers;
+    locals_.clear();
+    locals_.resize(workers);
+    for(auto &local : locals_){
+        local.partitions_.reserve(PARTITION_COUNT);
+        for(uint32_t i = 0; i < PARTITION_COUNT; i++){
+            local.partitions_.emplace_back(plan_->GetAggregates(), plan_->GetAggregateTypes());
+        }
+        local.spilled_pages_.resize(PARTITION_COUNT);
+    }
+
+    if(workers == 1){
+        child_->Init();
+        Aggregate(child_.get(), &locals_[0], budget);
+    } else {
+        // every thread aggregates its own copy of the child, whose scans read a part of each table
+        BUSTUB_ASSERT(WorkerGroup::CanSplit(plan_->GetChildPlan()),
+                      "The child of a parallel aggregation must be a subtree whose copies split its rows.");
+        auto worker_group = std::make_shared<WorkerGroup>(workers);
+        RunWorkers(workers, [&](uint32_t worker) {
+            ExecutorContext worker_ctx(exec_ctx_->GetTransaction(), exec_ctx_->GetCatalog(),
+                                       exec_ctx_->GetBufferPoolManager(), exec_ctx_->GetTransactionManager(),
+                                       exec_ctx_->GetLockManager());
+            worker_ctx.SetWorkerPool(exec_ctx_->GetWorkerPool());
+            worker_ctx.SetWorkerGroup(worker_group, worker);
+            auto child = ExecutorFactory::CreateExecutor(&worker_ctx, plan_->GetChildPlan());
+            child->Init();
+            Aggregate(child.get(), &locals_[worker], budget);
+        });
+    }
+
+    // the partitions that stayed in memory are merged in parallel, the spilled ones when they are output
+    spilled_.assign(PARTITION_COUNT, false);
+    for(const auto &local : locals_){
+        for(uint32_t i = 0; i < PARTITION_COUNT; i++){
+            if(!local.spilled_pages_[i].empty()){
+                spilled_[i] = true;
+            }
+        }
+    }
+    std::atomic<uint32_t> next_partition{0};
+    RunWorkers(workers, [&](uint32_t /* worker */) {
+        for(uint32_t i = next_partition++; i < PARTITION_COUNT; i = next_partition++){
+            if(!spilled_[i]){
+                MergePartition(i);
+            }
+        }
+    });
+    partition_cursor_ = 0;
+    if(spilled_[0]){
+        MergePartition(0);
+    }
+    aht_iterator_ = partitions_[0].Begin();
+}
+
+void AggregationExecutor::RunWorkers(uint32_t workers, const std::function<void(uint32_t)> &work) {
+    auto pool = exec_ctx_->GetWorkerPool();
+    std::vector<std::future<void>> done;
+    for(uint32_t worker = 1; worker < workers; worker++){
+        auto promise = std::make_shared<std::promise<void>>();
+        done.push_back(promise->get_future());
+        auto task = [&work, worker, promise] {
+            try {
+                work(worker);
+                promise->set_value();
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        };
+        // without a pool the workers take turns on this thread
+        if(pool == nullptr){
+            task();
+        } else {
+            pool->Submit(task);
+        }
+    }
+    std::exception_ptr error;
+    try {
+        work(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    // the workers use the state of this executor, so all of them finish before an error is thrown
+    for(auto &worker_done : done){
+        try {
+            worker_done.get();
+        } catch (...) {
+            if(error == nullptr){
+                error = std::current_exception();
+            }
+        }
+    }
+    if(error != nullptr){
+        std::rethrow_exception(error);
+    }
+}
+
+void AggregationExecutor::Aggregate(AbstractExecutor *child, LocalAggregation *local, size_t budget) {
+    const Schema *child_schema = child->GetOutputSchema();
+    const auto &group_by_exprs = plan_->GetGroupBys();
+    const auto &aggregate_exprs = plan_->GetAggregates();
+    std::vector<std::vector<Value>> group_bys(group_by_exprs.size());
+    std::vector<std::vector<Value>> aggregates(aggregate_exprs.size());
+    TupleBatch batch;
+    // the expressions are evaluated a batch at a time, only the hash table is updated per tuple
+    while(child->NextBatch(&batch)){
+        for(size_t i = 0; i < group_by_exprs.size(); i++){
+            group_by_exprs[i]->EvaluateBatch(batch, child_schema, &group_bys[i]);
+        }
+        for(size_t i = 0; i < aggregate_exprs.size(); i++){
+            aggregate_exprs[i]->EvaluateBatch(batch, child_schema, &aggregates[i]);
+        }
+        for(uint32_t row = 0; row < batch.Size(); row++){
+            AggregateKey key;
+            key.group_bys_.reserve(group_bys.size());
+            for(const auto &column : group_bys){
+                key.group_bys_.push_back(column[row]);
+            }
+            AggregateValue value;
+            value.aggregates_.reserve(aggregates.size());
+            for(const auto &column : aggregates){
+                value.aggregates_.push_back(column[row]);
+            }
+            auto &table = local->partitions_[std::hash<AggregateKey>()(key) % PARTITION_COUNT];
+            size_t groups = table.Size();
+            table.InsertCombine(key, value);
+            if(table.Size() == groups){
+                continue;
+            }
+            local->bytes_ += GroupBytes();
+            if(local->bytes_ > budget){
+                uint32_t largest = 0;
+                for(uint32_t i = 1; i < PARTITION_COUNT; i++){
+                    if(local->partitions_[i].Size() > local->partitions_[largest].Size()){
+                        largest = i;
+                    }
+                }
+                SpillPartition(local, largest);
+            }
+        }
+    }
+}
+
+void AggregationExecutor::SpillPartition(LocalAggregation *local, uint32_t partition) {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    auto &table = local->partitions_[partition];
+    auto &pages = local->spilled_pages_[partition];
+    TmpTuplePage *page = nullptr;
+    std::vector<Value> values;
+    for(auto iter = table.Begin(); iter != table.End(); ++iter){
+        values.clear();
+        for(uint32_t i = 0; i < partial_schema_->GetColumnCount(); i++){
+            size_t key_count = iter.Key().group_bys_.size();
+            const Value &value = i < key_count ? iter.Key().group_bys_[i] : iter.Val().aggregates_[i - key_count];
+            values.push_back(value.CastAs(partial_schema_->GetColumn(i).GetType()));
+        }
+        Tuple tuple(values, partial_schema_.get());
+        TmpTuple location(INVALID_PAGE_ID, 0);
+        if(page == nullptr || !page->Insert(tuple, &location)){
+            if(page != nullptr){
+                bpm->UnpinPage(page->GetTablePageId(), true);
+            }
+            page_id_t page_id;
+            page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+            if(page == nullptr){
+                throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a page to spill the aggregation");
+            }
+            page->Init(page_id, PAGE_SIZE);
+            pages.push_back(page_id);
+            bool inserted = page->Insert(tuple, &location);
+            BUSTUB_ASSERT(inserted, "A group must fit an empty page.");
+        }
     }
-    aht_iterator_ = aht_.Begin();
+    if(page != nullptr){
+        bpm->UnpinPage(page->GetTablePageId(), true);
+    }
+    local->bytes_ -= table.Size() * GroupBytes();
+    table.Clear();
+}
+
+void AggregationExecutor::MergePartition(uint32_t partition) {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    auto &table = partitions_[partition];
+    size_t key_count = plan_->GetGroupBys().size();
+    for(auto &local : locals_){
+        table.Merge(&local.partitions_[partition]);
+        for(auto page_id : local.spilled_pages_[partition]){
+            auto page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+            if(page == nullptr){
+                throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a spilled page of the aggregation");
+            }
+            uint32_t offset = page->GetFreeSpacePointer();
+            while(offset < PAGE_SIZE){
+                Tuple tuple;
+                offset = page->Get(offset, &tuple);
+                AggregateKey key;
+                AggregateValue partial;
+                for(uint32_t i = 0; i < partial_schema_->GetColumnCount(); i++){
+                    auto &values = i < key_count ? key.group_bys_ : partial.aggregates_;
+                    values.push_back(tuple.GetValue(partial_schema_.get(), i));
+                }
+                table.InsertMerge(key, partial);
+            }
+            bpm->UnpinPage(page_id, false);
+            bpm->DeletePage(page_id);
+        }
+        local.spilled_pages_[partition].clear();
+    }
+}
+
+void AggregationExecutor::DropSpilledPages() {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    for(auto &local : locals_){
+        for(auto &pages : local.spilled_pages_){
+            for(auto page_id : pages){
+                bpm->DeletePage(page_id);
+            }
+            pages.clear();
+        }
+    }
+}
+
+bool AggregationExecutor::SeekGroup() {
+    while(partition_cursor_ < PARTITION_COUNT && aht_iterator_ == partitions_[partition_cursor_].End()){
+        if(spilled_[partition_cursor_]){
+            // only one spilled partition is held in memory at a time
+            partitions_[partition_cursor_].Clear();
+        }
+        if(++partition_cursor_ == PARTITION_COUNT){
+            return false;
+        }
+        if(spilled_[partition_cursor_]){
+            MergePartition(partition_cursor_);
+        }
+        aht_iterator_ = partitions_[partition_cursor_].Begin();
+    }
+    return partition_cursor_ < PARTITION_COUNT;
 }
 
 bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
-    while(aht_iterator_ != aht_.End()){
+    while(SeekGroup()){
         if(plan_->GetHaving() == nullptr || 
         plan_->GetHaving()->EvaluateAggregate(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_).GetAs<bool>()){
             std::vector<Value> values;
@@ -53,4 +321,21 @@ bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
     return false;
 }
 
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+    const Schema *output_schema = GetOutputSchema();
+    batch->Reset(output_schema->GetColumnCount());
+    for(; !batch->IsFull() && SeekGroup(); ++aht_iterator_){
+        const auto &group_bys = aht_iterator_.Key().group_bys_;
+        const auto &aggregates = aht_iterator_.Val().aggregates_;
+        if(plan_->GetHaving() != nullptr && !plan_->GetHaving()->EvaluateAggregate(group_bys, aggregates).GetAs<bool>()){
+            continue;
+        }
+        for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+            batch->GetColumn(i).push_back(output_schema->GetColumn(i).GetExpr()->EvaluateAggregate(group_bys, aggregates));
+        }
+        batch->AppendRow(RID());
+    }
+    return !batch->IsEmpty();
+}
+
 }  // namespace bustub
@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_queue.cpp
+//
+// Identification: src/execution/batch_queue.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/batch_queue.h"
+
+#include <utility>
+
+namespace bustub {
+
+BatchQueue::BatchQueue(size_t capacity) {
+    size_t size = 1;
+    while(size < capacity){
+        size <<= 1;
+    }
+    slots_ = std::make_unique<Slot[]>(size);
+    mask_ = size - 1;
+    // slot i is free for the push at position i
+    for(size_t i = 0; i < size; i++){
+        slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool BatchQueue::TryPush(TupleBatch *batch) {
+    size_t pos = push_pos_.load(std::memory_order_relaxed);
+    while(true){
+        Slot &slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence_.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if(diff == 0){
+            if(push_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                std::swap(slot.batch_, *batch);
+                // the slot now holds the batch of position pos
+                slot.sequence_.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if(diff < 0){
+            // the slot still holds the batch of the previous turn
+            return false;
+        } else {
+            pos = push_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool BatchQueue::TryPop(TupleBatch *batch) {
+    size_t pos = pop_pos_.load(std::memory_order_relaxed);
+    while(true){
+        Slot &slot = slots_[pos & mask_];
+        size_t sequence = slot.sequence_.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+        if(diff == 0){
+            if(pop_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                std::swap(slot.batch_, *batch);
+                // the slot is free for the push of the next turn
+                slot.sequence_.store(pos + mask_ + 1, std::memory_order_release);
+                return true;
+            }
+        } else if(diff < 0){
+            // nothing was pushed at pos yet
+            return false;
+        } else {
+            pos = pop_pos_.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace bustub
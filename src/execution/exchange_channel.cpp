@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_channel.cpp
+//
+// Identification: src/execution/exchange_channel.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/exchange_channel.h"
+
+#include <thread>  // NOLINT
+
+namespace bustub {
+
+ExchangeChannel::ExchangeChannel(uint32_t queue_count, uint32_t producer_count)
+    : closed_(std::make_unique<std::atomic<bool>[]>(queue_count)), open_queues_(queue_count),
+      running_producers_(producer_count) {
+    for(uint32_t i = 0; i < queue_count; i++){
+        queues_.push_back(std::make_unique<BatchQueue>(QUEUE_CAPACITY));
+        closed_[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+bool ExchangeChannel::Push(uint32_t queue, TupleBatch *batch) {
+    for(uint32_t attempt = 0;; attempt++){
+        // read before the checks, so that a change after them ends the wait
+        uint64_t seen = changes_.load();
+        if(IsCancelled()){
+            return false;
+        }
+        if(closed_[queue].load(std::memory_order_acquire)){
+            return true;
+        }
+        if(queues_[queue]->TryPush(batch)){
+            Signal();
+            return true;
+        }
+        Wait(seen, attempt);
+    }
+}
+
+bool ExchangeChannel::Pop(uint32_t queue, TupleBatch *batch) {
+    for(uint32_t attempt = 0;; attempt++){
+        uint64_t seen = changes_.load();
+        if(queues_[queue]->TryPop(batch)){
+            Signal();
+            return true;
+        }
+        if(running_producers_.load(std::memory_order_acquire) == 0){
+            // every push happened before the producers finished, so the queue is known to be drained
+            if(queues_[queue]->TryPop(batch)){
+                return true;
+            }
+            std::scoped_lock lock{latch_};
+            if(error_ != nullptr){
+                std::rethrow_exception(error_);
+            }
+            return false;
+        }
+        Wait(seen, attempt);
+    }
+}
+
+void ExchangeChannel::Signal() {
+    // pairs with the increment of parked_ in Wait(), one of the two sees the other
+    changes_.fetch_add(1);
+    if(parked_.load() > 0){
+        std::scoped_lock lock{latch_};
+        changed_.notify_all();
+    }
+}
+
+void ExchangeChannel::Wait(uint64_t seen, uint32_t attempt) {
+    if(attempt < SPIN_COUNT){
+        std::this_thread::yield();
+        return;
+    }
+    std::unique_lock lock{latch_};
+    parked_.fetch_add(1);
+    changed_.wait(lock, [&] { return changes_.load() != seen; });
+    parked_.fetch_sub(1);
+}
+
+void ExchangeChannel::FinishProducer(std::exception_ptr error) {
+    std::scoped_lock lock{latch_};
+    if(error != nullptr){
+        if(error_ == nullptr){
+            error_ = error;
+        }
+        cancelled_.store(true, std::memory_order_release);
+    }
+    running_producers_.fetch_sub(1, std::memory_order_acq_rel);
+    changes_.fetch_add(1);
+    producers_done_.notify_all();
+    changed_.notify_all();
+}
+
+void ExchangeChannel::Close(uint32_t queue) {
+    if(!closed_[queue].exchange(true, std::memory_order_acq_rel)){
+        open_queues_.fetch_sub(1, std::memory_order_acq_rel);
+        Signal();
+    }
+}
+
+void ExchangeChannel::Cancel() {
+    cancelled_.store(true, std::memory_order_release);
+    Signal();
+    std::unique_lock lock{latch_};
+    if(MarkStarted()){
+        // the producers were never started and no one can start them anymore
+        running_producers_.store(0, std::memory_order_release);
+        changes_.fetch_add(1);
+        changed_.notify_all();
+        return;
+    }
+    producers_done_.wait(lock, [&] { return running_producers_.load(std::memory_order_acquire) == 0; });
+}
+
+}  // namespace bustub
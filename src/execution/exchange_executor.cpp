@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.cpp
+//
+// Identification: src/execution/exchange_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/exchange_executor.h"
+
+#include <utility>
+
+#include "common/util/hash_util.h"
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+ExchangeExecutor::ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan) {}
+
+void ExchangeExecutor::Init() {
+    Stop();
+    auto pool = exec_ctx_->GetWorkerPool();
+    BUSTUB_ASSERT(pool != nullptr, "An exchange needs a worker pool to run its producers.");
+    auto worker_group = exec_ctx_->GetWorkerGroup();
+    uint32_t parallelism = plan_->GetParallelism();
+    BUSTUB_ASSERT(parallelism == 1 || WorkerGroup::CanSplit(plan_->GetChildPlan()),
+                  "The child of a parallel exchange must be a subtree whose copies split its rows.");
+    owns_channel_ = worker_group == nullptr;
+    if(owns_channel_){
+        channel_ = std::make_shared<ExchangeChannel>(1, parallelism);
+        queue_ = 0;
+    } else if(plan_->GetExchangeType() == ExchangeType::GATHER){
+        // the copies take turns popping from one queue
+        channel_ = worker_group->GetChannel(plan_, 1, parallelism);
+        queue_ = 0;
+    } else {
+        channel_ = worker_group->GetChannel(plan_, worker_group->GetWorkerCount(), parallelism);
+        queue_ = exec_ctx_->GetWorkerIndex();
+    }
+    row_batch_.Reset(0);
+    row_cursor_ = 0;
+    if(!channel_->MarkStarted()){
+        return;
+    }
+
+    // the producers may outlive this executor, so they only keep what outlives the query
+    auto producers = std::make_shared<WorkerGroup>(parallelism);
+    auto plan = plan_;
+    auto channel = channel_;
+    // the producers share the transaction, which latches its lock sets for them
+    auto txn = exec_ctx_->GetTransaction();
+    auto catalog = exec_ctx_->GetCatalog();
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    auto txn_mgr = exec_ctx_->GetTransactionManager();
+    auto lock_mgr = exec_ctx_->GetLockManager();
+    for(uint32_t i = 0; i < parallelism; i++){
+        pool->Submit([=]() mutable {
+            std::exception_ptr error;
+            try {
+                ExecutorContext producer_ctx(txn, catalog, bpm, txn_mgr, lock_mgr);
+                producer_ctx.SetWorkerPool(pool);
+                producer_ctx.SetWorkerGroup(std::move(producers), i);
+                auto child = ExecutorFactory::CreateExecutor(&producer_ctx, plan->GetChildPlan());
+                child->Init();
+                Produce(plan, child.get(), channel.get());
+            } catch (...) {
+                error = std::current_exception();
+            }
+            // the copy of the child and the exchanges below it are gone by now
+            channel->FinishProducer(error);
+            channel.reset();
+        });
+    }
+}
+
+void ExchangeExecutor::Produce(const ExchangePlanNode *plan, AbstractExecutor *child, ExchangeChannel *channel) {
+    const Schema *schema = child->GetOutputSchema();
+    uint32_t column_count = schema->GetColumnCount();
+    uint32_t queue_count = channel->GetQueueCount();
+    const auto &partition_keys = plan->GetPartitionKeys();
+    std::vector<TupleBatch> partitions(queue_count);
+    for(auto &partition : partitions){
+        partition.Reset(column_count);
+    }
+    std::vector<std::vector<Value>> keys(partition_keys.size());
+    TupleBatch batch;
+    while(!channel->IsCancelled() && child->NextBatch(&batch)){
+        switch(plan->GetExchangeType()){
+            case ExchangeType::GATHER: {
+                if(!channel->Push(0, &batch)){
+                    return;
+                }
+                break;
+            }
+            case ExchangeType::BROADCAST: {
+                for(uint32_t queue = 0; queue + 1 < queue_count; queue++){
+                    TupleBatch copy = batch;
+                    if(!channel->Push(queue, &copy)){
+                        return;
+                    }
+                }
+                if(!channel->Push(queue_count - 1, &batch)){
+                    return;
+                }
+                break;
+            }
+            case ExchangeType::REPARTITION: {
+                for(size_t k = 0; k < partition_keys.size(); k++){
+                    partition_keys[k]->EvaluateBatch(batch, schema, &keys[k]);
+                }
+                for(uint32_t i = 0; i < batch.Size(); i++){
+                    size_t hash = 0;
+                    for(const auto &key : keys){
+                        // NULL keys are left out, the way aggregation hashes its group by keys
+                        if(!key[i].IsNull()){
+                            hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&key[i]));
+                        }
+                    }
+                    auto &partition = partitions[hash % queue_count];
+                    uint32_t row = batch.SelectedRow(i);
+                    for(uint32_t c = 0; c < column_count; c++){
+                        partition.GetColumn(c).push_back(batch.GetValue(c, row));
+                    }
+                    partition.AppendRow(batch.GetRid(row));
+                    if(partition.IsFull()){
+                        if(!channel->Push(hash % queue_count, &partition)){
+                            return;
+                        }
+                        partition.Reset(column_count);
+                    }
+                }
+                break;
+            }
+        }
+    }
+    for(uint32_t queue = 0; queue < queue_count; queue++){
+        if(!partitions[queue].IsEmpty() && !channel->Push(queue, &partitions[queue])){
+            return;
+        }
+    }
+}
+
+void ExchangeExecutor::Stop() {
+    if(channel_ == nullptr){
+        return;
+    }
+    if(owns_channel_){
+        channel_->Cancel();
+    } else if(plan_->GetExchangeType() != ExchangeType::GATHER){
+        channel_->Close(queue_);
+    }
+    channel_.reset();
+}
+
+bool ExchangeExecutor::NextBatch(TupleBatch *batch) {
+    if(channel_->Pop(queue_, batch)){
+        return true;
+    }
+    batch->Reset(plan_->OutputSchema()->GetColumnCount());
+    return false;
+}
+
+bool ExchangeExecutor::Next(Tuple *tuple, RID *rid) {
+    if(row_cursor_ == row_batch_.Size()){
+        if(!NextBatch(&row_batch_)){
+            return false;
+        }
+        row_cursor_ = 0;
+    }
+    uint32_t row = row_batch_.SelectedRow(row_cursor_++);
+    *tuple = row_batch_.GetTuple(row, plan_->OutputSchema());
+    *rid = row_batch_.GetRid(row);
+    return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,341 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.cpp
+//
+// Identification: src/execution/hash_join_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/hash_join_executor.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                                   std::unique_ptr<AbstractExecutor> &&right_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), left_executor_(std::move(left_executor)),
+    right_executor_(std::move(right_executor)){}
+
+HashJoinExecutor::~HashJoinExecutor() { DropPartitions(); }
+
+bool HashJoinExecutor::ReadBatch(AbstractExecutor *executor, const std::vector<const AbstractExpression *> &key_exprs,
+                                 std::vector<Tuple> *tuples, std::vector<HashJoinKey> *keys) {
+    TupleBatch batch;
+    if(!executor->NextBatch(&batch)){
+        return false;
+    }
+    auto schema = executor->GetOutputSchema();
+    size_t first = keys->size();
+    keys->resize(first + batch.Size());
+    std::vector<Value> values;
+    for(auto key_expr : key_exprs){
+        key_expr->EvaluateBatch(batch, schema, &values);
+        for(uint32_t i = 0; i < batch.Size(); i++){
+            (*keys)[first + i].keys_.push_back(std::move(values[i]));
+        }
+    }
+    for(uint32_t i = 0; i < batch.Size(); i++){
+        tuples->push_back(batch.GetTuple(batch.SelectedRow(i), schema));
+    }
+    return true;
+}
+
+void HashJoinExecutor::Build(std::vector<Tuple> *tuples, std::vector<HashJoinKey> *keys) {
+    for(size_t i = 0; i < tuples->size(); i++){
+        // a NULL key never equals anything
+        if(!(*keys)[i].HasNull()){
+            hash_table_[std::move((*keys)[i])].push_back(std::move((*tuples)[i]));
+        }
+    }
+}
+
+void HashJoinExecutor::Init() {
+    left_executor_->Init();
+    right_executor_->Init();
+    hash_table_.clear();
+    DropPartitions();
+    spilled_ = false;
+    partition_count_ = 0;
+    probe_cursor_ = 0;
+    matches_ = nullptr;
+    match_cursor_ = 0;
+    // read the children in turns, the one that is exhausted first is the smaller and the table is built on it
+    std::vector<Tuple> tuples[2];
+    std::vector<HashJoinKey> keys[2];
+    size_t bytes = 0;
+    while(true){
+        size_t left_read = tuples[0].size();
+        size_t right_read = tuples[1].size();
+        if(!ReadBatch(left_executor_.get(), plan_->GetLeftKeys(), &tuples[0], &keys[0])){
+            build_left_ = true;
+            break;
+        }
+        if(!ReadBatch(right_executor_.get(), plan_->GetRightKeys(), &tuples[1], &keys[1])){
+            build_left_ = false;
+            break;
+        }
+        for(size_t i = left_read; i < tuples[0].size(); i++){
+            bytes += TupleBytes(tuples[0][i]);
+        }
+        for(size_t i = right_read; i < tuples[1].size(); i++){
+            bytes += TupleBytes(tuples[1][i]);
+        }
+        if(bytes > plan_->GetMemoryBudget()){
+            // neither child fits, join the pairs of partitions one at a time instead
+            SpillInputs(tuples, keys);
+            probe_tuples_.clear();
+            probe_keys_.clear();
+            return;
+        }
+    }
+    Build(build_left_ ? &tuples[0] : &tuples[1], build_left_ ? &keys[0] : &keys[1]);
+    probe_tuples_ = std::move(build_left_ ? tuples[1] : tuples[0]);
+    probe_keys_ = std::move(build_left_ ? keys[1] : keys[0]);
+}
+
+void HashJoinExecutor::SpillInputs(std::vector<Tuple> tuples[2], std::vector<HashJoinKey> keys[2]) {
+    spilled_ = true;
+    std::vector<Partition> partitions(PARTITION_FANOUT);
+    std::vector<TmpTuplePage *> pages(2 * PARTITION_FANOUT, nullptr);
+    AbstractExecutor *executors[2] = {left_executor_.get(), right_executor_.get()};
+    const std::vector<const AbstractExpression *> *key_exprs[2] = {&plan_->GetLeftKeys(), &plan_->GetRightKeys()};
+    for(uint32_t side = 0; side < 2; side++){
+        bool more = true;
+        while(more){
+            for(size_t i = 0; i < tuples[side].size(); i++){
+                SpillTuple(&partitions, &pages, side, tuples[side][i], keys[side][i]);
+            }
+            tuples[side].clear();
+            keys[side].clear();
+            more = ReadBatch(executors[side], *key_exprs[side], &tuples[side], &keys[side]);
+        }
+    }
+    FinishPass(&partitions, &pages);
+}
+
+void HashJoinExecutor::SpillTuple(std::vector<Partition> *partitions, std::vector<TmpTuplePage *> *pages,
+                                  uint32_t side, const Tuple &tuple, const HashJoinKey &key) {
+    if(key.HasNull()){
+        return;
+    }
+    // every pass hashes with its own seed, so that a partition that is partitioned again spreads out
+    uint32_t level = partitions->front().level_;
+    uint32_t index = HashUtil::CombineHashes(level, std::hash<HashJoinKey>()(key)) % PARTITION_FANOUT;
+    Partition &partition = (*partitions)[index];
+    TmpTuplePage *&page = (*pages)[side * PARTITION_FANOUT + index];
+    TmpTuple location(INVALID_PAGE_ID, 0);
+    if(page == nullptr || !page->Insert(tuple, &location)){
+        auto bpm = exec_ctx_->GetBufferPoolManager();
+        if(page != nullptr){
+            bpm->UnpinPage(page->GetTablePageId(), true);
+        }
+        page_id_t page_id;
+        page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+        if(page == nullptr){
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a page to spill the hash join");
+        }
+        page->Init(page_id, PAGE_SIZE);
+        partition.pages_[side].push_back(page_id);
+        bool inserted = page->Insert(tuple, &location);
+        BUSTUB_ASSERT(inserted, "A tuple must fit an empty page.");
+    }
+    partition.bytes_[side] += TupleBytes(tuple);
+}
+
+void HashJoinExecutor::FinishPass(std::vector<Partition> *partitions, std::vector<TmpTuplePage *> *pages) {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    for(auto page : *pages){
+        if(page != nullptr){
+            bpm->UnpinPage(page->GetTablePageId(), true);
+        }
+    }
+    for(auto &partition : *partitions){
+        if(!partition.pages_[0].empty() || !partition.pages_[1].empty()){
+            partitions_.push_back(std::move(partition));
+        }
+    }
+}
+
+void HashJoinExecutor::ReadPage(page_id_t page_id, uint32_t side, std::vector<Tuple> *tuples,
+                                std::vector<HashJoinKey> *keys) {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    auto page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+    if(page == nullptr){
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a spilled page of the hash join");
+    }
+    auto schema = side == 0 ? left_executor_->GetOutputSchema() : right_executor_->GetOutputSchema();
+    const auto &key_exprs = side == 0 ? plan_->GetLeftKeys() : plan_->GetRightKeys();
+    uint32_t offset = page->GetFreeSpacePointer();
+    while(offset < PAGE_SIZE){
+        Tuple tuple;
+        offset = page->Get(offset, &tuple);
+        HashJoinKey key;
+        for(auto key_expr : key_exprs){
+            key.keys_.push_back(key_expr->Evaluate(&tuple, schema));
+        }
+        tuples->push_back(std::move(tuple));
+        keys->push_back(std::move(key));
+    }
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+}
+
+bool HashJoinExecutor::NextPartition() {
+    while(!partitions_.empty()){
+        Partition partition = std::move(partitions_.back());
+        partitions_.pop_back();
+        if(partition.pages_[0].empty() || partition.pages_[1].empty()){
+            // nothing joins with a side that is empty
+            DeletePages(partition.pages_[0]);
+            DeletePages(partition.pages_[1]);
+            continue;
+        }
+        std::vector<Tuple> tuples;
+        std::vector<HashJoinKey> keys;
+        if(std::min(partition.bytes_[0], partition.bytes_[1]) > plan_->GetMemoryBudget() &&
+           partition.level_ < MAX_PARTITION_LEVEL){
+            std::vector<Partition> partitions(PARTITION_FANOUT);
+            for(auto &sub_partition : partitions){
+                sub_partition.level_ = partition.level_ + 1;
+            }
+            std::vector<TmpTuplePage *> pages(2 * PARTITION_FANOUT, nullptr);
+            for(uint32_t side = 0; side < 2; side++){
+                for(auto page_id : partition.pages_[side]){
+                    ReadPage(page_id, side, &tuples, &keys);
+                    for(size_t i = 0; i < tuples.size(); i++){
+                        SpillTuple(&partitions, &pages, side, tuples[i], keys[i]);
+                    }
+                    tuples.clear();
+                    keys.clear();
+                }
+            }
+            FinishPass(&partitions, &pages);
+            continue;
+        }
+        partition_count_++;
+        build_left_ = partition.bytes_[0] <= partition.bytes_[1];
+        uint32_t build_side = build_left_ ? 0 : 1;
+        for(auto page_id : partition.pages_[build_side]){
+            ReadPage(page_id, build_side, &tuples, &keys);
+        }
+        hash_table_.clear();
+        Build(&tuples, &keys);
+        probe_pages_ = std::move(partition.pages_[1 - build_side]);
+        return true;
+    }
+    return false;
+}
+
+void HashJoinExecutor::DeletePages(const std::vector<page_id_t> &page_ids) {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    for(auto page_id : page_ids){
+        bpm->DeletePage(page_id);
+    }
+}
+
+void HashJoinExecutor::DropPartitions() {
+    for(const auto &partition : partitions_){
+        DeletePages(partition.pages_[0]);
+        DeletePages(partition.pages_[1]);
+    }
+    partitions_.clear();
+    DeletePages(probe_pages_);
+    probe_pages_.clear();
+}
+
+bool HashJoinExecutor::ReadProbe() {
+    if(!spilled_){
+        if(hash_table_.empty()){
+            return false;
+        }
+        auto probe_executor = build_left_ ? right_executor_.get() : left_executor_.get();
+        auto &probe_key_exprs = build_left_ ? plan_->GetRightKeys() : plan_->GetLeftKeys();
+        return ReadBatch(probe_executor, probe_key_exprs, &probe_tuples_, &probe_keys_);
+    }
+    if(probe_pages_.empty() && !NextPartition()){
+        return false;
+    }
+    page_id_t page_id = probe_pages_.back();
+    probe_pages_.pop_back();
+    ReadPage(page_id, build_left_ ? 1 : 0, &probe_tuples_, &probe_keys_);
+    return true;
+}
+
+bool HashJoinExecutor::NextMatch() {
+    auto predicate = plan_->Predicate();
+    while(true){
+        if(matches_ != nullptr && match_cursor_ < matches_->size()){
+            match_cursor_++;
+            if(predicate == nullptr || predicate->EvaluateJoin(&LeftTuple(), left_executor_->GetOutputSchema(),
+                                                               &RightTuple(), right_executor_->GetOutputSchema()).GetAs<bool>()){
+                return true;
+            }
+            continue;
+        }
+        if(matches_ != nullptr){
+            probe_cursor_++;
+            matches_ = nullptr;
+        }
+        if(probe_cursor_ == probe_tuples_.size()){
+            probe_tuples_.clear();
+            probe_keys_.clear();
+            probe_cursor_ = 0;
+            if(!ReadProbe()){
+                return false;
+            }
+            continue;
+        }
+        auto it = probe_keys_[probe_cursor_].HasNull() ? hash_table_.end() : hash_table_.find(probe_keys_[probe_cursor_]);
+        if(it == hash_table_.end()){
+            probe_cursor_++;
+            continue;
+        }
+        matches_ = &it->second;
+        match_cursor_ = 0;
+    }
+}
+
+const Tuple &HashJoinExecutor::LeftTuple() const {
+    return build_left_ ? (*matches_)[match_cursor_ - 1] : probe_tuples_[probe_cursor_];
+}
+
+const Tuple &HashJoinExecutor::RightTuple() const {
+    return build_left_ ? probe_tuples_[probe_cursor_] : (*matches_)[match_cursor_ - 1];
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+    if(!NextMatch()){
+        return false;
+    }
+    std::vector<Value> values;
+    auto output_schema = GetOutputSchema();
+    for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+        values.push_back(output_schema->GetColumn(i).GetExpr()->EvaluateJoin(
+            &LeftTuple(), left_executor_->GetOutputSchema(), &RightTuple(), right_executor_->GetOutputSchema()));
+    }
+    *tuple = Tuple(values, output_schema);
+    return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+    auto output_schema = GetOutputSchema();
+    batch->Reset(output_schema->GetColumnCount());
+    while(!batch->IsFull() && NextMatch()){
+        for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+            batch->GetColumn(i).push_back(output_schema->GetColumn(i).GetExpr()->EvaluateJoin(
+                &LeftTuple(), left_executor_->GetOutputSchema(), &RightTuple(), right_executor_->GetOutputSchema()));
+        }
+        batch->AppendRow(RID());
+    }
+    return !batch->IsEmpty();
+}
+
+}  // namespace bustub
@@ -11,42 +11,179 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/index_scan_executor.h"
 
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/value_factory.h"
+
 namespace bustub {
 IndexScanExecutor::IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx), iter_(nullptr, 0, nullptr) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), iter_(nullptr, RID{}, nullptr) {}
 
 void IndexScanExecutor::Init() {
     index_info_ =exec_ctx_->GetCatalog()->GetIndex(plan_->GetIndexOid()); 
-    index_ = reinterpret_cast<BPlusTreeIndexType*>(index_info_->index_.get());
+    index_ = index_info_->index_.get();
     table_info_ = exec_ctx_->GetCatalog()->GetTable(index_info_->table_name_);
     table_heap_ = table_info_->table_.get(); 
-    iter_ = index_->GetBeginIterator();
+
+    std::unique_ptr<Tuple> low_key;
+    std::unique_ptr<Tuple> high_key;
+    bool low_inclusive = true;
+    bool high_inclusive = true;
+    DeriveScanRange(&low_key, &low_inclusive, &high_key, &high_inclusive);
+
+    const std::vector<uint32_t> &entry_attrs = index_->GetEntryAttrs();
+    entry_column_of_.assign(table_info_->schema_.GetColumnCount(), -1);
+    for(size_t i = 0; i < entry_attrs.size(); ++i){
+        entry_column_of_[entry_attrs[i]] = static_cast<int>(i);
+    }
+    const Schema* output_schema = GetOutputSchema();
+    index_only_ = IsCovered(plan_->GetPredicate());
+    for(size_t i = 0; index_only_ && i < output_schema->GetColumnCount(); ++i){
+        index_only_ = IsCovered(output_schema->GetColumn(i).GetExpr());
+    }
+
+    rids_.clear();
+    entries_.clear();
+    cursor_ = 0;
+    // a hash index only finds the entries of a whole key, both bounds are only derived from an equality
+    bool whole_key_equality = low_key != nullptr && high_key != nullptr && index_->GetKeyAttrs().size() == 1;
+    full_scan_ = index_info_->index_type_ != IndexType::BPLUS_TREE && !whole_key_equality;
+    if(full_scan_){
+        // any other scan of a hash index reads the whole table and leaves the rows to the predicate
+        index_only_ = false;
+        iter_ = table_heap_->Begin(exec_ctx_->GetTransaction());
+        return;
+    }
+    // the bounds only fix the leading key column, the scan stops once that column is past the bound
+    index_->ScanRange(low_key.get(), low_inclusive, high_key.get(), high_inclusive, &rids_,
+                      exec_ctx_->GetTransaction(), ScanDirection::FORWARD, index_only_ ? &entries_ : nullptr, 1);
+}
+
+bool IndexScanExecutor::IsCovered(const AbstractExpression *expr) const {
+    if(expr == nullptr){
+        return true;
+    }
+    auto column = dynamic_cast<const ColumnValueExpression *>(expr);
+    if(column != nullptr && (column->GetColIdx() >= entry_column_of_.size() || entry_column_of_[column->GetColIdx()] < 0)){
+        return false;
+    }
+    for(auto child : expr->GetChildren()){
+        if(!IsCovered(child)){
+            return false;
+        }
+    }
+    return true;
+}
+
+Tuple IndexScanExecutor::RowFromEntry(const Tuple &entry) const {
+    const Schema &table_schema = table_info_->schema_;
+    const Schema *entry_schema = index_->GetEntrySchema();
+    std::vector<Value> values;
+    values.reserve(table_schema.GetColumnCount());
+    for(uint32_t i = 0; i < table_schema.GetColumnCount(); ++i){
+        if(entry_column_of_[i] >= 0){
+            values.push_back(entry.GetValue(entry_schema, entry_column_of_[i]));
+        }else{
+            values.push_back(ValueFactory::GetNullValueByType(table_schema.GetColumn(i).GetType()));
+        }
+    }
+    return Tuple(values, &table_schema);
+}
+
+void IndexScanExecutor::DeriveScanRange(std::unique_ptr<Tuple> *low_key, bool *low_inclusive,
+                                        std::unique_ptr<Tuple> *high_key, bool *high_inclusive) {
+    auto comparison = dynamic_cast<const ComparisonExpression *>(plan_->GetPredicate());
+    if(comparison == nullptr){
+        return;
+    }
+    auto column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(0));
+    auto constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(1));
+    ComparisonType comp_type = comparison->GetComparisonType();
+    if(column == nullptr || constant == nullptr){
+        // constant <op> column, mirror the comparison
+        column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(1));
+        constant = dynamic_cast<const ConstantValueExpression *>(comparison->GetChildAt(0));
+        switch(comp_type){
+            case ComparisonType::LessThan: comp_type = ComparisonType::GreaterThan; break;
+            case ComparisonType::LessThanOrEqual: comp_type = ComparisonType::GreaterThanOrEqual; break;
+            case ComparisonType::GreaterThan: comp_type = ComparisonType::LessThan; break;
+            case ComparisonType::GreaterThanOrEqual: comp_type = ComparisonType::LessThanOrEqual; break;
+            default: break;
+        }
+    }
+    if(column == nullptr || constant == nullptr || column->GetColIdx() != index_->GetKeyAttrs()[0]){
+        return;
+    }
+
+    Value value = constant->Evaluate(nullptr, nullptr);
+    const Column &key_column = index_->GetKeySchema()->GetColumn(0);
+    if(value.IsNull() || value.GetTypeId() != key_column.GetType()){
+        // leave mixed type comparisons to the predicate instead of guessing a cast
+        return;
+    }
+    switch(comp_type){
+        case ComparisonType::Equal:
+            *low_key = MakeBoundKey(value);
+            *high_key = MakeBoundKey(value);
+            break;
+        case ComparisonType::GreaterThan:
+            *low_key = MakeBoundKey(value);
+            *low_inclusive = false;
+            break;
+        case ComparisonType::GreaterThanOrEqual:
+            *low_key = MakeBoundKey(value);
+            break;
+        case ComparisonType::LessThan:
+            *high_key = MakeBoundKey(value);
+            *high_inclusive = false;
+            break;
+        case ComparisonType::LessThanOrEqual:
+            *high_key = MakeBoundKey(value);
+            break;
+        default:
+            break;
+    }
+}
+
+std::unique_ptr<Tuple> IndexScanExecutor::MakeBoundKey(const Value &value) {
+    const Schema *key_schema = index_->GetKeySchema();
+    std::vector<Value> values{value};
+    for(uint32_t i = 1; i < key_schema->GetColumnCount(); ++i){
+        values.push_back(Type::GetMinValue(key_schema->GetColumn(i).GetType()));
+    }
+    return std::make_unique<Tuple>(values, key_schema);
 }
 
 bool IndexScanExecutor::Next(Tuple *tuple, RID *rid) {
     auto predicate = plan_->GetPredicate();
     const Schema* output_schema = GetOutputSchema();
-    while(iter_ != index_->GetEndIterator()){
-        *rid = (*iter_).second;
-        
-        /*std::vector<Value> values;
-        for(size_t i = 0; i < output_schema->GetColumnCount(); ++i){
-
-        }*/
-        Transaction *tx = GetExecutorContext()->GetTransaction();
-        table_heap_->GetTuple(*rid, tuple, tx);
-
+    Transaction *tx = GetExecutorContext()->GetTransaction();
+    while(full_scan_ ? iter_ != table_heap_->End() : cursor_ < rids_.size()){
+        if(full_scan_){
+            *tuple = *iter_;
+            *rid = iter_->GetRid();
+            ++iter_;
+        }else if(index_only_){
+            size_t pos = cursor_++;
+            *rid = rids_[pos];
+            // the entry holds every column this scan reads, no heap page is visited
+            *tuple = RowFromEntry(entries_[pos]);
+        }else{
+            *rid = rids_[cursor_++];
+            if(!table_heap_->GetTuple(*rid, tuple, tx)){
+                continue;
+            }
+        }
+        if(predicate != nullptr && !predicate->Evaluate(tuple, &table_info_->schema_).GetAs<bool>()){
+            continue;
+        }
         std::vector<Value> values;
         for(size_t i = 0; i < output_schema->GetColumnCount(); ++i){
             values.push_back(output_schema->GetColumn(i).GetExpr()->Evaluate(tuple, &table_info_->schema_));
         }
-        Tuple new_tuple(values, output_schema);
-        ++iter_;
-        // ? output_schema or table_info->schema_
-        if(predicate == nullptr || predicate->Evaluate(tuple, output_schema).GetAs<bool>()){
-            *tuple = new_tuple;
-            return true;
-        }
+        *tuple = Tuple(values, output_schema);
+        return true;
     }
     return false;
 
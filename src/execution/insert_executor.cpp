@@ -35,7 +35,7 @@ void InsertExecutor::Init() {
 void InsertExecutor::Insert(Tuple* tuple, RID* rid){
     table_->InsertTuple(*tuple, rid, GetExecutorContext()->GetTransaction());
     for(auto& index_ptr : index_info_){
-        index_ptr->index_->InsertEntry(tuple->KeyFromTuple(table_info_->schema_, index_ptr->key_schema_, index_ptr->index_->GetKeyAttrs()),
+        index_ptr->index_->InsertEntry(tuple->KeyFromTuple(table_info_->schema_, *index_ptr->index_->GetEntrySchema(), index_ptr->index_->GetEntryAttrs()),
         *rid, GetExecutorContext()->GetTransaction());
     }
 }
@@ -16,10 +16,25 @@ namespace bustub {
 
 LimitExecutor::LimitExecutor(ExecutorContext *exec_ctx, const LimitPlanNode *plan,
                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)) {}
 
-void LimitExecutor::Init() {}
+void LimitExecutor::Init() {
+    child_executor_->Init();
+    returned_ = 0;
+    Tuple tuple;
+    RID rid;
+    size_t skipped = 0;
+    while(skipped < plan_->GetOffset() && child_executor_->Next(&tuple, &rid)){
+        skipped++;
+    }
+}
 
-bool LimitExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool LimitExecutor::Next(Tuple *tuple, RID *rid) {
+    if(returned_ == plan_->GetLimit() || !child_executor_->Next(tuple, rid)){
+        return false;
+    }
+    returned_++;
+    return true;
+}
 
 }  // namespace bustub
@@ -0,0 +1,38 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.cpp
+//
+// Identification: src/execution/morsel_dispenser.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_dispenser.h"
+
+#include "common/exception.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+bool MorselDispenser::Claim(std::vector<page_id_t> *morsel) {
+    morsel->clear();
+    std::scoped_lock lock{latch_};
+    // the chain is only known a page at a time, so the dispenser follows it for the scans
+    while(morsel->size() < MORSEL_PAGES && next_page_id_ != INVALID_PAGE_ID){
+        auto page = static_cast<TablePage *>(bpm_->FetchPage(next_page_id_));
+        if(page == nullptr){
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a table page to claim a morsel");
+        }
+        morsel->push_back(next_page_id_);
+        page->RLatch();
+        next_page_id_ = page->GetNextPageId();
+        page->RUnlatch();
+        bpm_->UnpinPage(morsel->back(), false);
+    }
+    return !morsel->empty();
+}
+
+}  // namespace bustub
@@ -12,15 +12,24 @@
 
 #include "execution/executors/nested_index_join_executor.h"
 
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+
 namespace bustub {
 
 NestIndexJoinExecutor::NestIndexJoinExecutor(ExecutorContext *exec_ctx, const NestedIndexJoinPlanNode *plan,
                                              std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx), table_info_(nullptr), index_info_(nullptr), child_executor_(std::move(child_executor)) {}
+    : AbstractExecutor(exec_ctx), plan_(plan), table_info_(nullptr), index_info_(nullptr),
+      child_executor_(std::move(child_executor)) {}
 
 void NestIndexJoinExecutor::Init() {
     table_info_ = GetExecutorContext()->GetCatalog()->GetTable(plan_->GetInnerTableOid());
     index_info_ = GetExecutorContext()->GetCatalog()->GetIndex(plan_->GetIndexName(), table_info_->name_);
+    child_executor_->Init();
+    outer_tuples_.clear();
+    matches_.clear();
+    outer_cursor_ = 0;
+    match_cursor_ = 0;
 }
 
 Tuple NestIndexJoinExecutor::Index_Join(Tuple *left_tuple, Tuple *right_tuple){
@@ -34,24 +43,97 @@ Tuple NestIndexJoinExecutor::Index_Join(Tuple *left_tuple, Tuple *right_tuple){
     
 }
 
-bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
-    Tuple left_tuple, right_tuple;
-    while (true){
-        if(!rids_.empty()){
-            auto right_rid = rids_.back();
-            table_info_->table_->GetTuple(right_rid, &right_tuple, GetExecutorContext()->GetTransaction());
+Tuple NestIndexJoinExecutor::MakeProbeKey(const Tuple &outer_tuple) {
+    Index *index = index_info_->index_.get();
+    auto comparison = dynamic_cast<const ComparisonExpression *>(plan_->Predicate());
+    if(comparison != nullptr && comparison->GetComparisonType() == ComparisonType::Equal &&
+       index->GetKeyAttrs().size() == 1){
+        for(uint32_t side = 0; side < 2; side++){
+            auto inner_column = dynamic_cast<const ColumnValueExpression *>(comparison->GetChildAt(side));
+            if(inner_column == nullptr || inner_column->GetTupleIdx() != 1 ||
+               inner_column->GetColIdx() != index->GetKeyAttrs()[0]){
+                continue;
+            }
+            Value value = comparison->GetChildAt(1 - side)->Evaluate(&outer_tuple, plan_->OuterTableSchema());
+            TypeId key_type = index->GetKeySchema()->GetColumn(0).GetType();
+            if(value.GetTypeId() != key_type){
+                value = value.CastAs(key_type);
+            }
+            return Tuple({value}, index->GetKeySchema());
+        }
+    }
+    return outer_tuple;
+}
 
-            *tuple = Index_Join(&left_tuple, &right_tuple); 
-            return true;
+bool NestIndexJoinExecutor::FetchOuterBatch() {
+    outer_tuples_.clear();
+    outer_cursor_ = 0;
+    match_cursor_ = 0;
+    if(!child_executor_->NextBatch(&outer_batch_)){
+        return false;
+    }
+    outer_tuples_.reserve(outer_batch_.Size());
+    for(uint32_t i = 0; i < outer_batch_.Size(); i++){
+        outer_tuples_.push_back(outer_batch_.GetTuple(outer_batch_.SelectedRow(i), plan_->OuterTableSchema()));
+    }
+    // probe all keys of the batch in one sorted pass over the index instead of one descent per outer tuple
+    std::vector<Tuple> keys;
+    keys.reserve(outer_tuples_.size());
+    for(const auto &tuple : outer_tuples_){
+        keys.push_back(MakeProbeKey(tuple));
+    }
+    index_info_->index_->ScanKeys(keys, &matches_, GetExecutorContext()->GetTransaction());
+    return true;
+}
+
+bool NestIndexJoinExecutor::NextMatch(Tuple *right_tuple, RID *rid) {
+    auto predicate = plan_->Predicate();
+    while (true){
+        if(outer_cursor_ >= outer_tuples_.size()){
+            if(!FetchOuterBatch()){
+                return false;
+            }
+            continue;
         }
-    
-        if(!child_executor_->Next(&left_tuple, rid)){
-            return false;
+        if(match_cursor_ >= matches_[outer_cursor_].size()){
+            outer_cursor_++;
+            match_cursor_ = 0;
+            continue;
+        }
+        *rid = matches_[outer_cursor_][match_cursor_++];
+        if(!table_info_->table_->GetTuple(*rid, right_tuple, GetExecutorContext()->GetTransaction())){
+            continue;
+        }
+        if(predicate != nullptr && !predicate->EvaluateJoin(&outer_tuples_[outer_cursor_], plan_->OuterTableSchema(),
+                                                            right_tuple, plan_->InnerTableSchema()).GetAs<bool>()){
+            continue;
+        }
+        return true;
+    }
+}
+
+bool NestIndexJoinExecutor::Next(Tuple *tuple, RID *rid) {
+    Tuple right_tuple;
+    if(!NextMatch(&right_tuple, rid)){
+        return false;
+    }
+    *tuple = Index_Join(&outer_tuples_[outer_cursor_], &right_tuple);
+    return true;
+}
+
+bool NestIndexJoinExecutor::NextBatch(TupleBatch *batch) {
+    auto output_schema = GetOutputSchema();
+    batch->Reset(output_schema->GetColumnCount());
+    Tuple right_tuple;
+    RID rid;
+    while(!batch->IsFull() && NextMatch(&right_tuple, &rid)){
+        for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+            batch->GetColumn(i).push_back(output_schema->GetColumn(i).GetExpr()->EvaluateJoin(
+                &outer_tuples_[outer_cursor_], plan_->OuterTableSchema(), &right_tuple, plan_->InnerTableSchema()));
         }
-        // ? left_tuple
-        index_info_->index_->ScanKey(left_tuple, &rids_, GetExecutorContext()->GetTransaction());
+        batch->AppendRow(rid);
     }
-    return false;
+    return !batch->IsEmpty();
 }
 
 }  // namespace bustub
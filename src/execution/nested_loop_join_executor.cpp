@@ -23,6 +23,17 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
 void NestedLoopJoinExecutor::Init() {
     left_executor_->Init();
     right_executor_->Init();
+    // the inner side is read once and kept, every outer tuple is joined with all of it
+    right_tuples_.clear();
+    TupleBatch batch;
+    while(right_executor_->NextBatch(&batch)){
+        for(uint32_t i = 0; i < batch.Size(); i++){
+            right_tuples_.push_back(batch.GetTuple(batch.SelectedRow(i), right_executor_->GetOutputSchema()));
+        }
+    }
+    left_tuples_.clear();
+    left_cursor_ = 0;
+    right_cursor_ = right_tuples_.size();
 }
 
 Tuple NestedLoopJoinExecutor::Join(Tuple *left_tuple, Tuple *right_tuple){
@@ -36,20 +47,57 @@ Tuple NestedLoopJoinExecutor::Join(Tuple *left_tuple, Tuple *right_tuple){
     
 }
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
-    Tuple t1, t2;
-    RID r1, r2;
-    // ? while or if
-    while(left_executor_->Next(&t1, &r1)){
-        if(right_executor_->Next(&t2, &r2)){
-            if(plan_->Predicate()->EvaluateJoin(&t1, left_executor_->GetOutputSchema(), &t2, right_executor_->GetOutputSchema()).GetAs<bool>()){
-                *tuple = Join(&t1, &t2);
+bool NestedLoopJoinExecutor::NextMatch() {
+    auto predicate = plan_->Predicate();
+    while(true){
+        if(right_cursor_ < right_tuples_.size()){
+            Tuple *right_tuple = &right_tuples_[right_cursor_++];
+            if(predicate == nullptr || predicate->EvaluateJoin(&left_tuples_[left_cursor_], left_executor_->GetOutputSchema(),
+                                                               right_tuple, right_executor_->GetOutputSchema()).GetAs<bool>()){
                 return true;
             }
+            continue;
+        }
+        if(right_tuples_.empty()){
+            return false;
+        }
+        if(++left_cursor_ < left_tuples_.size()){
+            right_cursor_ = 0;
+            continue;
+        }
+        left_tuples_.clear();
+        left_cursor_ = 0;
+        if(!left_executor_->NextBatch(&left_batch_)){
+            return false;
+        }
+        right_cursor_ = 0;
+        for(uint32_t i = 0; i < left_batch_.Size(); i++){
+            left_tuples_.push_back(left_batch_.GetTuple(left_batch_.SelectedRow(i), left_executor_->GetOutputSchema()));
         }
     }
-    return false;
-    
+}
+
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+    if(!NextMatch()){
+        return false;
+    }
+    *tuple = Join(&left_tuples_[left_cursor_], &right_tuples_[right_cursor_ - 1]);
+    return true;
+}
+
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+    auto output_schema = GetOutputSchema();
+    batch->Reset(output_schema->GetColumnCount());
+    while(!batch->IsFull() && NextMatch()){
+        Tuple *left_tuple = &left_tuples_[left_cursor_];
+        Tuple *right_tuple = &right_tuples_[right_cursor_ - 1];
+        for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+            batch->GetColumn(i).push_back(output_schema->GetColumn(i).GetExpr()->EvaluateJoin(
+                left_tuple, left_executor_->GetOutputSchema(), right_tuple, right_executor_->GetOutputSchema()));
+        }
+        batch->AppendRow(RID());
+    }
+    return !batch->IsEmpty();
 }
 
 }  // namespace bustub
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// query_worker_pool.cpp
+//
+// Identification: src/execution/query_worker_pool.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/query_worker_pool.h"
+
+#include <utility>
+
+namespace bustub {
+
+QueryWorkerPool::~QueryWorkerPool() {
+    {
+        std::scoped_lock lock{latch_};
+        shutdown_ = true;
+    }
+    cv_.notify_all();
+    for(auto &thread : threads_){
+        thread.join();
+    }
+}
+
+void QueryWorkerPool::Submit(std::function<void()> task) {
+    std::scoped_lock lock{latch_};
+    tasks_.push_back(std::move(task));
+    if(idle_threads_ >= tasks_.size()){
+        cv_.notify_one();
+        return;
+    }
+    threads_.emplace_back(&QueryWorkerPool::Work, this);
+}
+
+size_t QueryWorkerPool::GetThreadCount() {
+    std::scoped_lock lock{latch_};
+    return threads_.size();
+}
+
+void QueryWorkerPool::Work() {
+    std::unique_lock lock{latch_};
+    while(true){
+        idle_threads_++;
+        cv_.wait(lock, [&] { return shutdown_ || !tasks_.empty(); });
+        idle_threads_--;
+        if(tasks_.empty()){
+            return;
+        }
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+}  // namespace bustub
@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 #include "execution/executors/seq_scan_executor.h"
 
+#include "common/exception.h"
+#include "storage/page/table_page.h"
+
 namespace bustub {
 
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx),plan_(plan)
@@ -22,9 +25,28 @@ void SeqScanExecutor::Init() {
     table_info_ =exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid()); 
     table_heap_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid())->table_.get();
     iter_ = table_heap_->Begin(exec_ctx_->GetTransaction());
+    auto worker_group = exec_ctx_->GetWorkerGroup();
+    dispenser_ = worker_group == nullptr ? nullptr : worker_group->GetDispenser(plan_, table_heap_, exec_ctx_->GetBufferPoolManager());
+    morsel_.clear();
+    morsel_cursor_ = 0;
+    row_batch_.Reset(0);
+    row_cursor_ = 0;
 }
 
 bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
+    if(dispenser_ != nullptr){
+        // the claimed pages are only read a batch at a time
+        if(row_cursor_ == row_batch_.Size()){
+            if(!NextBatch(&row_batch_)){
+                return false;
+            }
+            row_cursor_ = 0;
+        }
+        uint32_t row = row_batch_.SelectedRow(row_cursor_++);
+        *tuple = row_batch_.GetTuple(row, plan_->OutputSchema());
+        *rid = row_batch_.GetRid(row);
+        return true;
+    }
     if(iter_ == table_heap_->End()){
         return false;
     }
@@ -40,7 +62,7 @@ bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
     }
     Tuple new_tuple(values, output_schema);
     ++iter_;
-    if(predicate == nullptr || predicate->Evaluate(tuple, plan_->OutputSchema()).GetAs<bool>()){
+    if(predicate == nullptr || predicate->Evaluate(tuple, &table_info_->schema_).GetAs<bool>()){
         *tuple = new_tuple;
         *rid = original_rid;
         return true;
@@ -48,6 +70,87 @@ bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
     return Next(tuple, rid);
 }
 
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+    auto predicate = plan_->GetPredicate();
+    const Schema *output_schema = plan_->OutputSchema();
+    const Schema *table_schema = &table_info_->schema_;
+    TableIterator end = table_heap_->End();
+    batch->Reset(output_schema->GetColumnCount());
+    std::vector<Value> matches;
+    while(batch->IsEmpty()){
+        // decode a batch of table tuples, then filter and project it one expression at a time
+        scan_batch_.Reset(table_schema->GetColumnCount());
+        if(dispenser_ != nullptr){
+            ScanMorsels();
+        } else {
+            while(!scan_batch_.IsFull() && iter_ != end){
+                const Tuple &tuple = *iter_;
+                scan_batch_.AppendTuple(tuple, table_schema, tuple.GetRid());
+                ++iter_;
+            }
+        }
+        if(scan_batch_.GetRowCount() == 0){
+            break;
+        }
+        if(predicate != nullptr){
+            predicate->EvaluateBatch(scan_batch_, table_schema, &matches);
+            std::vector<uint32_t> selection;
+            for(uint32_t i = 0; i < scan_batch_.Size(); i++){
+                if(matches[i].GetAs<bool>()){
+                    selection.push_back(scan_batch_.SelectedRow(i));
+                }
+            }
+            scan_batch_.SetSelection(std::move(selection));
+        }
+        for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+            output_schema->GetColumn(i).GetExpr()->EvaluateBatch(scan_batch_, table_schema, &batch->GetColumn(i));
+        }
+        for(uint32_t i = 0; i < scan_batch_.Size(); i++){
+            batch->AppendRow(scan_batch_.GetRid(scan_batch_.SelectedRow(i)));
+        }
+    }
+    return !batch->IsEmpty();
+}
+
+void SeqScanExecutor::ScanMorsels() {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    const Schema *table_schema = &table_info_->schema_;
+    Tuple tuple;
+    while(true){
+        if(morsel_cursor_ == morsel_.size()){
+            morsel_cursor_ = 0;
+            if(!dispenser_->Claim(&morsel_)){
+                return;
+            }
+        }
+        page_id_t page_id = morsel_[morsel_cursor_];
+        auto page = static_cast<TablePage *>(bpm->FetchPage(page_id));
+        if(page == nullptr){
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a table page of a morsel");
+        }
+        page->RLatch();
+        // a page is read as a whole, it is left for the next batch if this one has no room for its tuples
+        if(scan_batch_.GetRowCount() > 0 && scan_batch_.GetRowCount() + page->GetTupleCount() > TupleBatch::BATCH_SIZE){
+            page->RUnlatch();
+            bpm->UnpinPage(page_id, false);
+            return;
+        }
+        RID rid;
+        bool found = page->GetFirstTupleRid(&rid);
+        while(found){
+            if(page->GetTuple(rid, &tuple, exec_ctx_->GetTransaction(), exec_ctx_->GetLockManager())){
+                scan_batch_.AppendTuple(tuple, table_schema, rid);
+            }
+            RID next_rid;
+            found = page->GetNextTupleRid(rid, &next_rid);
+            rid = next_rid;
+        }
+        page->RUnlatch();
+        bpm->UnpinPage(page_id, false);
+        morsel_cursor_++;
+    }
+}
+
 }  // namespace bustub
 
 
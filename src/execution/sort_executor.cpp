@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)),
+    encoder_(plan->GetOrderBys()){}
+
+SortExecutor::~SortExecutor() { DropRuns(); }
+
+void SortExecutor::Init() {
+    child_executor_->Init();
+    DropRuns();
+    entries_.clear();
+    sorted_.clear();
+    cursor_ = 0;
+    run_count_ = 0;
+    auto schema = child_executor_->GetOutputSchema();
+    size_t budget = plan_->GetMemoryPages() * PAGE_SIZE;
+    size_t bytes = 0;
+    TupleBatch batch;
+    std::vector<std::string> keys;
+    while(child_executor_->NextBatch(&batch)){
+        encoder_.EncodeBatch(batch, schema, &keys);
+        for(uint32_t i = 0; i < batch.Size(); i++){
+            entries_.push_back(SortEntry{std::move(keys[i]), batch.GetTuple(batch.SelectedRow(i), schema)});
+            bytes += sizeof(SortEntry) + entries_.back().key_.size() + entries_.back().tuple_.GetLength();
+            if(bytes > budget){
+                SpillRun();
+                bytes = 0;
+            }
+        }
+    }
+    if(runs_.empty()){
+        SortEntries();
+        return;
+    }
+    if(!entries_.empty()){
+        SpillRun();
+    }
+    // every run being merged holds a page in memory and the run being written one more
+    size_t fanout = std::max<size_t>(2, plan_->GetMemoryPages() > 0 ? plan_->GetMemoryPages() - 1 : 0);
+    while(runs_.size() > fanout){
+        // merge groups of neighbouring runs, so that equal keys stay in the order of the child
+        std::vector<std::vector<page_id_t>> runs = std::move(runs_);
+        runs_.clear();
+        for(size_t first = 0; first < runs.size(); first += fanout){
+            size_t last = std::min(runs.size(), first + fanout);
+            StartMerge(std::vector<std::vector<page_id_t>>(std::make_move_iterator(runs.begin() + first),
+                                                           std::make_move_iterator(runs.begin() + last)));
+            std::vector<page_id_t> pages;
+            TmpTuplePage *page = nullptr;
+            for(auto entry = MergeTop(); entry != nullptr; entry = MergeTop()){
+                AppendToRun(&pages, &page, entry->tuple_);
+                MergePop();
+            }
+            FinishRun(page);
+            runs_.push_back(std::move(pages));
+        }
+    }
+    StartMerge(std::move(runs_));
+    runs_.clear();
+}
+
+void SortExecutor::SortEntries() {
+    // the entries stay where they are, only their indexes are sorted
+    sorted_.resize(entries_.size());
+    for(uint32_t i = 0; i < sorted_.size(); i++){
+        sorted_[i] = i;
+    }
+    std::stable_sort(sorted_.begin(), sorted_.end(),
+                     [this](uint32_t a, uint32_t b){ return entries_[a].key_ < entries_[b].key_; });
+}
+
+void SortExecutor::SpillRun() {
+    SortEntries();
+    std::vector<page_id_t> pages;
+    TmpTuplePage *page = nullptr;
+    for(auto i : sorted_){
+        AppendToRun(&pages, &page, entries_[i].tuple_);
+    }
+    FinishRun(page);
+    runs_.push_back(std::move(pages));
+    run_count_++;
+    entries_.clear();
+    sorted_.clear();
+}
+
+void SortExecutor::AppendToRun(std::vector<page_id_t> *pages, TmpTuplePage **page, const Tuple &tuple) {
+    TmpTuple location(INVALID_PAGE_ID, 0);
+    if(*page != nullptr && (*page)->Insert(tuple, &location)){
+        return;
+    }
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    FinishRun(*page);
+    page_id_t page_id;
+    *page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+    if(*page == nullptr){
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot allocate a page to spill the sort");
+    }
+    (*page)->Init(page_id, PAGE_SIZE);
+    pages->push_back(page_id);
+    bool inserted = (*page)->Insert(tuple, &location);
+    BUSTUB_ASSERT(inserted, "A tuple must fit an empty page.");
+}
+
+void SortExecutor::FinishRun(TmpTuplePage *page) {
+    if(page != nullptr){
+        exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetTablePageId(), true);
+    }
+}
+
+bool SortExecutor::LoadPage(Run *run) {
+    run->entries_.clear();
+    run->cursor_ = 0;
+    if(run->next_page_ == run->pages_.size()){
+        return false;
+    }
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    page_id_t page_id = run->pages_[run->next_page_++];
+    auto page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+    if(page == nullptr){
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a spilled page of the sort");
+    }
+    auto schema = child_executor_->GetOutputSchema();
+    uint32_t offset = page->GetFreeSpacePointer();
+    while(offset < PAGE_SIZE){
+        SortEntry entry;
+        offset = page->Get(offset, &entry.tuple_);
+        entry.key_ = encoder_.Encode(entry.tuple_, schema);
+        run->entries_.push_back(std::move(entry));
+    }
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+    // a page is read from the tuple inserted last
+    std::reverse(run->entries_.begin(), run->entries_.end());
+    return true;
+}
+
+void SortExecutor::StartMerge(std::vector<std::vector<page_id_t>> &&runs) {
+    merge_runs_.clear();
+    merge_runs_.resize(runs.size());
+    for(size_t i = 0; i < runs.size(); i++){
+        merge_runs_[i].pages_ = std::move(runs[i]);
+        LoadPage(&merge_runs_[i]);
+    }
+    merge_tree_ = std::make_unique<LoserTree<RunLess>>(merge_runs_.size(), RunLess{&merge_runs_});
+    merge_tree_->Init();
+}
+
+const SortExecutor::SortEntry *SortExecutor::MergeTop() const {
+    if(merge_runs_.empty()){
+        return nullptr;
+    }
+    const Run &run = merge_runs_[merge_tree_->Top()];
+    return run.IsExhausted() ? nullptr : &run.Head();
+}
+
+void SortExecutor::MergePop() {
+    size_t top = merge_tree_->Top();
+    Run &run = merge_runs_[top];
+    if(++run.cursor_ == run.entries_.size()){
+        LoadPage(&run);
+    }
+    merge_tree_->Replay(top);
+}
+
+void SortExecutor::DropRuns() {
+    auto bpm = exec_ctx_->GetBufferPoolManager();
+    for(const auto &pages : runs_){
+        for(auto page_id : pages){
+            bpm->DeletePage(page_id);
+        }
+    }
+    runs_.clear();
+    for(const auto &run : merge_runs_){
+        for(size_t i = run.next_page_; i < run.pages_.size(); i++){
+            bpm->DeletePage(run.pages_[i]);
+        }
+    }
+    merge_runs_.clear();
+    merge_tree_.reset();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+    const SortEntry *entry;
+    if(merge_tree_ != nullptr){
+        entry = MergeTop();
+    } else {
+        entry = cursor_ < sorted_.size() ? &entries_[sorted_[cursor_]] : nullptr;
+    }
+    if(entry == nullptr){
+        return false;
+    }
+    std::vector<Value> values;
+    auto output_schema = GetOutputSchema();
+    for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+        values.push_back(output_schema->GetColumn(i).GetExpr()->Evaluate(&entry->tuple_,
+                                                                          child_executor_->GetOutputSchema()));
+    }
+    *tuple = Tuple(values, output_schema);
+    if(merge_tree_ != nullptr){
+        MergePop();
+    } else {
+        cursor_++;
+    }
+    return true;
+}
+
+}  // namespace bustub
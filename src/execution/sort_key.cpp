@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.cpp
+//
+// Identification: src/execution/sort_key.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/sort_key.h"
+
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+void AppendBigEndian(uint64_t bits, std::string *key) {
+    for(int shift = 56; shift >= 0; shift -= 8){
+        key->push_back(static_cast<char>((bits >> shift) & 0xFF));
+    }
+}
+
+}  // namespace
+
+void SortKeyEncoder::AppendValue(const Value &value, OrderByType order, std::string *key) {
+    size_t start = key->size();
+    if(value.IsNull()){
+        key->push_back('\0');
+    } else {
+        key->push_back('\1');
+        switch(value.GetTypeId()){
+            case TypeId::BOOLEAN:
+                key->push_back(static_cast<char>(value.GetAs<int8_t>()));
+                break;
+            case TypeId::TINYINT:
+                AppendBigEndian(static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int8_t>())) ^ (1ULL << 63), key);
+                break;
+            case TypeId::SMALLINT:
+                AppendBigEndian(static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int16_t>())) ^ (1ULL << 63), key);
+                break;
+            case TypeId::INTEGER:
+                AppendBigEndian(static_cast<uint64_t>(static_cast<int64_t>(value.GetAs<int32_t>())) ^ (1ULL << 63), key);
+                break;
+            case TypeId::BIGINT:
+                AppendBigEndian(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ (1ULL << 63), key);
+                break;
+            case TypeId::TIMESTAMP:
+                AppendBigEndian(value.GetAs<uint64_t>(), key);
+                break;
+            case TypeId::DECIMAL: {
+                double raw = value.GetAs<double>();
+                uint64_t bits;
+                std::memcpy(&bits, &raw, sizeof(bits));
+                // negative numbers order backwards by their bits, so all of their bits are flipped
+                bits = (bits >> 63) != 0 ? ~bits : bits ^ (1ULL << 63);
+                AppendBigEndian(bits, key);
+                break;
+            }
+            case TypeId::VARCHAR: {
+                const char *data = value.GetData();
+                uint32_t len = value.GetLength();
+                // the stored length counts the terminating 0
+                if(len > 0 && data[len - 1] == '\0'){
+                    len--;
+                }
+                for(uint32_t i = 0; i < len; i++){
+                    key->push_back(data[i]);
+                    if(data[i] == '\0'){
+                        key->push_back('\xFF');
+                    }
+                }
+                key->push_back('\0');
+                key->push_back('\0');
+                break;
+            }
+            default:
+                BUSTUB_ASSERT(false, "Unsupported type.");
+        }
+    }
+    if(order == OrderByType::DESC){
+        for(size_t i = start; i < key->size(); i++){
+            (*key)[i] = static_cast<char>(~(*key)[i]);
+        }
+    }
+}
+
+std::string SortKeyEncoder::Encode(const Tuple &tuple, const Schema *schema) const {
+    std::string key;
+    for(const auto &order_by : order_bys_){
+        AppendValue(order_by.second->Evaluate(&tuple, schema), order_by.first, &key);
+    }
+    return key;
+}
+
+void SortKeyEncoder::EncodeBatch(const TupleBatch &batch, const Schema *schema, std::vector<std::string> *keys) const {
+    keys->assign(batch.Size(), std::string());
+    std::vector<Value> values;
+    for(const auto &order_by : order_bys_){
+        order_by.second->EvaluateBatch(batch, schema, &values);
+        for(uint32_t i = 0; i < batch.Size(); i++){
+            AppendValue(values[i], order_by.first, &(*keys)[i]);
+        }
+    }
+}
+
+}  // namespace bustub
@@ -0,0 +1,84 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/topn_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx), plan_(plan), child_executor_(std::move(child_executor)),
+    encoder_(plan->GetOrderBys()){}
+
+bool TopNExecutor::EntryLess(uint32_t a, uint32_t b) const {
+    int cmp = entries_[a].key_.compare(entries_[b].key_);
+    return cmp < 0 || (cmp == 0 && entries_[a].seq_ < entries_[b].seq_);
+}
+
+void TopNExecutor::Init() {
+    child_executor_->Init();
+    entries_.clear();
+    heap_.clear();
+    cursor_ = plan_->GetOffset();
+    size_t n = plan_->GetLimit() + plan_->GetOffset();
+    if(plan_->GetLimit() == 0){
+        return;
+    }
+    entries_.reserve(n);
+    heap_.reserve(n);
+    auto schema = child_executor_->GetOutputSchema();
+    auto less = [this](uint32_t a, uint32_t b){ return EntryLess(a, b); };
+    size_t seq = 0;
+    TupleBatch batch;
+    std::vector<std::string> keys;
+    while(child_executor_->NextBatch(&batch)){
+        encoder_.EncodeBatch(batch, schema, &keys);
+        for(uint32_t i = 0; i < batch.Size(); i++, seq++){
+            if(heap_.size() < n){
+                entries_.push_back(TopNEntry{std::move(keys[i]), seq, batch.GetTuple(batch.SelectedRow(i), schema)});
+                heap_.push_back(entries_.size() - 1);
+                std::push_heap(heap_.begin(), heap_.end(), less);
+                continue;
+            }
+            // a later tuple with an equal key orders after the largest one kept, so it is dropped too
+            if(keys[i].compare(entries_[heap_.front()].key_) >= 0){
+                continue;
+            }
+            std::pop_heap(heap_.begin(), heap_.end(), less);
+            TopNEntry &entry = entries_[heap_.back()];
+            entry.key_ = std::move(keys[i]);
+            entry.seq_ = seq;
+            entry.tuple_ = batch.GetTuple(batch.SelectedRow(i), schema);
+            std::push_heap(heap_.begin(), heap_.end(), less);
+        }
+    }
+    std::sort_heap(heap_.begin(), heap_.end(), less);
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+    if(cursor_ >= heap_.size()){
+        return false;
+    }
+    const Tuple &child_tuple = entries_[heap_[cursor_++]].tuple_;
+    std::vector<Value> values;
+    auto output_schema = GetOutputSchema();
+    for(uint32_t i = 0; i < output_schema->GetColumnCount(); i++){
+        values.push_back(output_schema->GetColumn(i).GetExpr()->Evaluate(&child_tuple,
+                                                                          child_executor_->GetOutputSchema()));
+    }
+    *tuple = Tuple(values, output_schema);
+    return true;
+}
+
+}  // namespace bustub
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t column_count) {
+    columns_.resize(column_count);
+    for (auto &column : columns_) {
+        column.clear();
+    }
+    rids_.clear();
+    selection_.clear();
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid) {
+    for (uint32_t i = 0; i < GetColumnCount(); i++) {
+        columns_[i].push_back(tuple.GetValue(schema, i));
+    }
+    AppendRow(rid);
+}
+
+uint32_t TupleBatch::AppendRow(const RID &rid) {
+    auto row = GetRowCount();
+    rids_.push_back(rid);
+    selection_.push_back(row);
+    return row;
+}
+
+Tuple TupleBatch::GetTuple(uint32_t row, const Schema *schema) const {
+    std::vector<Value> values;
+    values.reserve(GetColumnCount());
+    for (const auto &column : columns_) {
+        values.push_back(column[row]);
+    }
+    return Tuple(values, schema);
+}
+
+}  // namespace bustub
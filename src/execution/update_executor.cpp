@@ -34,7 +34,7 @@ void UpdateExecutor::update(Tuple* tuple, RID* rid){
     table_->UpdateTuple(*tuple, *rid, GetExecutorContext()->GetTransaction());
 
     for(auto& index_ptr_ : index_info_){
-        index_ptr_->index_->InsertEntry(tuple->KeyFromTuple(table_info_->schema_, index_ptr_->key_schema_, index_ptr_->index_->GetKeyAttrs()),
+        index_ptr_->index_->InsertEntry(tuple->KeyFromTuple(table_info_->schema_, *index_ptr_->index_->GetEntrySchema(), index_ptr_->index_->GetEntryAttrs()),
         *rid, GetExecutorContext()->GetTransaction());
     }
 }
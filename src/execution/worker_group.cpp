@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_group.cpp
+//
+// Identification: src/execution/worker_group.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/worker_group.h"
+
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/exchange_plan.h"
+
+namespace bustub {
+
+namespace {
+/** How the rows of a plan subtree are spread over its copies in a worker group. */
+enum class Distribution {
+    /** each row is returned by one of the copies */
+    SPLIT,
+    /** each row is returned by every copy */
+    WHOLE,
+    /** the copies return some rows a wrong number of times */
+    BROKEN
+};
+
+Distribution DistributionOf(const AbstractPlanNode *plan) {
+    switch(plan->GetType()){
+        case PlanType::SeqScan:
+            return Distribution::SPLIT;
+        case PlanType::IndexScan:
+            return Distribution::WHOLE;
+        case PlanType::Exchange: {
+            // the producers are copies of their own, the copies above only share out what they deliver
+            auto exchange = static_cast<const ExchangePlanNode *>(plan);
+            if(!WorkerGroup::CanSplit(exchange->GetChildPlan()) && exchange->GetParallelism() > 1){
+                return Distribution::BROKEN;
+            }
+            return exchange->GetExchangeType() == ExchangeType::BROADCAST ? Distribution::WHOLE : Distribution::SPLIT;
+        }
+        case PlanType::Aggregation: {
+            auto aggregation = static_cast<const AggregationPlanNode *>(plan);
+            if(aggregation->GetParallelism() > 1){
+                // its workers are copies of their own
+                return WorkerGroup::CanSplit(aggregation->GetChildPlan()) ? Distribution::WHOLE : Distribution::BROKEN;
+            }
+            // a single thread aggregates what its copy reads, which is only every group if the copy reads it all
+            return DistributionOf(aggregation->GetChildPlan()) == Distribution::WHOLE ? Distribution::WHOLE
+                                                                                      : Distribution::BROKEN;
+        }
+        case PlanType::Sort:
+        case PlanType::NestedIndexJoin:
+            return DistributionOf(plan->GetChildAt(0));
+        case PlanType::NestedLoopJoin:
+        case PlanType::HashJoin: {
+            Distribution left = DistributionOf(plan->GetChildAt(0));
+            Distribution right = DistributionOf(plan->GetChildAt(1));
+            if(left == Distribution::BROKEN || right == Distribution::BROKEN){
+                return Distribution::BROKEN;
+            }
+            if(left == Distribution::WHOLE || right == Distribution::WHOLE){
+                return left == right ? Distribution::WHOLE : Distribution::SPLIT;
+            }
+            // two split sides only pair up their rows if equal keys meet in the same copy
+            for(auto child : plan->GetChildren()){
+                if(child->GetType() != PlanType::Exchange ||
+                   static_cast<const ExchangePlanNode *>(child)->GetExchangeType() != ExchangeType::REPARTITION){
+                    return Distribution::BROKEN;
+                }
+            }
+            return Distribution::SPLIT;
+        }
+        case PlanType::Limit:
+        case PlanType::TopN:
+            return DistributionOf(plan->GetChildAt(0)) == Distribution::WHOLE ? Distribution::WHOLE
+                                                                              : Distribution::BROKEN;
+        default:
+            // every copy would write its own rows
+            return Distribution::BROKEN;
+    }
+}
+}  // namespace
+
+WorkerGroup::~WorkerGroup() {
+    for(auto &[plan, channel] : channels_){
+        channel->Cancel();
+    }
+}
+
+std::shared_ptr<MorselDispenser> WorkerGroup::GetDispenser(const AbstractPlanNode *plan, TableHeap *table_heap,
+                                                           BufferPoolManager *bpm) {
+    std::scoped_lock lock{latch_};
+    auto &dispenser = dispensers_[plan];
+    if(dispenser == nullptr){
+        dispenser = std::make_shared<MorselDispenser>(table_heap, bpm);
+    }
+    return dispenser;
+}
+
+std::shared_ptr<ExchangeChannel> WorkerGroup::GetChannel(const AbstractPlanNode *plan, uint32_t queue_count,
+                                                         uint32_t producer_count) {
+    std::scoped_lock lock{latch_};
+    auto &channel = channels_[plan];
+    if(channel == nullptr){
+        channel = std::make_shared<ExchangeChannel>(queue_count, producer_count);
+    }
+    return channel;
+}
+
+bool WorkerGroup::CanSplit(const AbstractPlanNode *plan) {
+    return DistributionOf(plan) == Distribution::SPLIT;
+}
+
+}  // namespace bustub
@@ -1,15 +1,24 @@
 #pragma once
 
+#include <algorithm>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/index/b_plus_tree_index.h"
+#include "storage/index/extendible_hash_table_index.h"
 #include "storage/index/index.h"
+#include "storage/index/linear_probe_hash_table_index.h"
+#include "storage/page/table_page.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
@@ -33,24 +42,43 @@ struct TableMetadata {
   table_oid_t oid_;
 };
 
+/**
+ * The structure behind an index. A B+ tree answers point and range scans, a hash index only equality lookups and does
+ * not store included columns. HASH is a linear probe table, EXTENDIBLE_HASH grows one bucket split at a time.
+ */
+enum class IndexType { BPLUS_TREE = 0, HASH, EXTENDIBLE_HASH };
+
 /**
  * Metadata about a index
  */
 struct IndexInfo {
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPLUS_TREE)
       : key_schema_(std::move(key_schema)),
         name_(std::move(name)),
         index_(std::move(index)),
         index_oid_(index_oid),
         table_name_(std::move(table_name)),
-        key_size_(key_size) {}
+        key_size_(key_size),
+        index_type_(index_type) {}
   Schema key_schema_;
   std::string name_;
   std::unique_ptr<Index> index_;
   index_oid_t index_oid_;
   std::string table_name_;
   const size_t key_size_;
+  /** hash indexes can only be scanned for an equality on every key column */
+  const IndexType index_type_;
+};
+
+/**
+ * Progress of the table scan that builds a new index, reported after every scanned table page and once more when the
+ * index is complete.
+ */
+struct IndexBuildProgress {
+  size_t pages_scanned_;
+  size_t tuples_scanned_;
+  bool done_;
 };
 
 /**
@@ -107,23 +135,48 @@ class Catalog {
    * @param key_schema the schema of the key
    * @param key_attrs key attributes
    * @param keysize size of the key
+   * @param is_unique whether the index rejects duplicate keys, false for a secondary index that keeps every (key, rid)
+   * @param include_attrs fixed size columns stored in the entries after the key, so that scans reading only key and
+   * included columns never visit the table
+   * @param progress called while the existing tuples are indexed, may be empty
+   * @param index_type the structure of the index, HASH or EXTENDIBLE_HASH for indexes that only serve equality
+   * lookups
    * @return a pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   IndexInfo *CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name,
                          const Schema &schema, const Schema &key_schema, const std::vector<uint32_t> &key_attrs,
-                         size_t keysize) {
+                         size_t keysize, bool is_unique = true, const std::vector<uint32_t> &include_attrs = {},
+                         const std::function<void(const IndexBuildProgress &)> &progress = nullptr,
+                         IndexType index_type = IndexType::BPLUS_TREE) {
     auto index_id = ++next_index_oid_;
-    auto index_metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs);
-    std::unique_ptr<Index> BPlusTree_index(new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(index_metadata, bpm_));
-    IndexInfo* new_index = new IndexInfo(key_schema, table_name, std::move(BPlusTree_index), index_id, table_name, keysize);
+    auto index_metadata = new IndexMetadata(index_name, table_name, &schema, key_attrs, is_unique, include_attrs);
+    const Schema *entry_schema = index_metadata->GetEntrySchema();
+    BUSTUB_ASSERT(include_attrs.empty() || (entry_schema->IsInlined() && entry_schema->GetLength() <= keysize &&
+                                            entry_schema->GetLength() <= sizeof(KeyType)),
+                  "Included columns must be fixed size and fit in the index key!");
+    BUSTUB_ASSERT(include_attrs.empty() || index_type == IndexType::BPLUS_TREE,
+                  "Only B+ tree indexes store included columns!");
+    std::unique_ptr<Index> index;
+    if (index_type == IndexType::HASH) {
+      auto *hash_index = new LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>(
+          index_metadata, bpm_, HASH_INDEX_INITIAL_BUCKETS, HashFunction<KeyType>());
+      index.reset(hash_index);
+      BuildHashIndex<KeyType, ValueType>(txn, hash_index, GetTable(table_name), progress);
+    } else if (index_type == IndexType::EXTENDIBLE_HASH) {
+      auto *hash_index = new ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>(index_metadata, bpm_,
+                                                                                          HashFunction<KeyType>());
+      index.reset(hash_index);
+      BuildHashIndex<KeyType, ValueType>(txn, hash_index, GetTable(table_name), progress);
+    } else {
+      auto *b_plus_tree_index = new BPlusTreeIndex<KeyType, ValueType, KeyComparator>(index_metadata, bpm_);
+      index.reset(b_plus_tree_index);
+      BuildIndex(txn, b_plus_tree_index, GetTable(table_name), is_unique, progress);
+    }
+
+    IndexInfo* new_index = new IndexInfo(key_schema, index_name, std::move(index), index_id, table_name, keysize, index_type);
     indexes_[index_id] = static_cast<std::unique_ptr<IndexInfo>>(new_index);
     index_names_[table_name].insert(std::pair<std::string, index_oid_t>(index_name, index_id));
-    auto table = GetTable(table_name)->table_.get();
-
-    for(auto it  = table->Begin(txn); it != table->End(); ++it){
-      new_index->index_->InsertEntry(it->KeyFromTuple(schema, key_schema, key_attrs), it->GetRid(), txn);
-    }
     return new_index;
   }
 
@@ -152,7 +205,179 @@ class Catalog {
     return ans;
   }
 
+  /** Set how many threads scan the table when an index is created, 0 picks one per hardware thread. */
+  void SetIndexBuildThreads(size_t threads) { index_build_threads_ = threads; }
+
  private:
+  /**
+   * Turn the existing tuples of a table into (key, rid) entries. Worker threads take table pages off the page chain one
+   * at a time and collect the entries of their pages in a run of their own, which finish_run (if set) is applied to on
+   * the same thread. With logging enabled the scan takes shared tuple locks for txn, which a transaction does not
+   * support from several threads, so it runs on the calling thread alone.
+   * @throws the first exception of a worker, such as a buffer pool without a free frame, once every worker stopped
+   */
+  template <class KeyType, class ValueType>
+  std::vector<std::vector<std::pair<KeyType, ValueType>>> ScanEntries(
+      Transaction *txn, Index *index, TableMetadata *table, IndexBuildProgress *status,
+      const std::function<void(const IndexBuildProgress &)> &progress,
+      const std::function<void(std::vector<std::pair<KeyType, ValueType>> *)> &finish_run) {
+    using Entry = std::pair<KeyType, ValueType>;
+    const Schema *entry_schema = index->GetEntrySchema();
+
+    size_t threads = index_build_threads_ != 0 ? index_build_threads_ : std::thread::hardware_concurrency();
+    if (enable_logging || threads == 0) {
+      threads = 1;
+    }
+    std::vector<std::vector<Entry>> runs(threads);
+    std::mutex chain_latch;
+    page_id_t next_page_id = table->table_->GetFirstPageId();
+    // the first failure of a worker, the others stop at their next page and it is rethrown once they are done
+    std::exception_ptr error;
+    auto scan = [&](std::vector<Entry> *run) {
+      Tuple tuple;
+      KeyType key;
+      try {
+        while (true) {
+          TablePage *page;
+          {
+            // the page chain is a linked list, so only the hand off of the next page is serialized
+            std::lock_guard<std::mutex> guard(chain_latch);
+            if (next_page_id == INVALID_PAGE_ID) {
+              break;
+            }
+            page = reinterpret_cast<TablePage *>(bpm_->FetchPage(next_page_id));
+            if (page == nullptr) {
+              throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a table page to build an index");
+            }
+            page->RLatch();
+            next_page_id = page->GetNextPageId();
+          }
+          size_t tuples = 0;
+          RID rid;
+          try {
+            for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+              if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+                key.SetFromKey(tuple.KeyFromTuple(table->schema_, *entry_schema, index->GetEntryAttrs()));
+                run->emplace_back(key, rid);
+                tuples++;
+              }
+            }
+          } catch (...) {
+            page->RUnlatch();
+            bpm_->UnpinPage(page->GetTablePageId(), false);
+            throw;
+          }
+          page->RUnlatch();
+          bpm_->UnpinPage(page->GetTablePageId(), false);
+          std::lock_guard<std::mutex> guard(chain_latch);
+          status->pages_scanned_++;
+          status->tuples_scanned_ += tuples;
+          if (progress) {
+            progress(*status);
+          }
+        }
+        if (finish_run) {
+          finish_run(run);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(chain_latch);
+        if (error == nullptr) {
+          error = std::current_exception();
+        }
+        next_page_id = INVALID_PAGE_ID;
+      }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; i++) {
+      workers.emplace_back(scan, &runs[i]);
+    }
+    scan(&runs[0]);
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    if (error != nullptr) {
+      std::rethrow_exception(error);
+    }
+    return runs;
+  }
+
+  /**
+   * Index the existing tuples of a table. The scan sorts each run of (key, rid) on its worker thread. The runs are
+   * merged pairwise in parallel and the tree is built bottom up from the merged run. Entries are ordered by key, then
+   * by rid, so the result does not depend on which worker scanned which page.
+   */
+  template <class KeyType, class ValueType, class KeyComparator>
+  void BuildIndex(Transaction *txn, BPlusTreeIndex<KeyType, ValueType, KeyComparator> *index, TableMetadata *table,
+                  bool is_unique, const std::function<void(const IndexBuildProgress &)> &progress) {
+    using Entry = std::pair<KeyType, ValueType>;
+    const KeyComparator &comparator = index->GetComparator();
+    auto key_less = [&comparator](const Entry &lhs, const Entry &rhs) {
+      int cmp = comparator(lhs.first, rhs.first);
+      return cmp < 0 || (cmp == 0 && lhs.second.Get() < rhs.second.Get());
+    };
+
+    IndexBuildProgress status{0, 0, false};
+    std::vector<std::vector<Entry>> runs = ScanEntries<KeyType, ValueType>(
+        txn, index, table, &status, progress,
+        [&key_less](std::vector<Entry> *run) { std::sort(run->begin(), run->end(), key_less); });
+    size_t threads = runs.size();
+    std::vector<std::thread> workers;
+
+    // concatenate the runs and merge neighbouring runs, each round halves their number
+    std::vector<Entry> entries;
+    std::vector<size_t> bounds{0};
+    for (auto &run : runs) {
+      entries.insert(entries.end(), run.begin(), run.end());
+      bounds.push_back(entries.size());
+      std::vector<Entry>().swap(run);
+    }
+    for (size_t width = 1; width < threads; width *= 2) {
+      workers.clear();
+      for (size_t i = 0; i + width < threads; i += 2 * width) {
+        auto first = entries.begin() + bounds[i];
+        auto middle = entries.begin() + bounds[i + width];
+        auto last = entries.begin() + bounds[std::min(i + 2 * width, threads)];
+        workers.emplace_back([first, middle, last, &key_less] { std::inplace_merge(first, middle, last, key_less); });
+      }
+      for (auto &worker : workers) {
+        worker.join();
+      }
+    }
+    if (is_unique) {
+      // like Insert, a unique index keeps the first entry of a key: table pages are appended with growing page ids, so
+      // the lowest rid is the first in table order
+      auto key_equal = [&comparator](const Entry &lhs, const Entry &rhs) {
+        return comparator(lhs.first, rhs.first) == 0;
+      };
+      entries.erase(std::unique(entries.begin(), entries.end(), key_equal), entries.end());
+    }
+    [[maybe_unused]] bool loaded = index->BulkLoad(entries);
+    BUSTUB_ASSERT(loaded, "A new index should be empty!");
+    status.done_ = true;
+    if (progress) {
+      progress(status);
+    }
+  }
+
+  /** Index the existing tuples of a table in a hash index, whose BulkInsert may size it for them first. */
+  template <class KeyType, class ValueType, class HashIndex>
+  void BuildHashIndex(Transaction *txn, HashIndex *index,
+                      TableMetadata *table, const std::function<void(const IndexBuildProgress &)> &progress) {
+    using Entry = std::pair<KeyType, ValueType>;
+    IndexBuildProgress status{0, 0, false};
+    std::vector<std::vector<Entry>> runs = ScanEntries<KeyType, ValueType>(txn, index, table, &status, progress, nullptr);
+    std::vector<Entry> entries;
+    for (auto &run : runs) {
+      entries.insert(entries.end(), run.begin(), run.end());
+      std::vector<Entry>().swap(run);
+    }
+    index->BulkInsert(entries);
+    status.done_ = true;
+    if (progress) {
+      progress(status);
+    }
+  }
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
@@ -169,5 +394,9 @@ class Catalog {
   std::unordered_map<std::string, std::unordered_map<std::string, index_oid_t>> index_names_;
   /** The next index identifier to be used */
   std::atomic<index_oid_t> next_index_oid_{0};
+  /** Number of buckets a hash index starts out with, it grows as entries are inserted */
+  static constexpr size_t HASH_INDEX_INITIAL_BUCKETS = 1024;
+  /** Number of threads scanning the table in CreateIndex, 0 for one per hardware thread */
+  size_t index_build_threads_{0};
 };
 }  // namespace bustub
@@ -48,6 +48,19 @@ class ReaderWriterLatch {
     }
   }
 
+  /**
+   * Try to acquire a write latch without blocking.
+   * @return true if the write latch was acquired
+   */
+  bool TryWLock() {
+    std::lock_guard<mutex_t> guard(mutex_);
+    if (writer_entered_ || reader_count_ > 0) {
+      return false;
+    }
+    writer_entered_ = true;
+    return true;
+  }
+
   /**
    * Release a write latch.
    */
@@ -68,6 +81,19 @@ class ReaderWriterLatch {
     reader_count_++;
   }
 
+  /**
+   * Try to acquire a read latch without blocking.
+   * @return true if the read latch was acquired
+   */
+  bool TryRLock() {
+    std::lock_guard<mutex_t> guard(mutex_);
+    if (writer_entered_ || reader_count_ == MAX_READERS) {
+      return false;
+    }
+    reader_count_++;
+    return true;
+  }
+
   /**
    * Release a read latch.
    */
@@ -15,6 +15,7 @@
 #include <atomic>
 #include <deque>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
 #include <unordered_set>
@@ -216,6 +217,13 @@ class Transaction {
    */
   inline void AddIntoDeletedPageSet(page_id_t page_id) { deleted_page_set_->insert(page_id); }
 
+  /**
+   * The workers of a parallel query share its transaction and take their locks from several threads, so the lock sets
+   * are only changed while holding this latch. Reading a lock set directly is only safe once the workers are done.
+   * @return the latch guarding the lock sets
+   */
+  inline std::mutex &GetLockSetLatch() { return lock_set_latch_; }
+
   /** @return the set of resources under a shared lock */
   inline std::shared_ptr<std::unordered_set<RID>> GetSharedLockSet() { return shared_lock_set_; }
 
@@ -223,10 +231,16 @@ class Transaction {
   inline std::shared_ptr<std::unordered_set<RID>> GetExclusiveLockSet() { return exclusive_lock_set_; }
 
   /** @return true if rid is shared locked by this transaction */
-  bool IsSharedLocked(const RID &rid) { return shared_lock_set_->find(rid) != shared_lock_set_->end(); }
+  bool IsSharedLocked(const RID &rid) {
+    std::scoped_lock lock{lock_set_latch_};
+    return shared_lock_set_->find(rid) != shared_lock_set_->end();
+  }
 
   /** @return true if rid is exclusively locked by this transaction */
-  bool IsExclusiveLocked(const RID &rid) { return exclusive_lock_set_->find(rid) != exclusive_lock_set_->end(); }
+  bool IsExclusiveLocked(const RID &rid) {
+    std::scoped_lock lock{lock_set_latch_};
+    return exclusive_lock_set_->find(rid) != exclusive_lock_set_->end();
+  }
 
   /** @return the current state of the transaction */
   inline TransactionState GetState() { return state_; }
@@ -247,8 +261,8 @@ class Transaction {
   inline void SetPrevLSN(lsn_t prev_lsn) { prev_lsn_ = prev_lsn; }
 
  private:
-  /** The current transaction state. */
-  TransactionState state_;
+  /** The current transaction state, set by whichever worker of a parallel query aborts it. */
+  std::atomic<TransactionState> state_;
   /** The isolation level of the transaction. */
   IsolationLevel isolation_level_;
   /** The thread ID, used in single-threaded transactions. */
@@ -268,6 +282,8 @@ class Transaction {
   /** Concurrent index: the page IDs that were deleted during index operation.*/
   std::shared_ptr<std::unordered_set<page_id_t>> deleted_page_set_;
 
+  /** LockManager: guards the lock sets, which the workers of a parallel query change concurrently. */
+  std::mutex lock_set_latch_;
   /** LockManager: the set of shared-locked tuples held by this transaction. */
   std::shared_ptr<std::unordered_set<RID>> shared_lock_set_;
   /** LockManager: the set of exclusive-locked tuples held by this transaction. */
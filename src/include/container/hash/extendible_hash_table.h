@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table.h
+//
+// Identification: src/include/container/hash/extendible_hash_table.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "container/hash/hash_function.h"
+#include "container/hash/hash_table.h"
+#include "storage/page/hash_table_bucket_page.h"
+#include "storage/page/hash_table_directory_page.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+
+#define EXTENDIBLE_HASH_TABLE_TYPE ExtendibleHashTable<KeyType, ValueType, KeyComparator>
+
+/**
+ * Implementation of extendible hash table that is backed by a buffer pool
+ * manager. Non-unique keys are supported. Supports insert and delete. The
+ * table grows by splitting the bucket that is full, doubling the directory
+ * only when that bucket is as deep as the directory, and shrinks by merging
+ * empty buckets into their split images.
+ *
+ * Lookups, inserts and removes take table_latch_ shared and latch the first
+ * page of their bucket, shared or exclusive, so operations on different
+ * buckets never wait for each other. Splits and merges change the directory
+ * and take table_latch_ exclusively.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class ExtendibleHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
+ public:
+  /**
+   * Creates a new ExtendibleHashTable with a single empty bucket
+   *
+   * @param buffer_pool_manager buffer pool manager to be used
+   * @param comparator comparator for keys
+   * @param hash_fn the hash function
+   * @param unique_keys if true, Insert rejects a key that is already present, not only an equal key and value pair
+   */
+  explicit ExtendibleHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
+                               const KeyComparator &comparator, HashFunction<KeyType> hash_fn,
+                               bool unique_keys = false);
+
+  /**
+   * Inserts a key-value pair into the hash table.
+   * @param transaction the current transaction
+   * @param key the key to create
+   * @param value the value to be associated with the key
+   * @return true if insert succeeded, false otherwise
+   */
+  bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Deletes the associated value for the given key.
+   * @param transaction the current transaction
+   * @param key the key to delete
+   * @param value the value to delete
+   * @return true if remove succeeded, false otherwise
+   */
+  bool Remove(Transaction *transaction, const KeyType &key, const ValueType &value) override;
+
+  /**
+   * Performs a point query on the hash table.
+   * @param transaction the current transaction
+   * @param key the key to look up
+   * @param[out] result the value(s) associated with a given key
+   * @return the value(s) associated with the given key
+   */
+  bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth();
+
+  /**
+   * Checks the directory against the buckets: each bucket is pointed to by 2^(GlobalDepth - LocalDepth) slots of
+   * equal local depth, and holds only keys that hash to those slots.
+   * @return true if the table is consistent
+   */
+  bool VerifyIntegrity();
+
+ private:
+  using BucketPage = HashTableBucketPage<KeyType, ValueType, KeyComparator>;
+
+  enum class InsertResult { INSERTED, DUPLICATE, FULL };
+
+  uint32_t Hash(const KeyType &key);
+
+  HashTableDirectoryPage *FetchDirectoryPage();
+
+  BucketPage *FetchBucketPage(page_id_t bucket_page_id);
+
+  // add the entry to the last page of the bucket unless it is a duplicate; if that page is full, with overflow an
+  // overflow page is chained to it, otherwise FULL is returned
+  InsertResult InsertIntoBucket(page_id_t bucket_page_id, const KeyType &key, const ValueType &value, bool overflow);
+
+  // remove the entry from the bucket, filling the hole with the last entry of the bucket
+  bool RemoveFromBucket(page_id_t bucket_page_id, const KeyType &key, const ValueType &value);
+
+  // the entries of all pages of a bucket
+  std::vector<MappingType> ReadBucket(page_id_t bucket_page_id);
+
+  // replace the entries of a bucket, chaining as many overflow pages as they need
+  void RefillBucket(page_id_t bucket_page_id, const std::vector<MappingType> &items);
+
+  // split the bucket of a slot in two, false if no split can separate its keys; needs table_latch_ exclusively
+  bool SplitBucket(HashTableDirectoryPage *directory, uint32_t bucket_idx);
+
+  // insert under table_latch_ exclusively, splitting the bucket of key until the entry fits
+  bool SplitInsert(const KeyType &key, const ValueType &value);
+
+  // merge the empty bucket of key with its split image as far as possible and shrink the directory
+  void Merge(const KeyType &key);
+
+  // member variable
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+
+  // Readers includes inserts and removes, writers are splits and merges
+  ReaderWriterLatch table_latch_;
+
+  // Hash function
+  HashFunction<KeyType> hash_fn_;
+
+  bool unique_keys_;
+};
+
+}  // namespace bustub
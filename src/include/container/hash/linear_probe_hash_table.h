@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <queue>
 #include <string>
 #include <vector>
@@ -32,6 +33,20 @@ namespace bustub {
  * Implementation of linear probing hash table that is backed by a buffer pool
  * manager. Non-unique keys are supported. Supports insert and delete. The
  * table dynamically grows once full.
+ *
+ * A probe walks the occupied_ and readable_ bitmaps of the block pages 64
+ * slots at a time: the end of the probe run is the lowest clear occupied bit,
+ * and only the slots with a readable bit before it have their keys compared.
+ * Each block page is latched while it is walked, shared by GetValue and
+ * exclusive by Insert and Remove, and released before the next one. Inserts
+ * only fill the slot that ends the run, so concurrent inserts of the same key
+ * walk past each other's entries.
+ *
+ * Resizing is incremental: a resize allocates the new table and leaves the
+ * old one in place. Every Insert and Remove after it moves the entries of the
+ * next MIGRATE_BUCKETS buckets of the old table, holding table_latch_
+ * exclusively only for those buckets. Until the old table is empty, lookups
+ * consult both tables and inserts go to the new one.
  */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator> {
@@ -43,9 +58,11 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
    * @param comparator comparator for keys
    * @param num_buckets initial number of buckets contained by this hash table
    * @param hash_fn the hash function
+   * @param unique_keys if true, Insert rejects a key that is already present, not only an equal key and value pair
    */
   explicit LinearProbeHashTable(const std::string &name, BufferPoolManager *buffer_pool_manager,
-                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn);
+                                const KeyComparator &comparator, size_t num_buckets, HashFunction<KeyType> hash_fn,
+                                bool unique_keys = false);
 
   /**
    * Inserts a key-value pair into the hash table.
@@ -75,18 +92,50 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
   bool GetValue(Transaction *transaction, const KeyType &key, std::vector<ValueType> *result) override;
 
   /**
-   * Resizes the table to at least twice the initial size provided.
+   * Resizes the table to at least twice the initial size provided. The entries move to the new table during the
+   * following inserts and removes.
    * @param initial_size the initial size of the hash table
    */
   void Resize(size_t initial_size);
 
   /**
    * Gets the size of the hash table
-   * @return current size of the hash table
+   * @return current size of the hash table, the size it is being resized to during a resize
    */
   size_t GetSize();
 
  private:
+  using BlockPage = HashTableBlockPage<KeyType, ValueType, KeyComparator>;
+
+  // buckets of the old table moved to the new one by each insert or remove during a resize
+  static constexpr size_t MIGRATE_BUCKETS = 64;
+
+  // allocate a header page and enough empty block pages for num_buckets, and make them the table
+  void CreateTable(size_t num_buckets);
+
+  // start moving the entries to a new table of num_buckets buckets, which drops the tombstones; needs table_latch_
+  // exclusively
+  void StartResize(size_t num_buckets);
+
+  // move the entries of the next count buckets of the old table, and free it once it is empty; needs table_latch_
+  // exclusively
+  void MigrateBuckets(size_t count);
+
+  // the share of a resize in progress that an insert or remove does
+  void MigrateStep();
+
+  // make room for an insert into a table of size buckets, false if the table cannot grow any more
+  bool Grow(size_t size);
+
+  /**
+   * Walk the probe run of key, latching one block page at a time. visit(block, slot) is called for the readable
+   * slots of the run in order and ends the walk by returning true. If the walk reaches the never occupied slot that
+   * ends the run, at_end(block, slot) is called while that block is still latched.
+   * @return true if visit ended the walk
+   */
+  template <typename Visit, typename AtEnd>
+  bool Probe(HashTableHeaderPage *header, const KeyType &key, bool exclusive, Visit &&visit, AtEnd &&at_end);
+
   // member variable
   page_id_t header_page_id_;
   BufferPoolManager *buffer_pool_manager_;
@@ -97,6 +146,17 @@ class LinearProbeHashTable : public HashTable<KeyType, ValueType, KeyComparator>
 
   // Hash function
   HashFunction<KeyType> hash_fn_;
+
+  bool unique_keys_;
+  // slots of the (new) table holding an entry or a tombstone, and entries in both tables
+  std::atomic<size_t> occupied_count_{0};
+  std::atomic<size_t> entry_count_{0};
+
+  // during a resize the table the entries move out of, INVALID_PAGE_ID otherwise
+  page_id_t old_header_page_id_{INVALID_PAGE_ID};
+  // the buckets of the old table before this one are empty
+  size_t migrate_cursor_{0};
+  std::atomic<bool> migrating_{false};
 };
 
 }  // namespace bustub
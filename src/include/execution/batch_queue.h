@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_queue.h
+//
+// Identification: src/include/execution/batch_queue.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "common/macros.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * BatchQueue is a bounded lock-free queue of tuple batches for any number of producer and consumer threads. Every slot
+ * has a sequence number that tells whether it is free for the push of a given turn or holds the batch of that turn,
+ * so a thread only claims a position with a compare-and-swap and never waits for a lock.
+ *
+ * Batches are swapped in and out of the slots rather than copied: a push leaves the batch of an earlier turn behind,
+ * so that the column vectors are allocated once per slot and reused by the threads.
+ */
+class BatchQueue {
+ public:
+  /** @param capacity the number of batches the queue holds, rounded up to a power of two */
+  explicit BatchQueue(size_t capacity);
+
+  DISALLOW_COPY_AND_MOVE(BatchQueue);
+
+  /**
+   * Push a batch unless the queue is full.
+   * @param[in,out] batch the batch to push, swapped with a stale batch whose contents are undefined
+   * @return false if the queue is full
+   */
+  bool TryPush(TupleBatch *batch);
+
+  /**
+   * Pop the oldest batch unless the queue is empty.
+   * @param[in,out] batch the popped batch, its former contents are left in the queue to be overwritten
+   * @return false if the queue is empty
+   */
+  bool TryPop(TupleBatch *batch);
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence_;
+    TupleBatch batch_;
+  };
+
+  /** keep the positions that producers and consumers update on their own cache lines */
+  static constexpr size_t CACHE_LINE_SIZE = 64;
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_;
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> push_pos_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<size_t> pop_pos_{0};
+};
+
+}  // namespace bustub
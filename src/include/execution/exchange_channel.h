@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_channel.h
+//
+// Identification: src/include/execution/exchange_channel.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "execution/batch_queue.h"
+
+namespace bustub {
+
+/**
+ * ExchangeChannel carries the batches of an exchange from its producer threads to its consumers, with one bounded
+ * queue per consumer. Producers wait while the queue they push to is full and consumers while theirs is empty. A
+ * waiting thread yields a few times, then parks on a condition variable until a push, pop, close or cancel changes
+ * the channel, so that the threads the worker pool keeps starting do not spin. A consumer sees the end of its queue
+ * once every producer is done. A producer that fails cancels the channel and its exception is rethrown to the
+ * consumers.
+ */
+class ExchangeChannel {
+ public:
+  /** The batches each queue holds, enough to keep producers busy while the consumer works on one. */
+  static constexpr size_t QUEUE_CAPACITY = 8;
+  /** The times a waiting thread yields before it parks, a queue is usually refilled or drained by then. */
+  static constexpr uint32_t SPIN_COUNT = 16;
+
+  /**
+   * @param queue_count the number of consumers
+   * @param producer_count the number of producers that will call FinishProducer()
+   */
+  ExchangeChannel(uint32_t queue_count, uint32_t producer_count);
+
+  DISALLOW_COPY_AND_MOVE(ExchangeChannel);
+
+  ~ExchangeChannel() { Cancel(); }
+
+  /** @return the number of consumer queues */
+  uint32_t GetQueueCount() const { return static_cast<uint32_t>(queues_.size()); }
+
+  /** @return true for the one caller that is to start the producers, false for everyone else */
+  bool MarkStarted() { return !started_.exchange(true); }
+
+  /**
+   * Push a batch to a consumer, waiting while its queue is full. The batch is dropped if the consumer is closed.
+   * @param[in,out] batch the batch, swapped with a stale one that the producer resets
+   * @return false if the producers should stop because the channel is cancelled or every consumer is closed
+   */
+  bool Push(uint32_t queue, TupleBatch *batch);
+
+  /**
+   * Pop the next batch of a consumer, waiting while its queue is empty and producers are still running.
+   * @return false once every producer is done and the queue is empty
+   * @throws the exception of a failed producer
+   */
+  bool Pop(uint32_t queue, TupleBatch *batch);
+
+  /** @return true if the producers should stop */
+  bool IsCancelled() const {
+    return cancelled_.load(std::memory_order_acquire) || open_queues_.load(std::memory_order_acquire) == 0;
+  }
+
+  /** Called by every producer once it is done, with the exception that stopped it if any. */
+  void FinishProducer(std::exception_ptr error);
+
+  /** Called by a consumer that reads no more batches, so that producers drop the batches for it. */
+  void Close(uint32_t queue);
+
+  /** Stop the producers and wait until all of them are done. */
+  void Cancel();
+
+ private:
+  /** Count a change of the channel and wake the parked threads. */
+  void Signal();
+
+  /**
+   * Wait for a change of the channel after the count of changes was seen, yielding for the first attempts.
+   * @param seen the count of changes read before the failed attempt
+   * @param attempt the number of failed attempts before this one
+   */
+  void Wait(uint64_t seen, uint32_t attempt);
+
+  std::vector<std::unique_ptr<BatchQueue>> queues_;
+  std::unique_ptr<std::atomic<bool>[]> closed_;
+  std::atomic<uint32_t> open_queues_;
+  std::atomic<uint32_t> running_producers_;
+  std::atomic<bool> started_{false};
+  std::atomic<bool> cancelled_{false};
+  /** guards error_ and is taken to wait for the producers in Cancel() and for changes in Wait() */
+  std::mutex latch_;
+  std::condition_variable producers_done_;
+  /** the count of pushes, pops and other changes, a parked thread wakes once it moved */
+  std::atomic<uint64_t> changes_{0};
+  /** the threads parked on changed_, a change only takes latch_ to notify them if there are any */
+  std::atomic<uint32_t> parked_{0};
+  std::condition_variable changed_;
+  std::exception_ptr error_;
+};
+
+}  // namespace bustub
@@ -20,6 +20,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/query_worker_pool.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 class ExecutionEngine {
@@ -31,19 +32,25 @@ class ExecutionEngine {
 
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
+    // the exchanges of the plan run their producers on the engine's threads
+    if (exec_ctx->GetWorkerPool() == nullptr) {
+      exec_ctx->SetWorkerPool(&worker_pool_);
+    }
+
     // construct executor
     auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
     // prepare
     executor->Init();
 
-    // execute
+    // execute, a batch of tuples per call
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+      TupleBatch batch;
+      const Schema *schema = executor->GetOutputSchema();
+      while (executor->NextBatch(&batch)) {
+        // inserts, updates and deletes have no output schema, their rows are only counted in the batch
+        for (uint32_t i = 0; result_set != nullptr && schema != nullptr && i < batch.Size(); i++) {
+          result_set->push_back(batch.GetTuple(batch.SelectedRow(i), schema));
         }
       }
     } catch (Exception &e) {
@@ -57,6 +64,7 @@ class ExecutionEngine {
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] TransactionManager *txn_mgr_;
   [[maybe_unused]] Catalog *catalog_;
+  QueryWorkerPool worker_pool_;
 };
 
 }  // namespace bustub
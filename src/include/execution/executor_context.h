@@ -12,12 +12,15 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
 #include "concurrency/transaction.h"
+#include "execution/query_worker_pool.h"
+#include "execution/worker_group.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
@@ -60,12 +63,33 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** Run the parallel parts of the query on the threads of a pool. */
+  void SetWorkerPool(QueryWorkerPool *worker_pool) { worker_pool_ = worker_pool; }
+
+  /** @return the pool that runs the producers of exchanges */
+  QueryWorkerPool *GetWorkerPool() { return worker_pool_; }
+
+  /** Make the executors of this context one of the copies of a subtree that run on the threads of a worker group. */
+  void SetWorkerGroup(std::shared_ptr<WorkerGroup> worker_group, uint32_t worker_index) {
+    worker_group_ = std::move(worker_group);
+    worker_index_ = worker_index;
+  }
+
+  /** @return the group whose state the executors share with the other copies, nullptr if there is one copy only */
+  WorkerGroup *GetWorkerGroup() { return worker_group_.get(); }
+
+  /** @return the index of the copy in its worker group */
+  uint32_t GetWorkerIndex() const { return worker_index_; }
+
  private:
   Transaction *transaction_;
   Catalog *catalog_;
   BufferPoolManager *bpm_;
   TransactionManager *txn_mgr_;
   LockManager *lock_mgr_;
+  QueryWorkerPool *worker_pool_{nullptr};
+  std::shared_ptr<WorkerGroup> worker_group_;
+  uint32_t worker_index_{0};
 };
 
 }  // namespace bustub
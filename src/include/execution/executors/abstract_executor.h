@@ -13,11 +13,13 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
+ * AbstractExecutor implements the Volcano iterator model, either a tuple at a time with Next() or a batch at a time
+ * with NextBatch(). An executor may be driven by one of the two only.
  */
 class AbstractExecutor {
  public:
@@ -44,6 +46,23 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Produces the next batch of tuples from this executor. Executors that do not work on batches yet are adapted by
+   * calling Next() until the batch is full.
+   * @param[out] batch the next tuples, in the columns of GetOutputSchema()
+   * @return true if at least one tuple was produced, false if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    const Schema *schema = GetOutputSchema();
+    batch->Reset(schema == nullptr ? 0 : schema->GetColumnCount());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, schema, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return the schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
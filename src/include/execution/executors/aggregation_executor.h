@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -91,18 +92,70 @@ class SimpleAggregationHashTable {
     }
   }
 
+  /** Combines a partial aggregation result, computed over other tuples with the same key, into the result. */
+  void MergeAggregateValues(AggregateValue *result, const AggregateValue &partial) {
+    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
+      switch (agg_types_[i]) {
+        case AggregationType::CountAggregate:
+        case AggregationType::SumAggregate:
+          // Counts and sums of both parts add up.
+          result->aggregates_[i] = result->aggregates_[i].Add(partial.aggregates_[i]);
+          break;
+        case AggregationType::MinAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Min(partial.aggregates_[i]);
+          break;
+        case AggregationType::MaxAggregate:
+          result->aggregates_[i] = result->aggregates_[i].Max(partial.aggregates_[i]);
+          break;
+      }
+    }
+  }
+
   /**
    * Inserts a value into the hash table and then combines it with the current aggregation.
    * @param agg_key the key to be inserted
    * @param agg_val the value to be inserted
    */
   void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht.count(agg_key) == 0) {
-      ht.insert({agg_key, GenerateInitialAggregateValue()});
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      iter = ht.insert({agg_key, GenerateInitialAggregateValue()}).first;
     }
-    CombineAggregateValues(&ht[agg_key], agg_val);
+    CombineAggregateValues(&iter->second, agg_val);
   }
 
+  /**
+   * Inserts the partial aggregation result of a key into the hash table and then merges it with the current one.
+   * @param agg_key the key to be inserted
+   * @param partial the partial result to be merged
+   */
+  void InsertMerge(const AggregateKey &agg_key, const AggregateValue &partial) {
+    auto iter = ht.find(agg_key);
+    if (iter == ht.end()) {
+      ht.insert({agg_key, partial});
+      return;
+    }
+    MergeAggregateValues(&iter->second, partial);
+  }
+
+  /** Merges the partial results of another table over the same aggregations into this one and empties it. */
+  void Merge(SimpleAggregationHashTable *other) {
+    if (ht.empty()) {
+      ht.swap(other->ht);
+      return;
+    }
+    for (const auto &[key, partial] : other->ht) {
+      InsertMerge(key, partial);
+    }
+    other->Clear();
+  }
+
+  /** @return the number of groups */
+  size_t Size() const { return ht.size(); }
+
+  /** Removes every group. */
+  void Clear() { ht.clear(); }
+
   /**
    * An iterator through the simplified aggregation hash table.
    */
@@ -151,6 +204,13 @@ class SimpleAggregationHashTable {
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX) on the tuples of a child executor.
+ *
+ * The groups are radix partitioned by the hash of their keys. With a parallelism above one, every thread of the worker
+ * pool runs its own copy of the child in a worker group, so that the scans of the copies read a part of each table,
+ * and pre-aggregates its tuples into thread-local tables, one per partition. The threads then merge the partitions of
+ * all local tables, each partition on one thread. A thread whose local tables hold more than its share of the memory
+ * budget spills its largest partition to temporary pages as partial aggregates. A partition spilled by any thread is
+ * merged with its pages once the output reaches it, so only one of them is in memory at a time.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -163,6 +223,8 @@ class AggregationExecutor : public AbstractExecutor {
   AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                       std::unique_ptr<AbstractExecutor> &&child);
 
+  ~AggregationExecutor() override;
+
   /** Do not use or remove this function, otherwise you will get zero points. */
   const AbstractExecutor *GetChildExecutor() const;
 
@@ -172,6 +234,11 @@ class AggregationExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of partitions that were spilled to pages by the last Init() */
+  size_t GetSpilledPartitionCount() const;
+
   /** @return the tuple as an AggregateKey */
   AggregateKey MakeKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -191,13 +258,56 @@ class AggregationExecutor : public AbstractExecutor {
   }
 
  private:
+  /** The number of radix partitions, selected by the low bits of the hash of a key. */
+  static constexpr uint32_t PARTITION_COUNT = 16;
+  /** The bytes a group takes besides its values, for its node and bucket in the hash table. */
+  static constexpr size_t GROUP_OVERHEAD = 64;
+
+  /** The pre-aggregation of one thread. */
+  struct LocalAggregation {
+    /** the partial results, one table per partition */
+    std::vector<SimpleAggregationHashTable> partitions_;
+    /** the pages each partition was spilled to */
+    std::vector<std::vector<page_id_t>> spilled_pages_;
+    size_t bytes_{0};
+  };
+
+  /** Run work(0) on this thread and work(1) to work(workers - 1) on the worker pool, and wait for all of them. */
+  void RunWorkers(uint32_t workers, const std::function<void(uint32_t)> &work);
+
+  /** Pre-aggregate the tuples of a child into a local aggregation, holding at most budget bytes of groups. */
+  void Aggregate(AbstractExecutor *child, LocalAggregation *local, size_t budget);
+
+  /** Write the groups of a local partition to pages, as tuples of the partial schema, and empty it. */
+  void SpillPartition(LocalAggregation *local, uint32_t partition);
+
+  /** Merge the local tables and the spilled pages of a partition into its final table. */
+  void MergePartition(uint32_t partition);
+
+  /** Move the iterator to the next group, across partitions. @return false if there are no more groups */
+  bool SeekGroup();
+
+  /** Delete the spilled pages that were not merged. */
+  void DropSpilledPages();
+
+  size_t GroupBytes() const {
+    return GROUP_OVERHEAD + (plan_->GetGroupBys().size() + plan_->GetAggregates().size()) * sizeof(Value);
+  }
+
   /** The aggregation plan node. */
   const AggregationPlanNode *plan_;
   /** The child executor whose tuples we are aggregating. */
   std::unique_ptr<AbstractExecutor> child_;
-  /** Simple aggregation hash table. */
-  SimpleAggregationHashTable aht_;
-  /** Simple aggregation hash table iterator. */
+  /** The schema of spilled groups: their keys followed by their partial aggregates. */
+  std::unique_ptr<Schema> partial_schema_;
+  /** The pre-aggregations of the threads. */
+  std::vector<LocalAggregation> locals_;
+  /** The final aggregation hash tables, one per partition. */
+  std::vector<SimpleAggregationHashTable> partitions_;
+  /** Whether a thread spilled a partition, such a partition is merged once the output reaches it. */
+  std::vector<bool> spilled_;
+  uint32_t partition_cursor_{0};
+  /** Simple aggregation hash table iterator, over the table of partition_cursor_. */
   SimpleAggregationHashTable::Iterator aht_iterator_;
 };
 }  // namespace bustub
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.h
+//
+// Identification: src/include/execution/executors/exchange_executor.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "execution/exchange_channel.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/exchange_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * ExchangeExecutor is a consumer of an exchange. Init() submits the producers to the worker pool of the context: each
+ * runs its own copy of the child executors, in a worker group of the producers, and pushes the batches of its copy to
+ * the exchange channel. The consumer pops the batches of its queue, which is the only queue unless the context is a
+ * copy in a worker group itself. In that case all copies share the channel of the group and the first one to be
+ * initialized starts the producers.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new exchange executor.
+   * @param exec_ctx the executor context, which must have a worker pool
+   * @param plan the exchange plan to be executed
+   */
+  ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan);
+
+  /** Stops reading the channel, and stops the producers if no one else reads it. */
+  ~ExchangeExecutor() override { Stop(); }
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+ private:
+  /** Run a producer's copy of the child and push its batches to the channel. */
+  static void Produce(const ExchangePlanNode *plan, AbstractExecutor *child, ExchangeChannel *channel);
+
+  void Stop();
+
+  /** The exchange plan node to be executed. */
+  const ExchangePlanNode *plan_;
+  std::shared_ptr<ExchangeChannel> channel_;
+  /** the queue of the channel this consumer reads */
+  uint32_t queue_{0};
+  /** true if the channel is this consumer's alone, rather than shared through the worker group */
+  bool owns_channel_{false};
+  /** the batch whose rows Next() returns */
+  TupleBatch row_batch_;
+  uint32_t row_cursor_{0};
+};
+}  // namespace bustub
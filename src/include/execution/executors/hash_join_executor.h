@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_executor.h
+//
+// Identification: src/include/execution/executors/hash_join_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/hash_join_plan.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * HashJoinExecutor joins two children on equal keys with an in-memory hash table.
+ * Init reads both children a batch at a time in turns, the child that runs out first is the smaller one and the
+ * hash table is built on it. The other child probes the table, starting with the batches already read.
+ *
+ * If the tuples read exceed the memory budget of the plan before a child runs out, the join turns into a grace hash
+ * join: both children are partitioned by the hash of their keys into TmpTuplePages, and every pair of partitions is
+ * joined on its own, with the table built on the smaller side. A pair that is still too large is partitioned again
+ * with another hash, up to MAX_PARTITION_LEVEL times.
+ */
+class HashJoinExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new hash join executor.
+   * @param exec_ctx the executor context
+   * @param plan the hash join plan to be executed
+   * @param left_executor the child executor that produces tuple for the left side of join
+   * @param right_executor the child executor that produces tuple for the right side of join
+   */
+  HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
+                   std::unique_ptr<AbstractExecutor> &&left_executor,
+                   std::unique_ptr<AbstractExecutor> &&right_executor);
+
+  ~HashJoinExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return the number of partition pairs spilled so far, 0 if the join ran in memory */
+  size_t GetPartitionCount() const { return partition_count_; }
+
+  /** the number of partitions a partitioning pass splits its input into */
+  static constexpr uint32_t PARTITION_FANOUT = 8;
+  /** the number of times a partition is partitioned again at most, after that it is joined whatever its size */
+  static constexpr uint32_t MAX_PARTITION_LEVEL = 3;
+
+ private:
+  /** The tuples of both children whose keys hash to the same partition, spilled to TmpTuplePages. */
+  struct Partition {
+    /** the pages and the size of the tuples, [0] of the left child and [1] of the right child */
+    std::vector<page_id_t> pages_[2];
+    size_t bytes_[2]{0, 0};
+    /** the number of partitioning passes the tuples went through */
+    uint32_t level_{0};
+  };
+
+  /** @return the memory a tuple takes in the join */
+  static size_t TupleBytes(const Tuple &tuple) { return sizeof(Tuple) + tuple.GetLength(); }
+
+  /**
+   * Read a batch of a child and append its tuples and their join keys.
+   * @return false if the child is exhausted
+   */
+  bool ReadBatch(AbstractExecutor *executor, const std::vector<const AbstractExpression *> &key_exprs,
+                 std::vector<Tuple> *tuples, std::vector<HashJoinKey> *keys);
+
+  /** Insert the tuples into the hash table, which is built on the left side if build_left_ */
+  void Build(std::vector<Tuple> *tuples, std::vector<HashJoinKey> *keys);
+
+  /**
+   * Partition the tuples read so far and the rest of both children.
+   * @param tuples the tuples read, [0] of the left child and [1] of the right child
+   * @param keys the join keys of the tuples read
+   */
+  void SpillInputs(std::vector<Tuple> tuples[2], std::vector<HashJoinKey> keys[2]);
+
+  /**
+   * Write a tuple to its partition.
+   * @param partitions the partitions of this pass, all at the same level
+   * @param pages the page each partition side is filling, indexed by side * PARTITION_FANOUT + partition
+   * @param side 0 for a left tuple and 1 for a right tuple
+   */
+  void SpillTuple(std::vector<Partition> *partitions, std::vector<TmpTuplePage *> *pages, uint32_t side,
+                  const Tuple &tuple, const HashJoinKey &key);
+
+  /** Unpin the pages of a partitioning pass and queue its non empty partitions. */
+  void FinishPass(std::vector<Partition> *partitions, std::vector<TmpTuplePage *> *pages);
+
+  /** Read the tuples of a spilled page and their join keys, and delete the page. */
+  void ReadPage(page_id_t page_id, uint32_t side, std::vector<Tuple> *tuples, std::vector<HashJoinKey> *keys);
+
+  /** Build the hash table on the next pending partition, false once none is left. */
+  bool NextPartition();
+
+  /** Delete spilled pages that are not read. */
+  void DeletePages(const std::vector<page_id_t> &page_ids);
+
+  /** Delete the pages of the partitions not joined yet. */
+  void DropPartitions();
+
+  /** Read the next probe tuples, from the probe child or from the probe side of the current partition. */
+  bool ReadProbe();
+
+  /** Advance to the next (probe, build) pair with equal keys that satisfies the predicate, false once done. */
+  bool NextMatch();
+
+  /** @return the left tuple of the pair last matched */
+  const Tuple &LeftTuple() const;
+
+  /** @return the right tuple of the pair last matched */
+  const Tuple &RightTuple() const;
+
+  /** The hash join plan node to be executed. */
+  const HashJoinPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** true if the hash table holds the left tuples and the right side probes it */
+  bool build_left_{true};
+  std::unordered_map<HashJoinKey, std::vector<Tuple>> hash_table_;
+  /** the probe tuples read but not yet done, with their join keys */
+  std::vector<Tuple> probe_tuples_;
+  std::vector<HashJoinKey> probe_keys_;
+  /** the pair last matched is probe_tuples_[probe_cursor_] and (*matches_)[match_cursor_ - 1] */
+  size_t probe_cursor_{0};
+  const std::vector<Tuple> *matches_{nullptr};
+  size_t match_cursor_{0};
+  /** true once the inputs are partitioned, the probe tuples then come from probe_pages_ */
+  bool spilled_{false};
+  std::vector<Partition> partitions_;
+  std::vector<page_id_t> probe_pages_;
+  size_t partition_count_{0};
+};
+}  // namespace bustub
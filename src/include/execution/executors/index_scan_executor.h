@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "common/rid.h"
@@ -24,6 +25,7 @@ namespace bustub {
 
 /**
  * IndexScanExecutor executes an index scan over a table.
+ * A hash index is only probed for an equality on its whole key, other scans of it fall back to reading the table.
  */
 
 class IndexScanExecutor : public AbstractExecutor {
@@ -33,8 +35,6 @@ class IndexScanExecutor : public AbstractExecutor {
    * @param exec_ctx the executor context
    * @param plan the index scan plan to be executed
    */
-  using BPlusTreeIndexType =  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
-  using IndexIteratorType = IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
   IndexScanExecutor(ExecutorContext *exec_ctx, const IndexScanPlanNode *plan);
 
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
@@ -44,13 +44,43 @@ class IndexScanExecutor : public AbstractExecutor {
   bool Next(Tuple *tuple, RID *rid) override;
 
  private:
+  /**
+   * Derive index key bounds from a predicate of the form "leading key column <op> constant".
+   * Bounds stay nullptr when the predicate does not restrict the leading key column.
+   */
+  void DeriveScanRange(std::unique_ptr<Tuple> *low_key, bool *low_inclusive, std::unique_ptr<Tuple> *high_key,
+                       bool *high_inclusive);
+
+  /**
+   * Build a bound key with the given leading column value. The other key columns get their min values, which only
+   * place the start of the scan; the bound itself is compared on the leading column alone.
+   */
+  std::unique_ptr<Tuple> MakeBoundKey(const Value &value);
+
+  /** @return true if every column the expression reads is stored in the index entries */
+  bool IsCovered(const AbstractExpression *expr) const;
+
+  /** Rebuild a table row from an index entry, the columns the entry does not store are null. */
+  Tuple RowFromEntry(const Tuple &entry) const;
+
   /** The index scan plan node to be executed. */
   const IndexScanPlanNode *plan_;
   IndexInfo* index_info_;
-  BPlusTreeIndexType* index_;
+  Index* index_;
   TableHeap* table_heap_;
   TableMetadata* table_info_;
-  IndexIteratorType iter_;
+  /** RIDs of the entries within the derived key range, in key order */
+  std::vector<RID> rids_;
+  size_t cursor_{0};
+  /** true when the predicate and the output only read key or included columns, the table heap is then skipped */
+  bool index_only_{false};
+  /** the stored entry of each RID in rids_, only filled for index-only scans */
+  std::vector<Tuple> entries_;
+  /** for each table column, its position in the index entries or -1 */
+  std::vector<int> entry_column_of_;
+  /** true when a hash index cannot answer the predicate, the table is then read with iter_ and filtered */
+  bool full_scan_{false};
+  TableIterator iter_;
 
 };
 }  // namespace bustub
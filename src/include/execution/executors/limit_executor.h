@@ -44,5 +44,7 @@ class LimitExecutor : public AbstractExecutor {
   const LimitPlanNode *plan_;
   /** The child executor to obtain value from. */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The number of tuples returned so far. */
+  size_t returned_{0};
 };
 }  // namespace bustub
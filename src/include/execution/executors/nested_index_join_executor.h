@@ -49,12 +49,31 @@ class NestIndexJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
+  /** Pull the next batch of outer tuples and probe the index for all of them, false if the outer side is done. */
+  bool FetchOuterBatch();
+
+  /** Advance to the next inner tuple that joins with outer_tuples_[outer_cursor_], false if the outer side is done. */
+  bool NextMatch(Tuple *right_tuple, RID *rid);
+
+  /**
+   * Build the index key an outer tuple probes with. An equality predicate between the leading key column of the
+   * inner table and an expression over the outer tuple gives the key; otherwise the outer tuple is the key itself.
+   */
+  Tuple MakeProbeKey(const Tuple &outer_tuple);
+
   /** The nested index join plan node. */
   const NestedIndexJoinPlanNode *plan_;
   TableMetadata *table_info_;
   IndexInfo *index_info_;
-  std::vector<RID> rids_;
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** the current batch of outer tuples and the inner RIDs matching each of them */
+  TupleBatch outer_batch_;
+  std::vector<Tuple> outer_tuples_;
+  std::vector<std::vector<RID>> matches_;
+  size_t outer_cursor_{0};
+  size_t match_cursor_{0};
 };
 }  // namespace bustub
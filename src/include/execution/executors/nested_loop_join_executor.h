@@ -14,6 +14,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
@@ -24,6 +25,7 @@ namespace bustub {
 /**
  * NestedLoopJoinExecutor joins two tables using nested loop.
  * The child executor can either be a sequential scan
+ * The right child is read into memory once, the left child is read a batch at a time.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -47,10 +49,22 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
  private:
+  /** Advance to the next (left, right) pair that satisfies the predicate, false once the left side is done. */
+  bool NextMatch();
+
   /** The NestedLoop plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> left_executor_;
   std::unique_ptr<AbstractExecutor> right_executor_;
+  std::vector<Tuple> right_tuples_;
+  /** the current batch of the left side, with its rows as tuples */
+  TupleBatch left_batch_;
+  std::vector<Tuple> left_tuples_;
+  /** the pair last matched is left_tuples_[left_cursor_] and right_tuples_[right_cursor_ - 1] */
+  size_t left_cursor_{0};
+  size_t right_cursor_{0};
 };
 }  // namespace bustub
@@ -12,10 +12,13 @@
 
 #pragma once
 
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_dispenser.h"
 #include "execution/plans/seq_scan_plan.h"
 #include "storage/table/tuple.h"
 
@@ -23,6 +26,8 @@ namespace bustub {
 
 /**
  * SeqScanExecutor executes a sequential scan over a table.
+ * If the executor context is part of a worker group, the scan only reads the morsels it claims from the
+ * dispenser of its plan node, and the scans of all threads together read every page once.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -37,6 +42,8 @@ class SeqScanExecutor : public AbstractExecutor {
 
   bool Next(Tuple *tuple, RID *rid) override;
 
+  bool NextBatch(TupleBatch *batch) override;
+
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
 
@@ -46,5 +53,17 @@ class SeqScanExecutor : public AbstractExecutor {
   TableIterator iter_;
   TableHeap* table_heap_;
   TableMetadata* table_info_;
+  /** the table tuples of the current batch, before the predicate and the output expressions */
+  TupleBatch scan_batch_;
+  /** Read the tuples of the pages of claimed morsels into scan_batch_, up to a batch of them. */
+  void ScanMorsels();
+  /** the dispenser the pages are claimed from, nullptr if the whole table is scanned with iter_ */
+  std::shared_ptr<MorselDispenser> dispenser_;
+  /** the morsel being scanned, the pages before morsel_cursor_ are read */
+  std::vector<page_id_t> morsel_;
+  size_t morsel_cursor_{0};
+  /** the output batch whose rows Next() returns when pages are claimed */
+  TupleBatch row_batch_;
+  uint32_t row_cursor_{0};
 };
 }  // namespace bustub
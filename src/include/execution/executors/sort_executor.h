@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/loser_tree.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/sort_key.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * SortExecutor is an external merge sort. The tuples of the child are sorted in memory by their normalized sort keys
+ * while they fit the memory budget of the plan. Past that, every budget worth of tuples is sorted and spilled as a run
+ * to TmpTuplePages, and the runs are merged with a loser tree. Each run being merged holds one page of tuples in
+ * memory, so when there are more runs than the budget has pages they are first merged into fewer, longer runs.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new sort executor.
+   * @param exec_ctx the executor context
+   * @param plan the sort plan to be executed
+   * @param child_executor the child executor that produces the tuples to be sorted
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  ~SortExecutor() override;
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return the number of sorted runs spilled, 0 if the sort ran in memory */
+  size_t GetRunCount() const { return run_count_; }
+
+ private:
+  /** A tuple of the child with its normalized sort key. */
+  struct SortEntry {
+    std::string key_;
+    Tuple tuple_;
+  };
+
+  /** A sorted run spilled to pages, read back a page at a time. */
+  struct Run {
+    /** the pages of the run in order, the ones before next_page_ are read and deleted */
+    std::vector<page_id_t> pages_;
+    size_t next_page_{0};
+    /** the tuples of the page being read, the head of the run is entries_[cursor_] */
+    std::vector<SortEntry> entries_;
+    size_t cursor_{0};
+
+    bool IsExhausted() const { return cursor_ == entries_.size(); }
+    const SortEntry &Head() const { return entries_[cursor_]; }
+  };
+
+  /** Orders the runs being merged by their heads, an exhausted run is larger than all others. */
+  struct RunLess {
+    const std::vector<Run> *runs_;
+    bool operator()(size_t a, size_t b) const {
+      const Run &run_a = (*runs_)[a];
+      const Run &run_b = (*runs_)[b];
+      if (run_a.IsExhausted() || run_b.IsExhausted()) {
+        return !run_a.IsExhausted() && run_b.IsExhausted();
+      }
+      return run_a.Head().key_ < run_b.Head().key_;
+    }
+  };
+
+  /** Sort the tuples in memory by their keys into sorted_. */
+  void SortEntries();
+
+  /** Sort the tuples in memory and spill them as a run. */
+  void SpillRun();
+
+  /** Append a tuple to the run being written, whose last page is *page. */
+  void AppendToRun(std::vector<page_id_t> *pages, TmpTuplePage **page, const Tuple &tuple);
+
+  /** Unpin the last page of a run being written. */
+  void FinishRun(TmpTuplePage *page);
+
+  /** Read the next page of a run into its entries and delete it, false if the run has no page left. */
+  bool LoadPage(Run *run);
+
+  /** Start merging the given runs. */
+  void StartMerge(std::vector<std::vector<page_id_t>> &&runs);
+
+  /** @return the smallest head of the runs being merged, nullptr once they are exhausted */
+  const SortEntry *MergeTop() const;
+
+  /** Advance past the smallest head of the runs being merged. */
+  void MergePop();
+
+  /** Delete the pages of all runs not read yet. */
+  void DropRuns();
+
+  /** The sort plan node to be executed. */
+  const SortPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder encoder_;
+  /** the tuples read and not spilled, output in the order of sorted_ if nothing was spilled */
+  std::vector<SortEntry> entries_;
+  std::vector<uint32_t> sorted_;
+  size_t cursor_{0};
+  /** the runs spilled and not merged yet */
+  std::vector<std::vector<page_id_t>> runs_;
+  size_t run_count_{0};
+  /** the runs being merged and the loser tree over their heads */
+  std::vector<Run> merge_runs_;
+  std::unique_ptr<LoserTree<RunLess>> merge_tree_;
+};
+}  // namespace bustub
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/topn_plan.h"
+#include "execution/sort_key.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+/**
+ * TopNExecutor keeps the limit + offset smallest tuples of its child in a max-heap ordered by their normalized sort
+ * keys, in O(n log N) time and O(N) memory for N = limit + offset. Once the heap is full, a tuple whose key is not below
+ * the largest key in the heap is dropped after a single key comparison, without being materialized.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Creates a new top-n executor.
+   * @param exec_ctx the executor context
+   * @param plan the top-n plan to be executed
+   * @param child_executor the child executor that produces the tuples to be sorted
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  void Init() override;
+
+  bool Next(Tuple *tuple, RID *rid) override;
+
+ private:
+  /** A tuple of the child with its normalized sort key and its position in the child's output. */
+  struct TopNEntry {
+    std::string key_;
+    size_t seq_;
+    Tuple tuple_;
+  };
+
+  /** @return true if entry a orders before entry b, equal keys order by their position in the child's output */
+  bool EntryLess(uint32_t a, uint32_t b) const;
+
+  /** The top-n plan node to be executed. */
+  const TopNPlanNode *plan_;
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  SortKeyEncoder encoder_;
+  /** the tuples kept, heap_ is a max-heap of their indexes until Init sorts it */
+  std::vector<TopNEntry> entries_;
+  std::vector<uint32_t> heap_;
+  size_t cursor_{0};
+};
+}  // namespace bustub
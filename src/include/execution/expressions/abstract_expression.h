@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,22 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /**
+   * Evaluates the expression for every selected row of a batch. The default materializes each row as a tuple, the
+   * common expressions override it to work on the columns directly.
+   * @param batch the batch, whose columns follow schema
+   * @param schema the schema of the batch rows
+   * @param[out] result receives one value per selected row, in selection order
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const {
+    result->clear();
+    result->reserve(batch.Size());
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      Tuple tuple = batch.GetTuple(batch.SelectedRow(i), schema);
+      result->push_back(Evaluate(&tuple, schema));
+    }
+  }
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
@@ -45,6 +45,15 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const override {
+    const std::vector<Value> &column = batch.GetColumn(col_idx_);
+    result->clear();
+    result->reserve(batch.Size());
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      result->push_back(column[batch.SelectedRow(i)]);
+    }
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
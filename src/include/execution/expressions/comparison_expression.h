@@ -34,6 +34,9 @@ class ComparisonExpression : public AbstractExpression {
   ComparisonExpression(const AbstractExpression *left, const AbstractExpression *right, ComparisonType comp_type)
       : AbstractExpression({left, right}, TypeId::BOOLEAN), comp_type_{comp_type} {}
 
+  /** @return the type of comparison performed by this expression */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
   Value Evaluate(const Tuple *tuple, const Schema *schema) const override {
     Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
     Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
@@ -53,6 +56,18 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateBatch(batch, schema, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, schema, &rhs);
+    result->clear();
+    result->reserve(batch.Size());
+    for (uint32_t i = 0; i < batch.Size(); i++) {
+      result->push_back(ValueFactory::GetBooleanValue(PerformComparison(lhs[i], rhs[i])));
+    }
+  }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
@@ -36,6 +36,10 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateBatch(const TupleBatch &batch, const Schema *schema, std::vector<Value> *result) const override {
+    result->assign(batch.Size(), val_);
+  }
+
  private:
   Value val_;
 };
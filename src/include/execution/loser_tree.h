@@ -0,0 +1,75 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// loser_tree.h
+//
+// Identification: src/include/execution/loser_tree.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace bustub {
+
+/**
+ * LoserTree picks the smallest head of k sorted inputs for a k-way merge. Every inner node keeps the input that lost
+ * the match played there, so once the head of the winner changes, Replay() only plays the matches on the path from
+ * that input to the root: log2(k) comparisons against the losers stored there.
+ *
+ * Less(a, b) tells if the head of input a is smaller than the head of input b. An exhausted input must be larger than
+ * any other head. Equal heads are won by the input with the lower index, which keeps a merge of runs stable.
+ */
+template <typename Less>
+class LoserTree {
+ public:
+  LoserTree(size_t k, Less less) : k_(k), less_(std::move(less)), tree_(k, k) {}
+
+  /** Play all the matches, after the heads of all inputs are set. */
+  void Init() {
+    if (k_ == 0) {
+      return;
+    }
+    // leaf i is node k + i, node n plays the winners of nodes 2n and 2n + 1
+    std::vector<size_t> winners(2 * k_);
+    for (size_t i = 0; i < k_; i++) {
+      winners[k_ + i] = i;
+    }
+    for (size_t n = k_ - 1; n > 0; n--) {
+      size_t left = winners[2 * n];
+      size_t right = winners[2 * n + 1];
+      winners[n] = Beats(right, left) ? right : left;
+      tree_[n] = winners[n] == left ? right : left;
+    }
+    tree_[0] = winners[1];
+  }
+
+  /** @return the input with the smallest head */
+  size_t Top() const { return tree_[0]; }
+
+  /** Play the matches of an input again, after its head changed. */
+  void Replay(size_t input) {
+    size_t winner = input;
+    for (size_t n = (input + k_) / 2; n > 0; n /= 2) {
+      if (Beats(tree_[n], winner)) {
+        std::swap(tree_[n], winner);
+      }
+    }
+    tree_[0] = winner;
+  }
+
+ private:
+  bool Beats(size_t a, size_t b) { return less_(a, b) || (!less_(b, a) && a < b); }
+
+  size_t k_;
+  Less less_;
+  /** tree_[0] is the winner, tree_[n] the loser of the match at node n */
+  std::vector<size_t> tree_;
+};
+
+}  // namespace bustub
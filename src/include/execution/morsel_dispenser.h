@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/execution/morsel_dispenser.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * MorselDispenser hands out the pages of a table heap in morsels: runs of up to MORSEL_PAGES pages that follow each
+ * other in the heap's page chain. Scans on several threads claim morsels from one dispenser until the chain is used
+ * up, so that every page is scanned exactly once and a thread that is done early claims more of them.
+ */
+class MorselDispenser {
+ public:
+  /** Pages per morsel, enough to amortize claiming it and few enough to balance the threads at the end of a scan. */
+  static constexpr uint32_t MORSEL_PAGES = 16;
+
+  MorselDispenser(TableHeap *table_heap, BufferPoolManager *bpm)
+      : bpm_(bpm), next_page_id_(table_heap->GetFirstPageId()) {}
+
+  /**
+   * Claim the next morsel.
+   * @param[out] morsel the page ids of the morsel in chain order
+   * @return false once all pages are claimed
+   */
+  bool Claim(std::vector<page_id_t> *morsel);
+
+ private:
+  std::mutex latch_;
+  BufferPoolManager *bpm_;
+  /** the first page not claimed yet */
+  page_id_t next_page_id_;
+};
+
+}  // namespace bustub
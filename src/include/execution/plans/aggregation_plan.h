@@ -39,15 +39,23 @@ class AggregationPlanNode : public AbstractPlanNode {
    * @param group_bys the group by clause of the aggregation
    * @param aggregates the expressions that we are aggregating
    * @param agg_types the types that we are aggregating
+   * @param parallelism the number of threads that pre-aggregate a part of the child's tuples each, above one the child
+   * must be a subtree whose copies split its rows between them, see WorkerGroup::CanSplit
+   * @param memory_pages the pages worth of groups the aggregation may hold in memory before it spills partitions
    */
   AggregationPlanNode(const Schema *output_schema, const AbstractPlanNode *child, const AbstractExpression *having,
                       std::vector<const AbstractExpression *> &&group_bys,
-                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types)
+                      std::vector<const AbstractExpression *> &&aggregates, std::vector<AggregationType> &&agg_types,
+                      uint32_t parallelism = 1, size_t memory_pages = DEFAULT_MEMORY_PAGES)
       : AbstractPlanNode(output_schema, {child}),
         having_(having),
         group_bys_(std::move(group_bys)),
         aggregates_(std::move(aggregates)),
-        agg_types_(std::move(agg_types)) {}
+        agg_types_(std::move(agg_types)),
+        parallelism_(parallelism),
+        memory_pages_(memory_pages) {
+    BUSTUB_ASSERT(parallelism_ > 0, "An aggregation needs at least one thread.");
+  }
 
   PlanType GetType() const override { return PlanType::Aggregation; }
 
@@ -75,11 +83,21 @@ class AggregationPlanNode : public AbstractPlanNode {
   /** @return the aggregate types */
   const std::vector<AggregationType> &GetAggregateTypes() const { return agg_types_; }
 
+  /** @return the number of threads that pre-aggregate the child's tuples */
+  uint32_t GetParallelism() const { return parallelism_; }
+
+  /** @return the number of bytes of groups the aggregation may hold in memory */
+  size_t GetMemoryBudget() const { return memory_pages_ * PAGE_SIZE; }
+
+  static constexpr size_t DEFAULT_MEMORY_PAGES = 256;
+
  private:
   const AbstractExpression *having_;
   std::vector<const AbstractExpression *> group_bys_;
   std::vector<const AbstractExpression *> aggregates_;
   std::vector<AggregationType> agg_types_;
+  uint32_t parallelism_;
+  size_t memory_pages_;
 };
 
 struct AggregateKey {
@@ -0,0 +1,81 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_plan.h
+//
+// Identification: src/include/execution/plans/exchange_plan.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * How an exchange distributes the tuples of its producers to its consumers.
+ * GATHER: every consumer pops from one queue, so a single consumer receives all tuples.
+ * REPARTITION: the hash of the partition keys picks the consumer of a tuple, so equal keys meet in one consumer.
+ * BROADCAST: every consumer receives all tuples.
+ */
+enum class ExchangeType { GATHER, REPARTITION, BROADCAST };
+
+/**
+ * ExchangePlanNode runs parallelism copies of its child subtree on the threads of the query worker pool and passes the
+ * tuples the copies produce to its consumers. The consumers are the copies of the subtree above the exchange: one if
+ * the exchange is not below another exchange, otherwise the producers of that exchange. Sequential scans in the
+ * copies of the child each read a part of their table, so the child must be a subtree whose output over the whole
+ * table is the union of its outputs over the parts, such as a pipeline of scans, filters and hash join probes. The
+ * executor asserts this for a parallelism above one, see WorkerGroup::CanSplit. The output schema of an exchange is
+ * the one of its child.
+ */
+class ExchangePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new exchange plan node.
+   * @param output_schema the output format of this plan node, the one of the child
+   * @param child the child plan whose copies produce the tuples
+   * @param type how the tuples are distributed to the consumers
+   * @param parallelism the number of copies of the child
+   * @param partition_keys the expressions hashed to pick the consumer of a tuple, evaluated on the tuples of the child
+   */
+  ExchangePlanNode(const Schema *output_schema, const AbstractPlanNode *child, ExchangeType type,
+                   uint32_t parallelism, std::vector<const AbstractExpression *> &&partition_keys = {})
+      : AbstractPlanNode(output_schema, {child}),
+        type_(type),
+        parallelism_(parallelism),
+        partition_keys_(std::move(partition_keys)) {
+    BUSTUB_ASSERT(parallelism_ > 0, "An exchange needs at least one producer.");
+    BUSTUB_ASSERT(type_ != ExchangeType::REPARTITION || !partition_keys_.empty(),
+                  "A repartitioning exchange needs partition keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::Exchange; }
+
+  /** @return the child of this exchange plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Exchange should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  ExchangeType GetExchangeType() const { return type_; }
+
+  uint32_t GetParallelism() const { return parallelism_; }
+
+  /** @return the expressions hashed to pick the consumer of a tuple */
+  const std::vector<const AbstractExpression *> &GetPartitionKeys() const { return partition_keys_; }
+
+ private:
+  ExchangeType type_;
+  uint32_t parallelism_;
+  std::vector<const AbstractExpression *> partition_keys_;
+};
+}  // namespace bustub
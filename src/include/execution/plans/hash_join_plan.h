@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_plan.h
+//
+// Identification: src/include/execution/plans/hash_join_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+/**
+ * HashJoinPlanNode joins the tuples of two children whose join keys are equal. The keys are lists of expressions, the
+ * i-th left key expression is compared with the i-th right key expression.
+ */
+class HashJoinPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new hash join plan node.
+   * @param output_schema the output format of this hash join node
+   * @param children the left and the right child plans
+   * @param predicate a condition the joined tuples must also satisfy, may be nullptr
+   * @param left_hash_keys the key expressions over the tuples of the left child
+   * @param right_hash_keys the key expressions over the tuples of the right child
+   * @param memory_pages the pages worth of tuples the join may hold in memory before it partitions its inputs
+   */
+  HashJoinPlanNode(const Schema *output_schema, std::vector<const AbstractPlanNode *> &&children,
+                   const AbstractExpression *predicate, std::vector<const AbstractExpression *> &&left_hash_keys,
+                   std::vector<const AbstractExpression *> &&right_hash_keys,
+                   size_t memory_pages = DEFAULT_MEMORY_PAGES)
+      : AbstractPlanNode(output_schema, std::move(children)),
+        predicate_(predicate),
+        left_hash_keys_(std::move(left_hash_keys)),
+        right_hash_keys_(std::move(right_hash_keys)),
+        memory_pages_(memory_pages) {
+    BUSTUB_ASSERT(!left_hash_keys_.empty() && left_hash_keys_.size() == right_hash_keys_.size(),
+                  "Hash joins need the same number of left and right keys.");
+  }
+
+  PlanType GetType() const override { return PlanType::HashJoin; }
+
+  /** @return the predicate to be used in the hash join, nullptr if equal keys are enough */
+  const AbstractExpression *Predicate() const { return predicate_; }
+
+  /** @return the left plan node of the hash join */
+  const AbstractPlanNode *GetLeftPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(0);
+  }
+
+  /** @return the right plan node of the hash join */
+  const AbstractPlanNode *GetRightPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 2, "Hash joins should have exactly two children plans.");
+    return GetChildAt(1);
+  }
+
+  /** @return the key expressions evaluated on the left tuples */
+  const std::vector<const AbstractExpression *> &GetLeftKeys() const { return left_hash_keys_; }
+
+  /** @return the key expressions evaluated on the right tuples */
+  const std::vector<const AbstractExpression *> &GetRightKeys() const { return right_hash_keys_; }
+
+  /** @return the number of bytes of tuples the join may hold in memory */
+  size_t GetMemoryBudget() const { return memory_pages_ * PAGE_SIZE; }
+
+  static constexpr size_t DEFAULT_MEMORY_PAGES = 256;
+
+ private:
+  /** The join predicate. */
+  const AbstractExpression *predicate_;
+  /** The join keys. */
+  std::vector<const AbstractExpression *> left_hash_keys_;
+  std::vector<const AbstractExpression *> right_hash_keys_;
+  /** The memory budget of the join, in pages. */
+  size_t memory_pages_;
+};
+
+struct HashJoinKey {
+  std::vector<Value> keys_;
+
+  /**
+   * Compares two join keys for equality.
+   * @param other the other join key to be compared with
+   * @return true if every key value of both join keys is equal
+   */
+  bool operator==(const HashJoinKey &other) const {
+    for (uint32_t i = 0; i < other.keys_.size(); i++) {
+      if (keys_[i].CompareEquals(other.keys_[i]) != CmpBool::CmpTrue) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /** @return true if a key value is NULL, such a key never joins */
+  bool HasNull() const {
+    for (const auto &key : keys_) {
+      if (key.IsNull()) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+}  // namespace bustub
+
+namespace std {
+
+/**
+ * Implements std::hash on HashJoinKey.
+ */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &join_key) const {
+    size_t curr_hash = 0;
+    for (const auto &key : join_key.keys_) {
+      curr_hash = bustub::HashUtil::CombineHashes(curr_hash, bustub::HashUtil::HashValue(&key));
+    }
+    return curr_hash;
+  }
+};
+
+}  // namespace std
@@ -0,0 +1,64 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction a sort key is ordered in. */
+enum class OrderByType { ASC, DESC };
+
+/**
+ * SortPlanNode orders the tuples of its child by a list of keys, the first key decides and each next key breaks the
+ * ties of the keys before it. Tuples with equal keys keep the order of the child.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new sort plan node.
+   * @param output_schema the output format of this plan node
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the direction and the expression of each sort key, evaluated on the tuples of the child
+   * @param memory_pages the pages worth of tuples the sort may hold in memory before it spills sorted runs
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys,
+               size_t memory_pages = DEFAULT_MEMORY_PAGES)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), memory_pages_(memory_pages) {}
+
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return the child of this sort plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort keys */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  /** @return the number of pages the sort may hold in memory */
+  size_t GetMemoryPages() const { return memory_pages_; }
+
+  static constexpr size_t DEFAULT_MEMORY_PAGES = 256;
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t memory_pages_;
+};
+}  // namespace bustub
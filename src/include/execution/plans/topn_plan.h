@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_plan.h
+//
+// Identification: src/include/execution/plans/topn_plan.h
+//
+// Copyright (c) 2015-19, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+/**
+ * TopNPlanNode is a sort followed by a limit: it returns the first limit tuples of its child in the order of the sort
+ * keys, after skipping offset of them. Tuples with equal keys keep the order of the child.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Creates a new top-n plan node.
+   * @param output_schema the output format of this plan node
+   * @param child the child plan to obtain tuples from
+   * @param order_bys the direction and the expression of each sort key, evaluated on the tuples of the child
+   * @param limit the number of output tuples
+   * @param offset the number of sorted tuples to be skipped
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child,
+               std::vector<std::pair<OrderByType, const AbstractExpression *>> &&order_bys, size_t limit,
+               size_t offset = 0)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), limit_(limit), offset_(offset) {}
+
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  /** @return the child of this top-n plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "TopN should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+  /** @return the sort keys */
+  const std::vector<std::pair<OrderByType, const AbstractExpression *>> &GetOrderBys() const { return order_bys_; }
+
+  size_t GetLimit() const { return limit_; }
+
+  size_t GetOffset() const { return offset_; }
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+  size_t limit_;
+  size_t offset_;
+};
+}  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// query_worker_pool.h
+//
+// Identification: src/include/execution/query_worker_pool.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * QueryWorkerPool runs the tasks of parallel queries, such as the producers of exchanges, on threads that are kept
+ * between queries. Tasks of one query wait for each other through the queues of exchanges, so a task must never wait
+ * for a free thread: when every thread is busy, Submit() starts another one. The pool thus grows to the largest number
+ * of tasks that ran at once, and its threads wait for more tasks once they are done.
+ */
+class QueryWorkerPool {
+ public:
+  QueryWorkerPool() = default;
+
+  DISALLOW_COPY_AND_MOVE(QueryWorkerPool);
+
+  /** Runs the tasks submitted so far and stops the threads. */
+  ~QueryWorkerPool();
+
+  /** Run a task on a thread of the pool. */
+  void Submit(std::function<void()> task);
+
+  /** @return the number of threads started */
+  size_t GetThreadCount();
+
+ private:
+  void Work();
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  /** the threads waiting for a task */
+  size_t idle_threads_{0};
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
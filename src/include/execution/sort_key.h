@@ -0,0 +1,53 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key.h
+//
+// Identification: src/include/execution/sort_key.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * SortKeyEncoder turns the sort keys of a tuple into a normalized key: a byte string whose byte-wise (memcmp) order is
+ * the order of the sort keys, so that tuples are compared without looking at their types or directions again.
+ *
+ * Every key value starts with a byte that orders NULL first. Numbers follow big endian with the sign bit flipped, and
+ * strings follow with their 0 bytes escaped and a terminator, so that a prefix orders first. A DESC key has all of its
+ * bytes inverted.
+ */
+class SortKeyEncoder {
+ public:
+  explicit SortKeyEncoder(const std::vector<std::pair<OrderByType, const AbstractExpression *>> &order_bys)
+      : order_bys_(order_bys) {}
+
+  /** @return the normalized key of a tuple with the given schema */
+  std::string Encode(const Tuple &tuple, const Schema *schema) const;
+
+  /** Set (*keys)[i] to the normalized key of the i-th selected row of the batch. */
+  void EncodeBatch(const TupleBatch &batch, const Schema *schema, std::vector<std::string> *keys) const;
+
+  /** Append the normalized form of a value to a key. */
+  static void AppendValue(const Value &value, OrderByType order, std::string *key);
+
+ private:
+  std::vector<std::pair<OrderByType, const AbstractExpression *>> order_bys_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to BATCH_SIZE rows of an executor's output in columnar form: one vector of values per column of
+ * the output schema and the RID of every row. The selection vector lists the rows that are part of the result, in
+ * order, so that a filter drops rows without moving the column values.
+ */
+class TupleBatch {
+ public:
+  /** Rows an executor produces per NextBatch() call. */
+  static constexpr uint32_t BATCH_SIZE = 1024;
+
+  TupleBatch() = default;
+
+  /** Empty the batch and give it column_count columns, keeping the memory of the column vectors. */
+  void Reset(uint32_t column_count);
+
+  /** @return the number of columns */
+  uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the number of rows stored, selected or not */
+  uint32_t GetRowCount() const { return static_cast<uint32_t>(rids_.size()); }
+
+  /** @return true if no more rows should be appended */
+  bool IsFull() const { return GetRowCount() >= BATCH_SIZE; }
+
+  /** @return the number of selected rows */
+  uint32_t Size() const { return static_cast<uint32_t>(selection_.size()); }
+
+  /** @return true if no row is selected */
+  bool IsEmpty() const { return selection_.empty(); }
+
+  /** @return the row index of the i-th selected row */
+  uint32_t SelectedRow(uint32_t i) const { return selection_[i]; }
+
+  /** Replace the selection vector, the new one must only hold rows of the current selection. */
+  void SetSelection(std::vector<uint32_t> &&selection) { selection_ = std::move(selection); }
+
+  /** @return the values of a column, indexed by row (not by position in the selection) */
+  std::vector<Value> &GetColumn(uint32_t col_idx) { return columns_[col_idx]; }
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the value of a column in a row */
+  const Value &GetValue(uint32_t col_idx, uint32_t row) const { return columns_[col_idx][row]; }
+
+  /** @return the RID of a row */
+  const RID &GetRid(uint32_t row) const { return rids_[row]; }
+
+  /** Append a selected row holding the values of every column of a tuple of schema. */
+  void AppendTuple(const Tuple &tuple, const Schema *schema, const RID &rid);
+
+  /**
+   * Append a selected row whose values the caller has already pushed onto the back of every column vector.
+   * @return the index of the new row
+   */
+  uint32_t AppendRow(const RID &rid);
+
+  /** @return row as a tuple of schema, the row adapter for code that still works on tuples */
+  Tuple GetTuple(uint32_t row, const Schema *schema) const;
+
+ private:
+  std::vector<std::vector<Value>> columns_;
+  std::vector<RID> rids_;
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
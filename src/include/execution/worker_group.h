@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// worker_group.h
+//
+// Identification: src/include/execution/worker_group.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "execution/exchange_channel.h"
+#include "execution/morsel_dispenser.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/**
+ * WorkerGroup is the state shared by the copies of a plan subtree that run on several threads, such as the producers
+ * of an exchange. Each copy has its own executors and its own index in the group. Sequential scans of the copies
+ * claim their pages from the group's morsel dispenser of their plan node, so each copy reads a disjoint part of every
+ * table, and the exchanges below the copies deliver their batches through the group's channel of their plan node.
+ */
+class WorkerGroup {
+ public:
+  /** @param worker_count the number of copies in the group */
+  explicit WorkerGroup(uint32_t worker_count) : worker_count_(worker_count) {}
+
+  DISALLOW_COPY_AND_MOVE(WorkerGroup);
+
+  /** Stops the producers of the channels of the group, which are no longer read by anyone. */
+  ~WorkerGroup();
+
+  /** @return the number of copies in the group */
+  uint32_t GetWorkerCount() const { return worker_count_; }
+
+  /** @return the dispenser of a scan plan node, created on the first call for it */
+  std::shared_ptr<MorselDispenser> GetDispenser(const AbstractPlanNode *plan, TableHeap *table_heap,
+                                                BufferPoolManager *bpm);
+
+  /** @return the channel of an exchange plan node, created on the first call for it */
+  std::shared_ptr<ExchangeChannel> GetChannel(const AbstractPlanNode *plan, uint32_t queue_count,
+                                              uint32_t producer_count);
+
+  /**
+   * The copies of a plan subtree return each of its rows once if the subtree has a single split input, a sequential
+   * scan or an exchange that hands each copy a part of its rows, and the operators above that input work row by row.
+   * Everything else in the subtree has to be read whole by every copy: index scans, broadcast exchanges, and
+   * aggregations that run their own workers. A join of two split inputs only pairs up its rows if both are
+   * repartitioning exchanges, which have to hash the join keys. Limits, top-n and writes never run split.
+   * @return true if the copies of plan in a worker group together return each row of plan once
+   */
+  static bool CanSplit(const AbstractPlanNode *plan);
+
+ private:
+  uint32_t worker_count_;
+  std::mutex latch_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<MorselDispenser>> dispensers_;
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<ExchangeChannel>> channels_;
+};
+
+}  // namespace bustub
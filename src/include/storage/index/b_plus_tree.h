@@ -10,8 +10,13 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <mutex>   // NOLINT
 #include <queue>
 #include <string>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "concurrency/transaction.h"
@@ -23,12 +28,25 @@ namespace bustub {
 
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
+/**
+ * The kind of tree operation a descent is performed for, used to decide when ancestors can be released.
+ * COMPACT is the descent of the maintenance task to a leaf below its min size.
+ */
+enum class Operation { FIND = 0, INSERT, DELETE, COMPACT };
+
+/**
+ * When a delete rebalances the pages it shrinks. EAGER merges or redistributes as soon as a page drops below half
+ * full. LAZY only does it for nearly empty pages and leaves the rest to BPlusTree::Compact(), so that deletes keep
+ * fewer latches and a delete-then-insert workload does not merge and split the same leaves over and over.
+ */
+enum class MergePolicy { EAGER = 0, LAZY };
+
 /**
  * Main class providing the API for the Interactive B+ Tree.
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) Keys are unique, unless the tree is created with unique_keys = false
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
@@ -39,8 +57,15 @@ class BPlusTree {
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
 
  public:
+  // Internal pages only store the key bytes the comparator's schema uses. With the default internal_max_size the
+  // fan-out is raised to what fits a page with these truncated separators, and with variable length keys it is only
+  // bounded by the space the keys take. Keys that are not single integers get leaf fingerprints, which take a byte
+  // per entry of the default leaf_max_size and are left out if an explicit leaf_max_size leaves no room for them.
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE,
+                     bool unique_keys = true);
+
+  ~BPlusTree();
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -48,17 +73,46 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   bool Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  // Fill an empty tree bottom up from entries sorted by key, with distinct keys unless the tree allows duplicates.
+  // Returns false and leaves the tree alone if it is not empty.
+  bool BulkLoad(const std::vector<MappingType> &entries);
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
-  // return the value associated with a given key
+  // Remove the entry holding exactly this key and value, the way to delete one of several duplicates.
+  void Remove(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
+  // With LAZY a leaf is only rebalanced once it holds fewer than lazy_min_size entries (it is empty by default) and an
+  // internal page once a single child is left. Must be set before the tree is shared.
+  void SetMergePolicy(MergePolicy policy, int lazy_min_size = 1);
+
+  // Rebalance the leaves that a LAZY delete left below their min size. Returns the number of leaves changed.
+  size_t Compact();
+
+  // Run Compact() every interval on a background thread, until StopMaintenance() or the tree is destroyed.
+  void StartMaintenance(std::chrono::milliseconds interval);
+  void StopMaintenance();
+
+  // return the values associated with a given key, all of them if the tree allows duplicates
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // look up many keys at once, (*results)[i] receives the values of keys[i]
+  void GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                 Transaction *transaction = nullptr);
+
   // index iterator
   INDEXITERATOR_TYPE begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
   INDEXITERATOR_TYPE end();
 
+  // reverse index iterator, ++ moves towards smaller keys
+  INDEXITERATOR_TYPE rbegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
+  INDEXITERATOR_TYPE rend();
+
+  const KeyComparator &GetComparator() const { return comparator_; }
+
   void Print(BufferPoolManager *bpm) {
     ToString(reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(root_page_id_)->GetData()), bpm);
   }
@@ -76,31 +130,67 @@ class BPlusTree {
 
   // read data from file and remove one by one
   void RemoveFromFile(const std::string &file_name, Transaction *transaction = nullptr);
-  // expose for test purpose
-  Page *FindLeafPage(const KeyType &key, bool leftMost = false);
+  // expose for test purpose, the returned leaf is pinned and read latched
+  Page *FindLeafPage(const KeyType &key, bool leftMost = false, bool rightMost = false);
 
  private:
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  bool InsertIntoLastLeaf(const KeyType &key, const ValueType &value, bool *inserted);
+
+  void RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction);
+
+  bool RemoveFromRun(Page *page, const KeyType &key, const ValueType *value, Transaction *transaction);
+
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                        Transaction *transaction = nullptr);
+                        Transaction *transaction = nullptr, bool root_page_latch = false);
 
   template <typename N>
-  N *Split(N *node);
+  N *Split(N *node, bool right_edge = false);
 
   template <typename N>
-  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
+  bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr, bool root_page_latch = false,
+                              Operation op = Operation::DELETE);
 
   template <typename N>
   bool Coalesce(N **neighbor_node, N **node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent,
-                int index, Transaction *transaction = nullptr);
+                int index, Transaction *transaction = nullptr, bool root_page_latch = false);
+
+  template <typename N>
+  void Redistribute(N *neighbor_node, N *node, int index, bool root_page_latch = false);
+
+  bool AdjustRoot(BPlusTreePage *node, bool root_page_latch = false);
+
+  bool RebalanceLeaf(Page *page, Operation op, Transaction *transaction);
+
+  bool LatchAncestors(BPlusTreePage *node, Operation op, Transaction *transaction, bool *root_page_latch,
+                      bool *detached);
+
+  void RunMaintenance();
 
+  // a page with fewer entries than this is rebalanced after a delete
   template <typename N>
-  void Redistribute(N *neighbor_node, N *node, int index);
+  int RebalanceSize(N *node, Operation op);
+
+  // true if the page is below the size a delete rebalances at once removed more entries are gone
+  template <typename N>
+  bool IsUnderfull(N *node, Operation op, int removed = 0);
+
+  template <typename N>
+  bool IsSafe(N *node, Operation op);
+
+  // descend to the leaf for key, latch crabbing according to op; second is true if root_latch_ is still held.
+  // firstDuplicate descends to the left most leaf that may hold key instead of the right most one.
+  std::pair<Page *, bool> FindLeafPageByOperation(const KeyType &key, Operation op, Transaction *transaction,
+                                                  bool leftMost, bool rightMost = false, bool firstDuplicate = false);
+
+  void Unlock(Transaction *transaction);
+
+  void UnlockUnpinPages(Transaction *transaction);
 
-  bool AdjustRoot(BPlusTreePage *node);
+  void RelinkPrevPageId(page_id_t page_id, page_id_t prev_page_id);
 
   void UpdateRootPageId(int insert_record = 0);
 
@@ -111,11 +201,28 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  // published with a store so that readers can start a descent without root_latch_
+  std::atomic<page_id_t> root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool unique_keys_;
+  // bytes of each separator stored in internal pages
+  int key_width_;
+  // pages use the slotted format, sized by the bytes of their keys, for variable length keys
+  bool slotted_keys_;
+  // leaves keep a fingerprint per key to speed up point lookups, for keys that are not searched as integers
+  bool leaf_fingerprints_;
+  // serializes the writers that may change root_page_id_
+  std::mutex root_latch_;
+  // the right most leaf, changed only while that leaf is write latched
+  std::atomic<page_id_t> last_leaf_page_id_{INVALID_PAGE_ID};
+  MergePolicy merge_policy_{MergePolicy::EAGER};
+  int lazy_min_size_{1};
+  std::atomic<bool> enable_maintenance_{false};
+  std::thread *maintenance_thread_{nullptr};
+  std::chrono::milliseconds maintenance_interval_{0};
 };
 
 }  // namespace bustub
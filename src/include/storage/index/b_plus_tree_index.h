@@ -13,6 +13,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "storage/index/b_plus_tree.h"
@@ -33,13 +34,33 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                Transaction *transaction) override;
+
+  void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                 std::vector<RID> *result, Transaction *transaction, ScanDirection direction = ScanDirection::FORWARD,
+                 std::vector<Tuple> *entries = nullptr, uint32_t bound_columns = 0) override;
+
+  // build the still empty index from (key, rid) entries sorted by key, see BPlusTree::BulkLoad
+  bool BulkLoad(const std::vector<std::pair<KeyType, ValueType>> &entries) { return container_.BulkLoad(entries); }
+
+  const KeyComparator &GetComparator() const { return comparator_; }
+
   INDEXITERATOR_TYPE GetBeginIterator();
 
   INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
 
   INDEXITERATOR_TYPE GetEndIterator();
 
+  // reverse iterators start at the largest key (<= key) and end at isEnd()
+  INDEXITERATOR_TYPE GetReverseBeginIterator();
+
+  INDEXITERATOR_TYPE GetReverseBeginIterator(const KeyType &key);
+
  protected:
+  // decode a stored key, with its included columns, into a tuple of the entry schema
+  Tuple EntryToTuple(const KeyType &key) const;
+
   // comparator for key
   KeyComparator comparator_;
   // container
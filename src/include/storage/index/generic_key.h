@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstring>
+#include <string>
+#include <vector>
 
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -30,6 +35,13 @@ template <size_t KeySize>
 class GenericKey {
  public:
   inline void SetFromKey(const Tuple &tuple) {
+    // a key tuple with long strings can be larger than the key, cutting it would leave a varchar whose length points
+    // past the key
+    if (tuple.GetLength() > KeySize) {
+      throw Exception(ExceptionType::OUT_OF_RANGE, "The key is " + std::to_string(tuple.GetLength()) +
+                                                       " bytes long, the index only holds " +
+                                                       std::to_string(KeySize) + " bytes.");
+    }
     // intialize to 0
     memset(data_, 0, KeySize);
     memcpy(data_, tuple.GetData(), tuple.GetLength());
@@ -77,8 +89,125 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline int operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const {
+    switch (int_key_width_) {
+      case 1:
+        return CompareInteger<int8_t>(lhs, rhs);
+      case 2:
+        return CompareInteger<int16_t>(lhs, rhs);
+      case 4:
+        return CompareInteger<int32_t>(lhs, rhs);
+      case 8:
+        return CompareInteger<int64_t>(lhs, rhs);
+      default:
+        break;
+    }
+
+    return CompareColumns(lhs, rhs, key_schema_->GetColumnCount());
+  }
+
+  /**
+   * @return the comparison of the first column_count key columns only, so that a key prefix used as a scan bound
+   * is equal to every key starting with it
+   */
+  inline int ComparePrefix(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs,
+                           uint32_t column_count) const {
+    if (column_count >= key_schema_->GetColumnCount()) {
+      return (*this)(lhs, rhs);
+    }
+    return CompareColumns(lhs, rhs, column_count);
+  }
+
+  /**
+   * @return the byte width of the key if it is a single inlined integer column stored at the start of the key, so
+   * keys can be compared (and searched with SIMD) as plain signed integers; 0 otherwise
+   */
+  inline int IntegerKeyWidth() const { return int_key_width_; }
+
+  /**
+   * @return the number of leading bytes of a key the key schema uses; the remaining bytes of a GenericKey are always
+   * zero, so they need not be stored
+   */
+  inline int KeyWidth() const { return key_width_; }
+
+  /**
+   * @return true if the key schema has variable length columns, so the used part of keys differs from key to key
+   */
+  inline bool HasVariableLengthKeys() const { return key_schema_ != nullptr && !key_schema_->IsInlined(); }
+
+  /**
+   * @return true if keys compare equal exactly when their bytes are equal, which does not hold for DECIMAL columns
+   * (0.0 and -0.0 are equal)
+   */
+  inline bool HasBytewiseEquality() const {
+    if (key_schema_ == nullptr) {
+      return false;
+    }
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      if (key_schema_->GetColumn(i).GetType() == TypeId::DECIMAL) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @return the separator to store between a page ending in left and the page after it starting with right: a key s
+   * with left < s <= right that is as short as the key schema allows. Up to the first column in which the keys differ
+   * s is right; a varchar there is cut one character past its common prefix with left, and every varchar after it is
+   * empty. Keys without variable length columns, equal keys and keys with NULLs get right itself.
+   */
+  inline GenericKey<KeySize> Separator(const GenericKey<KeySize> &left, const GenericKey<KeySize> &right) const {
+    if (!HasVariableLengthKeys() || (*this)(left, right) >= 0) {
+      return right;
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
+    std::vector<Value> values;
+    values.reserve(column_count);
+    bool differs = false;
+    for (uint32_t i = 0; i < column_count; i++) {
+      Value lhs_value = left.ToValue(key_schema_, i);
+      Value rhs_value = right.ToValue(key_schema_, i);
+      if (lhs_value.IsNull() || rhs_value.IsNull()) {
+        // NULL compares equal to everything, shortening around it could reorder keys
+        return right;
+      }
+      if (differs || lhs_value.CompareEquals(rhs_value) == CmpBool::CmpTrue) {
+        // past the first difference s is already greater than left, an empty string keeps it at most right
+        values.push_back(differs && rhs_value.GetTypeId() == TypeId::VARCHAR ? ValueFactory::GetVarcharValue(std::string())
+                                                                             : rhs_value);
+        continue;
+      }
+      differs = true;
+      if (rhs_value.GetTypeId() != TypeId::VARCHAR) {
+        values.push_back(rhs_value);
+        continue;
+      }
+      // the lengths count the terminating zero
+      const char *lhs_data = lhs_value.GetData();
+      const char *rhs_data = rhs_value.GetData();
+      uint32_t lhs_length = lhs_value.GetLength() - 1;
+      uint32_t rhs_length = rhs_value.GetLength() - 1;
+      uint32_t common = 0;
+      while (common < lhs_length && common < rhs_length && lhs_data[common] == rhs_data[common]) {
+        common++;
+      }
+      values.push_back(ValueFactory::GetVarcharValue(std::string(rhs_data, std::min(common + 1, rhs_length))));
+    }
+    GenericKey<KeySize> separator;
+    separator.SetFromKey(Tuple(values, key_schema_));
+    return separator;
+  }
 
+  GenericComparator(const GenericComparator &other)
+      : key_schema_{other.key_schema_}, int_key_width_{other.int_key_width_}, key_width_{other.key_width_} {}
+
+  // constructor
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema), int_key_width_(ComputeIntegerKeyWidth()), key_width_(ComputeKeyWidth()) {}
+
+ private:
+  inline int CompareColumns(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs,
+                            uint32_t column_count) const {
     for (uint32_t i = 0; i < column_count; i++) {
       Value lhs_value = (lhs.ToValue(key_schema_, i));
       Value rhs_value = (rhs.ToValue(key_schema_, i));
@@ -94,13 +223,54 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  template <typename IntT>
+  static inline int CompareInteger(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) {
+    IntT lhs_value;
+    IntT rhs_value;
+    memcpy(&lhs_value, lhs.data_, sizeof(IntT));
+    memcpy(&rhs_value, rhs.data_, sizeof(IntT));
+    return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+  }
 
-  // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  int ComputeIntegerKeyWidth() const {
+    if (key_schema_ == nullptr || key_schema_->GetColumnCount() != 1) {
+      return 0;
+    }
+    const Column &col = key_schema_->GetColumn(0);
+    if (!col.IsInlined() || col.GetOffset() != 0) {
+      return 0;
+    }
+    int width;
+    switch (col.GetType()) {
+      case TypeId::TINYINT:
+        width = 1;
+        break;
+      case TypeId::SMALLINT:
+        width = 2;
+        break;
+      case TypeId::INTEGER:
+        width = 4;
+        break;
+      case TypeId::BIGINT:
+        width = 8;
+        break;
+      default:
+        return 0;
+    }
+    return static_cast<size_t>(width) <= KeySize ? width : 0;
+  }
+
+  int ComputeKeyWidth() const {
+    // variable length columns are stored after the fixed part, anywhere in the key
+    if (key_schema_ == nullptr || !key_schema_->IsInlined() || key_schema_->GetLength() > KeySize) {
+      return KeySize;
+    }
+    return key_schema_->GetLength();
+  }
 
- private:
   Schema *key_schema_;
+  int int_key_width_;
+  int key_width_;
 };
 
 }  // namespace bustub
@@ -18,6 +18,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -37,12 +38,22 @@ class IndexMetadata {
   IndexMetadata() = delete;
 
   IndexMetadata(std::string index_name, std::string table_name, const Schema *tuple_schema,
-                std::vector<uint32_t> key_attrs)
-      : name_(std::move(index_name)), table_name_(std::move(table_name)), key_attrs_(std::move(key_attrs)) {
+                std::vector<uint32_t> key_attrs, bool is_unique = true, std::vector<uint32_t> include_attrs = {})
+      : name_(std::move(index_name)),
+        table_name_(std::move(table_name)),
+        key_attrs_(std::move(key_attrs)),
+        include_attrs_(std::move(include_attrs)),
+        is_unique_(is_unique) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
+    entry_attrs_ = key_attrs_;
+    entry_attrs_.insert(entry_attrs_.end(), include_attrs_.begin(), include_attrs_.end());
+    entry_schema_ = Schema::CopySchema(tuple_schema, entry_attrs_);
   }
 
-  ~IndexMetadata() { delete key_schema_; }
+  ~IndexMetadata() {
+    delete key_schema_;
+    delete entry_schema_;
+  }
 
   inline const std::string &GetName() const { return name_; }
 
@@ -60,6 +71,18 @@ class IndexMetadata {
   //  columns
   inline const std::vector<uint32_t> &GetKeyAttrs() const { return key_attrs_; }
 
+  // Returns the non-key columns stored next to the key, they are not compared and let scans skip the table heap
+  inline const std::vector<uint32_t> &GetIncludeAttrs() const { return include_attrs_; }
+
+  // Returns the key columns followed by the included columns, the tuple columns an index entry is built from
+  inline const std::vector<uint32_t> &GetEntryAttrs() const { return entry_attrs_; }
+
+  // Returns the schema of an index entry, the key schema is a prefix of it
+  inline Schema *GetEntrySchema() const { return entry_schema_; }
+
+  // Returns true if no two entries may share a key, otherwise the index keeps one entry per (key, rid)
+  inline bool IsUnique() const { return is_unique_; }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -78,10 +101,21 @@ class IndexMetadata {
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<uint32_t> key_attrs_;
+  // covering columns stored after the key columns
+  const std::vector<uint32_t> include_attrs_;
+  // key_attrs_ followed by include_attrs_
+  std::vector<uint32_t> entry_attrs_;
+  // whether duplicate keys are rejected
+  const bool is_unique_;
   // schema of the indexed key
   Schema *key_schema_;
+  // schema of the key and the included columns
+  Schema *entry_schema_;
 };
 
+/** Order in which a range scan returns the matching entries. */
+enum class ScanDirection { FORWARD, BACKWARD };
+
 /////////////////////////////////////////////////////////////////////
 // Index class definition
 /////////////////////////////////////////////////////////////////////
@@ -117,6 +151,10 @@ class Index {
 
   const std::vector<uint32_t> &GetKeyAttrs() const { return metadata_->GetKeyAttrs(); }
 
+  Schema *GetEntrySchema() const { return metadata_->GetEntrySchema(); }
+
+  const std::vector<uint32_t> &GetEntryAttrs() const { return metadata_->GetEntryAttrs(); }
+
   // Get a string representation for debugging
   std::string ToString() const {
     std::stringstream os;
@@ -129,7 +167,8 @@ class Index {
   ///////////////////////////////////////////////////////////////////
   // Point Modification
   ///////////////////////////////////////////////////////////////////
-  // designed for secondary indexes.
+  // designed for secondary indexes. The key tuple follows GetEntrySchema(), so that it carries the included columns;
+  // the other operations only look at its key columns.
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
   // delete the index entry linked to given tuple
@@ -137,6 +176,39 @@ class Index {
 
   virtual void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) = 0;
 
+  /**
+   * Point query for a batch of keys, (*results)[i] receives the RIDs matching keys[i]. Indexes that can share work
+   * between the probes override this, the default probes one key at a time.
+   */
+  virtual void ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                        Transaction *transaction) {
+    results->assign(keys.size(), std::vector<RID>());
+    for (size_t i = 0; i < keys.size(); i++) {
+      ScanKey(keys[i], &(*results)[i], transaction);
+    }
+  }
+
+  /**
+   * Collect the RIDs of all entries whose key lies between the given bounds, in key order (or reverse key order).
+   * Only ordered indexes support range scans.
+   * @param low_key lower bound of the range, nullptr if the range is unbounded below
+   * @param low_inclusive whether entries equal to low_key are part of the range
+   * @param high_key upper bound of the range, nullptr if the range is unbounded above
+   * @param high_inclusive whether entries equal to high_key are part of the range
+   * @param[out] result the RIDs of the entries in the range
+   * @param transaction the transaction performing the scan
+   * @param direction FORWARD for ascending key order, BACKWARD for descending key order
+   * @param[out] entries if not nullptr, receives the stored entry of each RID as a tuple of GetEntrySchema()
+   * @param bound_columns if not 0, only the first bound_columns key columns of the bounds are compared, so a bound
+   * takes in every key starting with it; the other columns of low_key must hold the min values of their types
+   */
+  virtual void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                         std::vector<RID> *result, Transaction *transaction,
+                         ScanDirection direction = ScanDirection::FORWARD, std::vector<Tuple> *entries = nullptr,
+                         uint32_t bound_columns = 0) {
+    throw NotImplementedException("range scan is not supported by index " + GetName());
+  }
+
  private:
   //===--------------------------------------------------------------------===//
   //  Data members
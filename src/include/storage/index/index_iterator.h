@@ -19,25 +19,63 @@ namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+
  public:
-  // you may define your own constructor based on your member variables
-  IndexIterator();
+  // page must be pinned and read latched, the iterator takes over both; nullptr constructs the end iterator.
+  // A reverse iterator walks towards smaller keys and never returns keys greater than high_key, if given.
+  IndexIterator(BufferPoolManager *bpm, int index, Page *page, Tree *tree = nullptr, bool reverse = false,
+                const KeyType *high_key = nullptr);
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
   ~IndexIterator();
 
+  DISALLOW_COPY(IndexIterator);
+
   bool isEnd();
 
-  const MappingType &operator*();
+  MappingType operator*();
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const;
+
+  bool operator!=(const IndexIterator &itr) const;
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  // forward iterators only: move to the first entry >= key, which must not be smaller than the keys passed before.
+  // Only the current leaf and the next one are looked at; returns false if key lies further right, the caller
+  // then descends again.
+  bool SeekForward(const KeyType &key);
 
  private:
+  // skip forward until index_ points at an item, releasing exhausted leaves on the way
+  void SkipExhaustedLeaves();
+  // same for reverse iterators, following the prev links
+  void SkipExhaustedLeavesBackward();
+  void Release();
+
   // add your own private member variables here
+  BufferPoolManager *buffer_pool_manager_;
+  Page *page_;
+  int index_;
+  LeafPage *leaf_page;
+  // used to skip entries already returned when a concurrent split shifts them into the next leaf, and to
+  // re-descend when a reverse scan finds a stale prev link
+  Tree *tree_;
+  bool reverse_;
+  // reverse iterators only: keys must stay at or below bound_. Once an entry has been returned, bound_ is its key
+  // and last_value_ its value, so a re-descend can skip the duplicates of bound_ up to it (seeking_)
+  KeyType bound_{};
+  bool has_bound_{false};
+  bool has_last_{false};
+  ValueType last_value_{};
+  bool seeking_{false};
 };
 
 }  // namespace bustub
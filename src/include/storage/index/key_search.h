@@ -0,0 +1,289 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// key_search.h
+//
+// Identification: src/include/storage/index/key_search.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+namespace bustub {
+
+/**
+ * Search kernels for sorted integer keys inside index pages.
+ *
+ * A search first narrows the range with a few binary steps, then counts the remaining candidates with a linear SIMD
+ * scan. The last few probes of a binary search are mispredicted branches and cache misses, while a window of
+ * KEY_SEARCH_WINDOW keys fits in a handful of cache lines and is compared in a couple of instructions.
+ *
+ * Two memory layouts are supported:
+ *  - contiguous: the keys are stored in their own array (keys[i] is the i-th key)
+ *  - strided: the keys are embedded in larger entries, e.g. the (key, value) pairs of a B+ tree page. Key i starts at
+ *    base + i * stride. With AVX2 the window is read with gather instructions, with SSE4.2 it is loaded key by key
+ *    and compared a vector at a time.
+ *
+ * Every kernel returns the number of keys in [begin, end) that compare less than the target, or less or equal when
+ * Upper is true. Since the keys are sorted this is the std::lower_bound / std::upper_bound position.
+ */
+static constexpr int KEY_SEARCH_WINDOW = 16;
+
+namespace key_search_internal {
+
+template <typename IntT>
+inline IntT LoadKey(const char *ptr) {
+  IntT key;
+  memcpy(&key, ptr, sizeof(IntT));
+  return key;
+}
+
+template <typename IntT, bool Upper>
+inline bool Before(IntT key, IntT target) {
+  return Upper ? key <= target : key < target;
+}
+
+/** Scalar fallback, also used for the tail of the vector loops. */
+template <typename IntT, bool Upper>
+inline int CountStridedScalar(const char *base, size_t stride, int begin, int end, IntT target) {
+  int count = 0;
+  for (int i = begin; i < end; i++) {
+    count += static_cast<int>(Before<IntT, Upper>(LoadKey<IntT>(base + i * stride), target));
+  }
+  return count;
+}
+
+template <typename IntT, bool Upper>
+inline int CountStrided(const char *base, size_t stride, int begin, int end, IntT target) {
+#if defined(__AVX2__)
+  if constexpr (sizeof(IntT) == 4) {
+    int count = 0;
+    int i = begin;
+    const __m256i vtarget = _mm256_set1_epi32(static_cast<int32_t>(target));
+    const __m256i vstep = _mm256_set1_epi32(static_cast<int32_t>(8 * stride));
+    __m256i voffset = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                         _mm256_set1_epi32(static_cast<int32_t>(stride)));
+    const char *window = base + begin * stride;
+    for (; i + 8 <= end; i += 8) {
+      __m256i keys = _mm256_i32gather_epi32(reinterpret_cast<const int *>(window), voffset, 1);
+      // key > target for lower bound, the complement of key <= target for upper bound
+      __m256i mask = Upper ? _mm256_cmpgt_epi32(keys, vtarget) : _mm256_cmpgt_epi32(vtarget, keys);
+      int bits = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+      count += Upper ? 8 - bits : bits;
+      voffset = _mm256_add_epi32(voffset, vstep);
+    }
+    return count + CountStridedScalar<IntT, Upper>(base, stride, i, end, target);
+  } else if constexpr (sizeof(IntT) == 8) {
+    int count = 0;
+    int i = begin;
+    const __m256i vtarget = _mm256_set1_epi64x(static_cast<int64_t>(target));
+    const __m128i vstep = _mm_set1_epi32(static_cast<int32_t>(4 * stride));
+    __m128i voffset = _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(static_cast<int32_t>(stride)));
+    const char *window = base + begin * stride;
+    for (; i + 4 <= end; i += 4) {
+      __m256i keys = _mm256_i32gather_epi64(reinterpret_cast<const long long *>(window), voffset, 1);  // NOLINT
+      __m256i mask = Upper ? _mm256_cmpgt_epi64(keys, vtarget) : _mm256_cmpgt_epi64(vtarget, keys);
+      int bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+      count += Upper ? 4 - bits : bits;
+      voffset = _mm_add_epi32(voffset, vstep);
+    }
+    return count + CountStridedScalar<IntT, Upper>(base, stride, i, end, target);
+  }
+#elif defined(__SSE4_2__)
+  // no gathers before AVX2, the window is assembled with scalar loads and compared a vector at a time
+  if constexpr (sizeof(IntT) == 4) {
+    int count = 0;
+    int i = begin;
+    const __m128i vtarget = _mm_set1_epi32(static_cast<int32_t>(target));
+    for (; i + 4 <= end; i += 4) {
+      const char *window = base + i * stride;
+      __m128i keys = _mm_setr_epi32(LoadKey<int32_t>(window), LoadKey<int32_t>(window + stride),
+                                    LoadKey<int32_t>(window + 2 * stride), LoadKey<int32_t>(window + 3 * stride));
+      __m128i mask = Upper ? _mm_cmpgt_epi32(keys, vtarget) : _mm_cmpgt_epi32(vtarget, keys);
+      int bits = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+      count += Upper ? 4 - bits : bits;
+    }
+    return count + CountStridedScalar<IntT, Upper>(base, stride, i, end, target);
+  } else if constexpr (sizeof(IntT) == 8) {
+    int count = 0;
+    int i = begin;
+    const __m128i vtarget = _mm_set1_epi64x(static_cast<int64_t>(target));
+    for (; i + 2 <= end; i += 2) {
+      const char *window = base + i * stride;
+      __m128i keys = _mm_set_epi64x(LoadKey<int64_t>(window + stride), LoadKey<int64_t>(window));
+      __m128i mask = Upper ? _mm_cmpgt_epi64(keys, vtarget) : _mm_cmpgt_epi64(vtarget, keys);
+      int bits = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+      count += Upper ? 2 - bits : bits;
+    }
+    return count + CountStridedScalar<IntT, Upper>(base, stride, i, end, target);
+  }
+#endif
+  return CountStridedScalar<IntT, Upper>(base, stride, begin, end, target);
+}
+
+template <typename IntT, bool Upper>
+inline int CountContiguous(const IntT *keys, int begin, int end, IntT target) {
+  int count = 0;
+  int i = begin;
+#if defined(__AVX2__)
+  if constexpr (sizeof(IntT) == 4) {
+    const __m256i vtarget = _mm256_set1_epi32(static_cast<int32_t>(target));
+    for (; i + 8 <= end; i += 8) {
+      __m256i vkeys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+      __m256i mask = Upper ? _mm256_cmpgt_epi32(vkeys, vtarget) : _mm256_cmpgt_epi32(vtarget, vkeys);
+      int bits = __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+      count += Upper ? 8 - bits : bits;
+    }
+  } else if constexpr (sizeof(IntT) == 8) {
+    const __m256i vtarget = _mm256_set1_epi64x(static_cast<int64_t>(target));
+    for (; i + 4 <= end; i += 4) {
+      __m256i vkeys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+      __m256i mask = Upper ? _mm256_cmpgt_epi64(vkeys, vtarget) : _mm256_cmpgt_epi64(vtarget, vkeys);
+      int bits = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(mask)));
+      count += Upper ? 4 - bits : bits;
+    }
+  }
+#elif defined(__SSE4_2__)
+  if constexpr (sizeof(IntT) == 4) {
+    const __m128i vtarget = _mm_set1_epi32(static_cast<int32_t>(target));
+    for (; i + 4 <= end; i += 4) {
+      __m128i vkeys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+      __m128i mask = Upper ? _mm_cmpgt_epi32(vkeys, vtarget) : _mm_cmpgt_epi32(vtarget, vkeys);
+      int bits = __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+      count += Upper ? 4 - bits : bits;
+    }
+  } else if constexpr (sizeof(IntT) == 8) {
+    const __m128i vtarget = _mm_set1_epi64x(static_cast<int64_t>(target));
+    for (; i + 2 <= end; i += 2) {
+      __m128i vkeys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+      __m128i mask = Upper ? _mm_cmpgt_epi64(vkeys, vtarget) : _mm_cmpgt_epi64(vtarget, vkeys);
+      int bits = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(mask)));
+      count += Upper ? 2 - bits : bits;
+    }
+  }
+#endif
+  for (; i < end; i++) {
+    count += static_cast<int>(Before<IntT, Upper>(keys[i], target));
+  }
+  return count;
+}
+
+}  // namespace key_search_internal
+
+/**
+ * Search sorted integer keys embedded in fixed size entries.
+ * @param base address of the first key
+ * @param stride distance in bytes between two consecutive keys
+ * @param begin first index to consider
+ * @param end one past the last index to consider
+ * @param target key to search for
+ * @return the first index in [begin, end) whose key is >= target (> target if Upper), end if there is none
+ */
+template <typename IntT, bool Upper = false>
+inline int StridedKeySearch(const char *base, size_t stride, int begin, int end, IntT target) {
+  using key_search_internal::Before;
+  using key_search_internal::LoadKey;
+  while (end - begin > KEY_SEARCH_WINDOW) {
+    int mid = begin + (end - begin) / 2;
+    if (Before<IntT, Upper>(LoadKey<IntT>(base + mid * stride), target)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin + key_search_internal::CountStrided<IntT, Upper>(base, stride, begin, end, target);
+}
+
+/**
+ * Search a contiguous sorted array of integer keys.
+ * @return the first index in [0, size) whose key is >= target (> target if Upper), size if there is none
+ */
+template <typename IntT, bool Upper = false>
+inline int ContiguousKeySearch(const IntT *keys, int size, IntT target) {
+  using key_search_internal::Before;
+  int begin = 0;
+  int end = size;
+  while (end - begin > KEY_SEARCH_WINDOW) {
+    int mid = begin + (end - begin) / 2;
+    if (Before<IntT, Upper>(keys[mid], target)) {
+      begin = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return begin + key_search_internal::CountContiguous<IntT, Upper>(keys, begin, end, target);
+}
+
+/**
+ * Search sorted keys that are plain signed integers of the given byte width, stored at base + i * stride.
+ * @param target raw bytes of the search key, in the same encoding as the stored keys
+ * @return the lower (or upper) bound position in [begin, end)
+ */
+template <bool Upper = false>
+inline int IntegerKeySearch(const char *base, size_t stride, int begin, int end, const char *target, int width) {
+  using key_search_internal::LoadKey;
+  switch (width) {
+    case 1:
+      return StridedKeySearch<int8_t, Upper>(base, stride, begin, end, LoadKey<int8_t>(target));
+    case 2:
+      return StridedKeySearch<int16_t, Upper>(base, stride, begin, end, LoadKey<int16_t>(target));
+    case 4:
+      return StridedKeySearch<int32_t, Upper>(base, stride, begin, end, LoadKey<int32_t>(target));
+    default:
+      return StridedKeySearch<int64_t, Upper>(base, stride, begin, end, LoadKey<int64_t>(target));
+  }
+}
+
+/**
+ * Find an entry by its one byte fingerprint before comparing any key. The fingerprints of a page are kept in their own
+ * array and compared 32 (AVX2) or 16 (SSE) at a time, match is only called for the few entries whose fingerprint
+ * equals the target.
+ * @param fingerprints fingerprint of every entry, fingerprints[i] belongs to entry i
+ * @param match called with the index of a candidate entry, returns true if it is the entry looked for
+ * @return the first index in [begin, end) whose fingerprint equals fingerprint and that match accepts, end if none
+ */
+template <typename Match>
+inline int FingerprintSearch(const uint8_t *fingerprints, int begin, int end, uint8_t fingerprint, Match &&match) {
+  int i = begin;
+#if defined(__AVX2__)
+  const __m256i vtarget = _mm256_set1_epi8(static_cast<char>(fingerprint));
+  for (; i + 32 <= end; i += 32) {
+    __m256i vfingerprints = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(fingerprints + i));
+    auto bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(vfingerprints, vtarget)));
+    for (; bits != 0; bits &= bits - 1) {
+      int index = i + __builtin_ctz(bits);
+      if (match(index)) {
+        return index;
+      }
+    }
+  }
+#elif defined(__SSE4_2__)
+  const __m128i vtarget = _mm_set1_epi8(static_cast<char>(fingerprint));
+  for (; i + 16 <= end; i += 16) {
+    __m128i vfingerprints = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints + i));
+    auto bits = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(vfingerprints, vtarget)));
+    for (; bits != 0; bits &= bits - 1) {
+      int index = i + __builtin_ctz(bits);
+      if (match(index)) {
+        return index;
+      }
+    }
+  }
+#endif
+  for (; i < end; i++) {
+    if (fingerprints[i] == fingerprint && match(i)) {
+      return i;
+    }
+  }
+  return end;
+}
+
+}  // namespace bustub
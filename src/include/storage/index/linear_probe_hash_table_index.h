@@ -14,6 +14,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "container/hash/hash_function.h"
@@ -24,6 +25,10 @@ namespace bustub {
 
 #define HASH_TABLE_INDEX_TYPE LinearProbeHashTableIndex<KeyType, ValueType, KeyComparator>
 
+/**
+ * Index backed by a LinearProbeHashTable. It only answers equality lookups: ScanRange accepts nothing but a range of a
+ * single key, and the entries carry no included columns.
+ */
 template <typename KeyType, typename ValueType, typename KeyComparator>
 class LinearProbeHashTableIndex : public Index {
  public:
@@ -38,6 +43,13 @@ class LinearProbeHashTableIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  void ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key, bool high_inclusive,
+                 std::vector<RID> *result, Transaction *transaction, ScanDirection direction = ScanDirection::FORWARD,
+                 std::vector<Tuple> *entries = nullptr, uint32_t bound_columns = 0) override;
+
+  // insert many (key, rid) entries into the index, growing the table once up front instead of step by step
+  void BulkInsert(const std::vector<std::pair<KeyType, ValueType>> &entries);
+
  protected:
   // comparator for key
   KeyComparator comparator_;
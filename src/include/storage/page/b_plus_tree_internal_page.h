@@ -17,7 +17,7 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_HEADER_SIZE 32
 #define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
@@ -27,28 +27,84 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Keys are suffix truncated: only the first KeyWidth bytes of every key are
+ * stored, the rest of a KeyType is zero when it is read back. A GenericKey<N>
+ * is often much larger than the columns it holds, so a page fits as many
+ * separators as the real key size allows instead of sizeof(KeyType).
+ *
+ * Internal page format for fixed width keys (keys are stored in increasing order):
  *  --------------------------------------------------------------------------
  * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
  *  --------------------------------------------------------------------------
+ *
+ * Keys with variable length columns use a slotted format instead. Each slot
+ * holds where its key is and how many bytes of it are stored, the key bytes
+ * are kept without their trailing zeros in a heap growing down from the end of
+ * the page, so a short string takes a few bytes instead of KeyWidth. Such a
+ * page is full once its free space is below one entry of KeyWidth bytes rather
+ * than after max size entries. Leaf pages of such a tree are slotted the same
+ * way, and since a KeyType never holds more than its KeySize bytes no key
+ * needs an overflow page.
+ *  ----------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | ... | SLOT(n) | free space | KEY(n) ... KEY(1) (any order) |
+ *  ----------------------------------------------------------------------------
+ *  SLOT(i): KeyOffset (2) | KeyLength (2) | PAGE_ID(i)
+ *
+ *  Header format (size in byte, 32 bytes in total):
+ *  -------------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4)
+ *  -------------------------------------------------------------------------
+ *  ----------------------------------------------------------
+ * | PageId (4) | KeyWidth (4) | HeapBegin (2) | KeyBytes (2) |
+ *  ----------------------------------------------------------
+ *  HeapBegin is 0 for fixed width keys, KeyBytes counts the key bytes slots
+ *  still refer to.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
  public:
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTERNAL_PAGE_SIZE,
+            int key_width = sizeof(KeyType), bool slotted = false);
 
+  // the largest max size that leaves room for the extra entry a page holds before it splits
+  static int MaxSizeForKeyWidth(int key_width) {
+    return (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (key_width + sizeof(ValueType)) - 1;
+  }
+
+  // the largest max size of a slotted page, it is reached only if most keys are empty
+  static int MaxSizeForSlottedKeys() { return (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / SlotSize() - 1; }
+
+  int GetKeyWidth() const { return key_width_; }
+  bool IsSlotted() const { return heap_begin_ != 0; }
   KeyType KeyAt(int index) const;
   void SetKeyAt(int index, const KeyType &key);
   int ValueIndex(const ValueType &value) const;
   ValueType ValueAt(int index) const;
 
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+  ValueType LookupFirst(const KeyType &key, const KeyComparator &comparator) const;
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  // append a child when bulk loading, the caller sets the child's parent page id
+  void AppendChild(const KeyType &key, const ValueType &value);
   void Remove(int index);
   ValueType RemoveAndReturnOnlyChild();
 
+  // Space checks, for fixed width keys they only compare the size against max size.
+  // true once the page holds more than it may keep and has to be split
+  bool IsFull() const;
+  // true if the page cannot become full by inserting one more entry
+  bool HasRoomForInsert() const;
+  // true if the page is below min_size entries, and below half of its space when slotted, once removed entries are gone
+  bool IsUnderfull(int min_size, int removed = 0) const;
+  // true if sibling and the separator between the two fit in this page without making it full
+  bool CanMergeWith(const BPlusTreeInternalPage *sibling, const KeyType &middle_key) const;
+  // true if the page is not full after the key at index is replaced
+  bool CanSetKeyAt(int index, const KeyType &key) const;
+  // true if a child can be appended while bulk loading, leaving room for one more entry
+  bool CanAppendChild(const KeyType &key) const;
+
   // Split and Merge utility methods
   void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
   void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
@@ -58,9 +114,33 @@ class BPlusTreeInternalPage : public BPlusTreePage {
                          BufferPoolManager *buffer_pool_manager);
 
  private:
-  void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
-  void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  MappingType array[0];
+  // entries are key_width_ bytes of key followed by the value
+  int EntrySize() const { return key_width_ + sizeof(ValueType); }
+  char *EntryAt(int index) { return data_ + index * EntrySize(); }
+  const char *EntryAt(int index) const { return data_ + index * EntrySize(); }
+  // slots are the key offset and length followed by the value
+  static constexpr int SlotSize() { return 2 * sizeof(uint16_t) + sizeof(ValueType); }
+  char *SlotAt(int index) { return data_ + index * SlotSize(); }
+  const char *SlotAt(int index) const { return data_ + index * SlotSize(); }
+  static constexpr int Capacity() { return PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE; }
+  // space taken by the largest entry, a page that has less free space than this is full
+  int MaxEntrySize() const { return IsSlotted() ? SlotSize() + key_width_ : EntrySize(); }
+  int UsedSpace() const { return IsSlotted() ? GetSize() * SlotSize() + key_bytes_ : GetSize() * EntrySize(); }
+  int FreeSpace() const { return Capacity() - UsedSpace(); }
+  // bytes a slotted page keeps of key, its trailing zeros are dropped and restored by KeyAt
+  int StoredLength(const KeyType &key) const;
+  uint16_t KeyLengthAt(int index) const;
+  void InsertEntry(int index, const KeyType &key, const ValueType &value);
+  void PutKey(int index, const KeyType &key);
+  void CompactKeys();
+  void Truncate(int size);
+  void SetValueAt(int index, const ValueType &value);
+  void CopyNFrom(const BPlusTreeInternalPage *source, int index, int size, BufferPoolManager *buffer_pool_manager);
+  void CopyLastFrom(const KeyType &key, const ValueType &value, BufferPoolManager *buffer_pool_manager);
+  void CopyFirstFrom(const KeyType &key, const ValueType &value, BufferPoolManager *buffer_pool_manager);
+  int key_width_;
+  uint16_t heap_begin_;
+  uint16_t key_bytes_;
+  char data_[0];
 };
 }  // namespace bustub
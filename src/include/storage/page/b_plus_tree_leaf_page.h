@@ -18,56 +18,155 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_HEADER_SIZE 40
 #define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
- * page. Only support unique key.
+ * page. Equal keys are allowed if the tree is not unique, they are kept in
+ * insertion order.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Leaf page format for fixed width keys (keys are stored in order):
+ *  ----------------------------------------------------------------------------------------
+ * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n) | free | FP(1) ... FP(n)
+ *  ----------------------------------------------------------------------------------------
  *
- *  Header format (size in byte, 28 bytes in total):
+ * Keys with variable length columns use the slotted format of the internal
+ * pages: a slot holds where its key is, how many bytes of it are stored and
+ * the RID, the key bytes are kept without their trailing zeros in a heap
+ * growing down from the fingerprints (or the end of the page). Such a page is
+ * full once its free space is below one entry of sizeof(KeyType) bytes rather
+ * than after max size entries, so short strings fill a leaf with many more
+ * entries. Entries are not addressable in place, GetItem returns a copy. A
+ * KeyType never holds more than its KeySize bytes, so no key needs an
+ * overflow page.
+ *  -----------------------------------------------------------------------------------------------
+ * | HEADER | SLOT(1) | ... | SLOT(n) | free | KEY(n) ... KEY(1) (any order) | FP(1) ... FP(max) |
+ *  -----------------------------------------------------------------------------------------------
+ *  SLOT(i): KeyOffset (2) | KeyLength (2) | RID(i)
+ *
+ *  Header format (size in byte, 40 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  ----------------------------------------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | PrevPageId (4) | FingerprintOffset (2) | FingerprintWidth (2) |
+ *  ----------------------------------------------------------------------------------------------------------------
+ *  ------------------------------------
+ * | HeapBegin (2) | KeyBytes (2) |
+ *  ------------------------------------
+ *  HeapBegin is 0 for fixed width keys, KeyBytes counts the key bytes slots
+ *  still refer to.
+ *
+ * Leaves of a tree whose keys cannot be searched as integers may keep a one
+ * byte hash of every key, FP(i), in an array behind the room for max size
+ * entries, or at the end of a slotted page. A point lookup compares the
+ * fingerprints with SIMD and only calls the comparator for the entries whose
+ * fingerprint matches, so a miss usually compares no key at all.
+ * FingerprintOffset is 0 if the page has none. FingerprintWidth is the number
+ * of leading key bytes the comparator looks at; the bytes after them hold the
+ * included columns of a covering index, which a probe built from the key
+ * columns alone does not have.
+ *
+ * NextPageId is protected by this page's latch. PrevPageId is only a hint for
+ * reverse scans: it is updated by whoever relinks the left neighbour, without
+ * holding this page's latch, so it is accessed atomically and readers must check
+ * that the previous page still points back here.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
  public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE);
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = LEAF_PAGE_SIZE,
+            bool fingerprints = false, int key_width = sizeof(KeyType), bool slotted = false);
+  // the largest max size that leaves room for a fingerprint per entry
+  static int MaxSizeWithFingerprints() {
+    return (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(MappingType) + sizeof(uint8_t));
+  }
+  // the largest max size of a slotted page, it is reached only if most keys are empty
+  static int MaxSizeForSlottedKeys(bool fingerprints) {
+    return (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (SlotSize() + (fingerprints ? sizeof(uint8_t) : 0)) - 1;
+  }
+  bool HasFingerprints() const { return fingerprint_offset_ != 0; }
+  bool IsSlotted() const { return heap_begin_ != 0; }
   // helper methods
   page_id_t GetNextPageId() const;
   void SetNextPageId(page_id_t next_page_id);
+  page_id_t GetPrevPageId() const;
+  void SetPrevPageId(page_id_t prev_page_id);
   KeyType KeyAt(int index) const;
+  ValueType ValueAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
-  const MappingType &GetItem(int index);
+  int UpperKeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  MappingType GetItem(int index) const;
 
   // insert and delete methods
-  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator, bool unique = true);
   bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+  int RemoveAndDeleteRecord(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
+  // Space checks, for fixed width keys they only compare the size against max size.
+  // true once the page holds as many entries as it may keep and has to be split
+  bool IsFull() const;
+  // true if the page cannot become full by inserting one more entry
+  bool HasRoomForInsert() const;
+  // true if the page is below min_size entries, and below half of its space when slotted, once removed entries are gone
+  bool IsUnderfull(int min_size, int removed = 0) const;
+  // true if the entries of sibling fit in this page without making it full
+  bool CanMergeWith(const BPlusTreeLeafPage *sibling) const;
+  // true if key can be appended while bulk loading, leaving room for one more entry
+  bool CanAppend(const KeyType &key) const;
 
   // Split and Merge utility methods
   void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void MoveTailTo(BPlusTreeLeafPage *recipient, int size);
   void MoveAllTo(BPlusTreeLeafPage *recipient);
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+  // append sorted items, also used to fill leaves when bulk loading
+  void CopyNFrom(const MappingType *items, int size);
 
  private:
-  void CopyNFrom(MappingType *items, int size);
+  // a hash of the first FingerprintWidth bytes of key, the bytes a key does not use are zero so equal keys have equal
+  // fingerprints
+  uint8_t Fingerprint(const KeyType &key) const;
+  uint8_t *Fingerprints() { return reinterpret_cast<uint8_t *>(this) + fingerprint_offset_; }
+  const uint8_t *Fingerprints() const { return reinterpret_cast<const uint8_t *>(this) + fingerprint_offset_; }
+  // index of the first entry equal to key (holding value too if it is given), GetSize() if there is none
+  int FindEntry(const KeyType &key, const ValueType *value, const KeyComparator &comparator) const;
+  // keep the fingerprints in step with an entry inserted at or removed from index, before the size changes
+  void InsertFingerprint(int index, const KeyType &key);
+  void RemoveFingerprint(int index);
+  // slots are the key offset and length followed by the value
+  static constexpr int SlotSize() { return 2 * sizeof(uint16_t) + sizeof(ValueType); }
+  char *Data() { return reinterpret_cast<char *>(array); }
+  const char *Data() const { return reinterpret_cast<const char *>(array); }
+  char *SlotAt(int index) { return Data() + index * SlotSize(); }
+  const char *SlotAt(int index) const { return Data() + index * SlotSize(); }
+  // bytes between the header and the fingerprints
+  int Capacity() const { return (HasFingerprints() ? fingerprint_offset_ : PAGE_SIZE) - LEAF_PAGE_HEADER_SIZE; }
+  // space taken by the largest entry, a slotted page that has less free space than this is full
+  static constexpr int MaxEntrySize() { return SlotSize() + sizeof(KeyType); }
+  int UsedSpace() const { return GetSize() * SlotSize() + key_bytes_; }
+  int FreeSpace() const { return Capacity() - UsedSpace(); }
+  // bytes a slotted page keeps of key, its trailing zeros are dropped and restored by KeyAt
+  static int StoredLength(const KeyType &key);
+  uint16_t KeyLengthAt(int index) const;
+  void InsertEntry(int index, const KeyType &key, const ValueType &value);
+  void RemoveEntry(int index);
+  void CompactKeys();
+  void Truncate(int size);
   void CopyLastFrom(const MappingType &item);
   void CopyFirstFrom(const MappingType &item);
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
+  uint16_t fingerprint_offset_;
+  uint16_t fingerprint_width_;
+  uint16_t heap_begin_;
+  uint16_t key_bytes_;
   MappingType array[0];
 };
 }  // namespace bustub
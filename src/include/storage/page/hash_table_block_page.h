@@ -13,6 +13,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -26,9 +27,11 @@ namespace bustub {
  * non-unique keys.
  *
  * Block page format (keys are stored in order):
- *  ----------------------------------------------------------------
- * | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
- *  ----------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------------
+ * | OCCUPIED | READABLE | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ------------------------------------------------------------------------------------------
+ *
+ *  OCCUPIED and READABLE are bitmaps of BLOCK_BITMAP_WORDS 64 bit words each.
  *
  *  Here '+' means concatenation.
  *
@@ -93,11 +96,27 @@ class HashTableBlockPage {
    */
   bool IsReadable(slot_offset_t bucket_ind) const;
 
+  /**
+   * Returns 64 occupied flags at once, so that a probe can skip over a run of slots with a few bit operations.
+   *
+   * @param word_ind index of the word, it holds the flags of indexes 64 * word_ind to 64 * word_ind + 63
+   * @return the occupied flags, bit i for index 64 * word_ind + i; bits past BLOCK_ARRAY_SIZE are 0
+   */
+  uint64_t OccupiedWord(size_t word_ind) const;
+
+  /**
+   * Returns 64 readable flags at once, laid out like OccupiedWord.
+   *
+   * @param word_ind index of the word
+   * @return the readable flags, bit i for index 64 * word_ind + i
+   */
+  uint64_t ReadableWord(size_t word_ind) const;
+
  private:
-  std::atomic_char occupied_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  std::atomic<uint64_t> occupied_[BLOCK_BITMAP_WORDS];
 
   // 0 if tombstone/brand new (never occupied), 1 otherwise.
-  std::atomic_char readable_[(BLOCK_ARRAY_SIZE - 1) / 8 + 1];
+  std::atomic<uint64_t> readable_[BLOCK_BITMAP_WORDS];
   MappingType array_[0];
 };
 
@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_bucket_page.h
+//
+// Identification: src/include/storage/page/hash_table_bucket_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/index/int_comparator.h"
+#include "storage/page/hash_table_page_defs.h"
+
+namespace bustub {
+/**
+ * Bucket page of the extendible hash table. Stores indexed key and value
+ * together, without any order. Supports non-unique keys.
+ *
+ * The entries are kept dense: a remove moves the last entry into the hole.
+ * A bucket that no split can separate, because all of its keys hash alike,
+ * continues in a chain of overflow pages linked by NextPageId. Every page of
+ * a chain but the last one is full.
+ *
+ * Bucket page format:
+ *  ----------------------------------------------------------------
+ * | HEADER | KEY(1) + VALUE(1) | KEY(2) + VALUE(2) | ... | KEY(n) + VALUE(n)
+ *  ----------------------------------------------------------------
+ *
+ *  Header format (size in byte, 16 bytes in total):
+ *  -------------------------------------------------
+ * | LSN (4) | NextPageId (4) | Size (4) | Unused (4) |
+ *  -------------------------------------------------
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  HashTableBucketPage() = delete;
+
+  /**
+   * Sets up an empty bucket page without overflow pages, must be called on a new page.
+   */
+  void Init();
+
+  /**
+   * @return the number of entries in this page
+   */
+  uint32_t GetSize() const;
+
+  /**
+   * @return true if no entry can be added to this page
+   */
+  bool IsFull() const;
+
+  /**
+   * Gets the key of an entry of this page.
+   *
+   * @param bucket_ind the index of the entry, less than GetSize()
+   * @return key of the entry
+   */
+  KeyType KeyAt(uint32_t bucket_ind) const;
+
+  /**
+   * Gets the value of an entry of this page.
+   *
+   * @param bucket_ind the index of the entry, less than GetSize()
+   * @return value of the entry
+   */
+  ValueType ValueAt(uint32_t bucket_ind) const;
+
+  /**
+   * Adds an entry after the last one, the page must not be full.
+   *
+   * @param key key to insert
+   * @param value value to insert
+   */
+  void Append(const KeyType &key, const ValueType &value);
+
+  /**
+   * Overwrites an entry.
+   *
+   * @param bucket_ind the index of the entry, less than GetSize()
+   * @param item the key and value to store there
+   */
+  void SetItem(uint32_t bucket_ind, const MappingType &item);
+
+  /**
+   * Removes the last entry of this page.
+   *
+   * @return the removed entry
+   */
+  MappingType PopBack();
+
+  /**
+   * Removes all entries of this page, the overflow link is kept.
+   */
+  void Clear();
+
+  /**
+   * @return the page id of the next page of the overflow chain, INVALID_PAGE_ID if this is the last one
+   */
+  page_id_t GetNextPageId() const;
+
+  /**
+   * Links the next page of the overflow chain.
+   *
+   * @param next_page_id the page id of the next page, INVALID_PAGE_ID to end the chain here
+   */
+  void SetNextPageId(page_id_t next_page_id);
+
+ private:
+  __attribute__((unused)) lsn_t lsn_;
+  page_id_t next_page_id_;
+  uint32_t size_;
+  __attribute__((unused)) uint32_t unused_;
+  MappingType array_[0];
+};
+
+}  // namespace bustub
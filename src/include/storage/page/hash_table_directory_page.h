@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_table_directory_page.h
+//
+// Identification: src/include/storage/page/hash_table_directory_page.h
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Directory page of the extendible hash table.
+ *
+ * The directory has 2^GlobalDepth slots. A key belongs to the slot given by
+ * the low GlobalDepth bits of its hash. Each slot holds the page id of a
+ * bucket page and the local depth of that bucket: the bucket holds the keys
+ * whose low LocalDepth hash bits are those of the slot, so 2^(GlobalDepth -
+ * LocalDepth) slots point to it.
+ *
+ * Directory format (size in byte):
+ * --------------------------------------------------------------------------------------------
+ * | LSN (4) | PageId (4) | GlobalDepth (4) | LocalDepths (512) | BucketPageIds (4 * 512) |
+ * --------------------------------------------------------------------------------------------
+ */
+class HashTableDirectoryPage {
+ public:
+  /** The deepest the directory gets, so that its slots fit a page. */
+  static constexpr uint32_t MAX_DEPTH = 9;
+  static constexpr uint32_t DIRECTORY_ARRAY_SIZE = 1 << MAX_DEPTH;
+
+  /**
+   * Sets up a directory of global depth 0, must be called on a new page.
+   *
+   * @param page_id the page id of this page
+   * @param bucket_page_id the page id of the bucket the single slot points to
+   */
+  void Init(page_id_t page_id, page_id_t bucket_page_id);
+
+  /**
+   * @return the page ID of this page
+   */
+  page_id_t GetPageId() const;
+
+  /**
+   * @return the lsn of this page
+   */
+  lsn_t GetLSN() const;
+
+  /**
+   * Sets the LSN of this page
+   *
+   * @param lsn the log sequence number for the lsn field to be set to
+   */
+  void SetLSN(lsn_t lsn);
+
+  /**
+   * @return the global depth of the directory
+   */
+  uint32_t GetGlobalDepth() const;
+
+  /**
+   * @return a mask of the low GlobalDepth bits, which map a hash to its slot
+   */
+  uint32_t GetGlobalDepthMask() const;
+
+  /**
+   * @return the number of slots, 2^GlobalDepth
+   */
+  uint32_t Size() const;
+
+  /**
+   * Doubles the directory. The new upper half of the slots points to the same buckets as the lower half.
+   */
+  void IncrGlobalDepth();
+
+  /**
+   * Halves the directory, only allowed if CanShrink().
+   */
+  void DecrGlobalDepth();
+
+  /**
+   * @return true if every bucket has a local depth below the global depth, so each is pointed to by both halves
+   */
+  bool CanShrink() const;
+
+  /**
+   * @param bucket_idx the slot
+   * @return the page id of the bucket the slot points to
+   */
+  page_id_t GetBucketPageId(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx the slot
+   * @param bucket_page_id the page id of the bucket the slot points to
+   */
+  void SetBucketPageId(uint32_t bucket_idx, page_id_t bucket_page_id);
+
+  /**
+   * @param bucket_idx the slot
+   * @return the local depth of the bucket the slot points to
+   */
+  uint32_t GetLocalDepth(uint32_t bucket_idx) const;
+
+  /**
+   * @param bucket_idx the slot
+   * @param local_depth the local depth of the bucket the slot points to
+   */
+  void SetLocalDepth(uint32_t bucket_idx, uint32_t local_depth);
+
+  /**
+   * The split image of a slot is the slot that differs in the highest bit of its local depth, the bucket a split
+   * would move half of the keys to and the one a merge joins.
+   *
+   * @param bucket_idx the slot, its local depth must be above 0
+   * @return the slot of the split image
+   */
+  uint32_t GetSplitImageIndex(uint32_t bucket_idx) const;
+
+ private:
+  __attribute__((unused)) lsn_t lsn_;
+  page_id_t page_id_;
+  uint32_t global_depth_;
+  uint8_t local_depths_[DIRECTORY_ARRAY_SIZE];
+  page_id_t bucket_page_ids_[DIRECTORY_ARRAY_SIZE];
+};
+
+}  // namespace bustub
@@ -14,11 +14,21 @@
 
 #define MappingType std::pair<KeyType, ValueType>
 
-/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in   * a block page. It is an approximate
+/** BLOCK_ARRAY_SIZE is the number of (key, value) pairs that can be stored in a block page. It is an approximate
  * calculation based on the size of MappingType (which is a std::pair of KeyType and ValueType). For each key/value
- * pair, we need two additional bits for occupied_ and readable_. 4 * PAGE_SIZE / (4 * sizeof (MappingType) + 1) =
- * PAGE_SIZE/(sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the space required to maintain the occupied
- * and readable flags for a key value pair.*/
-#define BLOCK_ARRAY_SIZE (4 * PAGE_SIZE / (4 * sizeof(MappingType) + 1))
+ * pair, we need two additional bits for occupied_ and readable_. The flags are kept in 64 bit words, which round
+ * each bitmap up by at most 8 bytes, so 16 bytes are set aside for that. 4 * (PAGE_SIZE - 16) / (4 *
+ * sizeof (MappingType) + 1) = (PAGE_SIZE - 16) / (sizeof (MappingType) + 0.25) because 0.25 bytes = 2 bits is the
+ * space required to maintain the occupied and readable flags for a key value pair.*/
+#define BLOCK_ARRAY_SIZE (4 * (PAGE_SIZE - 16) / (4 * sizeof(MappingType) + 1))
+
+/** BLOCK_BITMAP_WORDS is the number of 64 bit words of the occupied_ and readable_ bitmaps of a block page. */
+#define BLOCK_BITMAP_WORDS ((BLOCK_ARRAY_SIZE - 1) / 64 + 1)
 
 #define HASH_TABLE_BLOCK_TYPE HashTableBlockPage<KeyType, ValueType, KeyComparator>
+
+/** BUCKET_ARRAY_SIZE is the number of (key, value) pairs that fit a bucket page of the extendible hash table, behind
+ * its 16 byte header. */
+#define BUCKET_ARRAY_SIZE ((PAGE_SIZE - 16) / sizeof(MappingType))
+
+#define HASH_TABLE_BUCKET_TYPE HashTableBucketPage<KeyType, ValueType, KeyComparator>
@@ -21,14 +21,27 @@ namespace bustub {
  * our case, we will contain information about table/index name (length less than
  * 32 bytes) and their corresponding root_id
  *
+ * Records are found through an open addressing hash table of record numbers
+ * (record index + 1, 0 marks a free slot), so a lookup compares one or two names
+ * instead of scanning every record. Names are hashed with murmur3 and a fixed
+ * seed, so the slots mean the same to every build that reads the page.
+ *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  -------------------------------------------------------------------------------------
+ * | RecordCount (4) | Slots (128) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
+ *  -------------------------------------------------------------------------------------
+ *  The top bit of RecordCount is set in this format. Pages written before the
+ *  slots existed have it clear and their records right after RecordCount; they
+ *  are searched record by record until the first write converts them, which
+ *  happens as soon as their records fit the hashed format. An all zero page is
+ *  such an old page without records, so it is a valid empty header.
  */
 class HeaderPage : public Page {
  public:
-  void Init() { SetRecordCount(0); }
+  void Init() {
+    SetCountWord(HASHED_FORMAT);
+    RebuildSlots();
+  }
   /**
    * Record related
    */
@@ -40,12 +53,50 @@ class HeaderPage : public Page {
   bool GetRootId(const std::string &name, page_id_t *root_id);
   int GetRecordCount();
 
+  static constexpr int HASH_SLOT_COUNT = 128;
+  static constexpr int RECORD_SIZE = 36;
+  static constexpr int RECORDS_OFFSET = 4 + HASH_SLOT_COUNT;
+  static constexpr int MAX_RECORD_COUNT = (PAGE_SIZE - RECORDS_OFFSET) / RECORD_SIZE;
+  // where the records of a page without slots start, and how many it holds
+  static constexpr int UNHASHED_RECORDS_OFFSET = 4;
+  static constexpr int UNHASHED_MAX_RECORD_COUNT = (PAGE_SIZE - UNHASHED_RECORDS_OFFSET) / RECORD_SIZE;
+
  private:
+  static constexpr uint32_t HASHED_FORMAT = 1U << 31;
+  static constexpr uint32_t HASH_SEED = 0;
+
   /**
    * helper functions
    */
   int FindRecord(const std::string &name);
 
+  // keeps the format bit
   void SetRecordCount(int record_count);
+
+  uint32_t CountWord() {
+    uint32_t word;
+    memcpy(&word, GetData(), sizeof(word));
+    return word;
+  }
+
+  void SetCountWord(uint32_t word) { memcpy(GetData(), &word, sizeof(word)); }
+
+  bool IsHashed() { return (CountWord() & HASHED_FORMAT) != 0; }
+
+  // move the records of an old page behind the slots if they fit there
+  void ConvertToHashed();
+
+  char *RecordAt(int index) {
+    return GetData() + (IsHashed() ? RECORDS_OFFSET : UNHASHED_RECORDS_OFFSET) + index * RECORD_SIZE;
+  }
+
+  uint8_t *Slots() { return reinterpret_cast<uint8_t *>(GetData() + 4); }
+
+  // first slot to probe for a name
+  static int HomeSlot(const std::string &name);
+
+  void InsertSlot(const std::string &name, int index);
+
+  void RebuildSlots();
 };
 }  // namespace bustub
@@ -51,12 +51,18 @@ class Page {
   /** Acquire the page write latch. */
   inline void WLatch() { rwlatch_.WLock(); }
 
+  /** Try to acquire the page write latch without blocking, @return true on success. */
+  inline bool TryWLatch() { return rwlatch_.TryWLock(); }
+
   /** Release the page write latch. */
   inline void WUnlatch() { rwlatch_.WUnlock(); }
 
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Try to acquire the page read latch without blocking, @return true on success. */
+  inline bool TryRLatch() { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
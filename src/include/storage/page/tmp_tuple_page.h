@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstring>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
@@ -20,14 +22,54 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  void Init(page_id_t page_id, uint32_t page_size) {
+    memcpy(GetData(), &page_id, sizeof(page_id_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Append a tuple to the page.
+   * @param tuple the tuple to be stored
+   * @param[out] out the location of the stored tuple
+   * @return false if the page has no room for the tuple
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t size = sizeof(uint32_t) + tuple.GetLength();
+    if (GetFreeSpacePointer() < SIZE_TMP_TUPLE_PAGE_HEADER + size) {
+      return false;
+    }
+    uint32_t offset = GetFreeSpacePointer() - size;
+    tuple.SerializeTo(GetData() + offset);
+    SetFreeSpacePointer(offset);
+    *out = TmpTuple(GetTablePageId(), offset);
+    return true;
+  }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /** @return the offset of the tuple inserted last, the tuples run from there to the end of the page */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /**
+   * Read a tuple stored on this page.
+   * @param offset the offset of the tuple, as returned in a TmpTuple by Insert
+   * @param[out] tuple the stored tuple
+   * @return the offset of the tuple inserted before it, which is the page size after the first inserted tuple
+   */
+  uint32_t Get(uint32_t offset, Tuple *tuple) {
+    tuple->DeserializeFrom(GetData() + offset);
+    return offset + sizeof(uint32_t) + tuple->GetLength();
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
+
+  static constexpr size_t SIZE_TMP_TUPLE_PAGE_HEADER = 12;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
 };
 
 }  // namespace bustub
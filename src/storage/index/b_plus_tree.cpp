@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <string>
 
 #include "common/exception.h"
@@ -21,13 +22,33 @@
 namespace bustub {
 INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                          int leaf_max_size, int internal_max_size)
+                          int leaf_max_size, int internal_max_size, bool unique_keys)
     : index_name_(std::move(name)),
       root_page_id_(INVALID_PAGE_ID),
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(internal_max_size),
+      unique_keys_(unique_keys),
+      key_width_(comparator.KeyWidth()),
+      slotted_keys_(comparator.HasVariableLengthKeys()),
+      leaf_fingerprints_(comparator.IntegerKeyWidth() == 0 && comparator.HasBytewiseEquality()) {
+  if(slotted_keys_ && leaf_max_size_ == static_cast<int>(LEAF_PAGE_SIZE)){
+    leaf_max_size_ = LeafPage::MaxSizeForSlottedKeys(leaf_fingerprints_);
+  }else if(leaf_fingerprints_ && leaf_max_size_ == static_cast<int>(LEAF_PAGE_SIZE)){
+    leaf_max_size_ = LeafPage::MaxSizeWithFingerprints();
+  }
+  if(leaf_max_size_ > (slotted_keys_ ? LeafPage::MaxSizeForSlottedKeys(true) : LeafPage::MaxSizeWithFingerprints())){
+    leaf_fingerprints_ = false;
+  }
+  if(internal_max_size_ == static_cast<int>(INTERNAL_PAGE_SIZE)){
+    internal_max_size_ = slotted_keys_ ? InternalPage::MaxSizeForSlottedKeys()
+                                       : InternalPage::MaxSizeForKeyWidth(key_width_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_TYPE::~BPlusTree() { StopMaintenance(); }
 
 /*
  * Helper function to decide whether current b+tree is empty
@@ -38,19 +59,37 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID;
  * SEARCH
  *****************************************************************************/
 /*
- * Return the only value that associated with input key
+ * Return the only value that associated with input key, or every value of the
+ * key if the tree allows duplicates
  * This method is used for point query
  * @return : true means key exists
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  if(!unique_keys_){
+    // the duplicates may span several leaves, start at the first one and scan like an iterator
+    Page* first_page = FindLeafPageByOperation(key, Operation::FIND, transaction, false, false, true).first;
+    if(first_page == nullptr){
+      return false;
+    }
+    int index = reinterpret_cast<LeafPage*>(first_page->GetData())->KeyIndex(key, comparator_);
+    size_t old_size = result->size();
+    for(INDEXITERATOR_TYPE iter(buffer_pool_manager_, index, first_page, this);
+        !iter.isEnd() && comparator_((*iter).first, key) == 0; ++iter){
+      result->push_back((*iter).second);
+    }
+    return result->size() > old_size;
+  }
   Page* leaf_page = FindLeafPageByOperation(key, Operation::FIND, transaction, false).first;
+  if(leaf_page == nullptr){
+    return false;
+  }
   LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  
+
   ValueType value{};
   bool exist = leaf_node->Lookup(key, &value, comparator_);
   leaf_page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false); 
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), false);
   if(!exist){
     return false;
   }
@@ -58,6 +97,57 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
   return true;
 }
 
+/*
+ * Probe the keys in sorted order with a single leaf cursor. A key that lies in
+ * the cursor's leaf or the next one is found there, only keys further right
+ * descend from the root again.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *results,
+                               Transaction *transaction) {
+  results->assign(keys.size(), std::vector<ValueType>());
+  std::vector<size_t> order(keys.size());
+  for(size_t i = 0; i < order.size(); i++){
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+                   [this, &keys](size_t lhs, size_t rhs){ return comparator_(keys[lhs], keys[rhs]) < 0; });
+
+  INDEXITERATOR_TYPE iter(buffer_pool_manager_, 0, nullptr, this);
+  bool positioned = false;
+  bool exhausted = false;
+  const KeyType *prev_key = nullptr;
+  size_t prev = 0;
+  for(size_t i : order){
+    const KeyType &key = keys[i];
+    if(prev_key != nullptr && comparator_(*prev_key, key) == 0){
+      (*results)[i] = (*results)[prev];
+      continue;
+    }
+    prev_key = &key;
+    prev = i;
+    if(exhausted){
+      continue;
+    }
+    if(!positioned || !iter.SeekForward(key)){
+      // let go of the cursor's leaf first: a writer crabbing down to it may hold a page this descent needs
+      iter = INDEXITERATOR_TYPE(buffer_pool_manager_, 0, nullptr, this);
+      Page* page = FindLeafPageByOperation(key, Operation::FIND, transaction, false, false, !unique_keys_).first;
+      if(page == nullptr){
+        return;
+      }
+      int index = reinterpret_cast<LeafPage*>(page->GetData())->KeyIndex(key, comparator_);
+      iter = INDEXITERATOR_TYPE(buffer_pool_manager_, index, page, this);
+      positioned = true;
+    }
+    for(; !iter.isEnd() && comparator_((*iter).first, key) == 0; ++iter){
+      (*results)[i].push_back((*iter).second);
+    }
+    // once the cursor ran off the last leaf, every key left is past the last entry
+    exhausted = iter.isEnd();
+  }
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -70,14 +160,54 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  const std::lock_guard<std::mutex> guard(root_latch_); 
-  if(IsEmpty()){
-    StartNewTree(key, value);
-    // UnlockUnpinPages(transaction);
-    return true;
+  {
+    const std::lock_guard<std::mutex> guard(root_latch_);
+    if(IsEmpty()){
+      StartNewTree(key, value);
+      return true;
+    }
+  }
+  bool inserted;
+  if(InsertIntoLastLeaf(key, value, &inserted)){
+    return inserted;
   }
   return InsertIntoLeaf(key, value, transaction);
 }
+
+/*
+ * Fast path for appends: if the key belongs in the right most leaf and fits
+ * without a split, insert it there without descending from the root. Only the
+ * leaf is latched, it is the right most one as long as last_leaf_page_id_ still
+ * points at it after latching.
+ * @return: false if the regular insert has to be used, otherwise *inserted is
+ * the result of the insert
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::InsertIntoLastLeaf(const KeyType &key, const ValueType &value, bool *inserted) {
+  page_id_t page_id = last_leaf_page_id_.load();
+  if(page_id == INVALID_PAGE_ID){
+    return false;
+  }
+  Page* page = buffer_pool_manager_->FetchPage(page_id);
+  if(page == nullptr){
+    return false;
+  }
+  page->WLatch();
+  LeafPage* leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
+  if(last_leaf_page_id_.load() != page_id || leaf_page->GetSize() == 0 || !leaf_page->HasRoomForInsert() ||
+     comparator_(key, leaf_page->KeyAt(0)) < 0){
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return false;
+  }
+  *inserted = !unique_keys_ || !leaf_page->Lookup(key, nullptr, comparator_);
+  if(*inserted){
+    leaf_page->Insert(key, value, comparator_, unique_keys_);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, *inserted);
+  return true;
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -97,12 +227,128 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   root_page_id_ = new_page_id;
   LeafPage* root_node = reinterpret_cast<LeafPage*>(root_page->GetData());
   UpdateRootPageId(1);
-  root_node->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root_node->Init(new_page_id, INVALID_PAGE_ID, leaf_max_size_, leaf_fingerprints_, key_width_, slotted_keys_);
   root_node->Insert(key, value, comparator_);
+  last_leaf_page_id_.store(new_page_id);
 
   buffer_pool_manager_->UnpinPage(root_page->GetPageId(), true);
-  LOG_INFO("END StartNewTree key=%lld", key.ToString());
+}
+
+/*
+ * Build the tree from sorted entries without going through Insert: leaves are
+ * filled left to right and linked, then each internal level is built over the
+ * level below until a single root remains. Every level spreads its entries
+ * evenly over as few pages as possible, so all pages are at least half full.
+ * Slotted pages are filled until their space runs out instead, and the last
+ * two pages of such a level are evened out afterwards.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::vector<MappingType> &entries) {
+  const std::lock_guard<std::mutex> guard(root_latch_);
+  if(!IsEmpty()){
+    return false;
+  }
+  if(entries.empty()){
+    return true;
+  }
+  // first key and page id of every page of the level being built
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  int total = static_cast<int>(entries.size());
+  int page_count = (total + leaf_max_size_ - 2) / (leaf_max_size_ - 1);
+  LeafPage* prev_leaf = nullptr;
+  int offset = 0;
+  for(int i = 0; offset < total; i++){
+    int size = total / page_count + (i < total % page_count ? 1 : 0);
+    page_id_t page_id;
+    Page* page = buffer_pool_manager_->NewPage(&page_id);
+    if(page == nullptr){
+      throw std::runtime_error("out of memory");
+    }
+    LeafPage* leaf = reinterpret_cast<LeafPage*>(page->GetData());
+    leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_, leaf_fingerprints_, key_width_, slotted_keys_);
+    if(slotted_keys_){
+      for(size = 0; offset + size < total && leaf->CanAppend(entries[offset + size].first); size++){
+        leaf->CopyNFrom(&entries[offset + size], 1);
+      }
+    }else{
+      leaf->CopyNFrom(&entries[offset], size);
+    }
+    if(prev_leaf != nullptr){
+      leaf->SetPrevPageId(prev_leaf->GetPageId());
+      prev_leaf->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
+    }
+    level.emplace_back(offset == 0 ? entries[0].first : comparator_.Separator(entries[offset - 1].first,
+                                                                              entries[offset].first),
+                       page_id);
+    prev_leaf = leaf;
+    offset += size;
+  }
+  if(slotted_keys_ && level.size() > 1){
+    // the last leaf only got the entries the full leaves before it left over, even out the counts of the last two
+    Page* page = buffer_pool_manager_->FetchPage(prev_leaf->GetPrevPageId());
+    if(page == nullptr){
+      throw std::runtime_error("out of memory");
+    }
+    LeafPage* leaf = reinterpret_cast<LeafPage*>(page->GetData());
+    if(prev_leaf->GetSize() + 1 < leaf->GetSize()){
+      while(prev_leaf->GetSize() + 1 < leaf->GetSize() && prev_leaf->HasRoomForInsert()){
+        leaf->MoveLastToFrontOf(prev_leaf);
+      }
+      level.back().first = comparator_.Separator(leaf->KeyAt(leaf->GetSize() - 1), prev_leaf->KeyAt(0));
+    }
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
+  }
+  last_leaf_page_id_.store(prev_leaf->GetPageId());
+  buffer_pool_manager_->UnpinPage(prev_leaf->GetPageId(), true);
 
+  while(level.size() > 1){
+    std::vector<std::pair<KeyType, page_id_t>> parent_level;
+    int child_count = static_cast<int>(level.size());
+    page_count = (child_count + internal_max_size_ - 1) / internal_max_size_;
+    offset = 0;
+    for(int i = 0; offset < child_count; i++){
+      // fixed width separators are spread evenly, slotted pages take children until their space runs out
+      int end = slotted_keys_ ? child_count : offset + child_count / page_count + (i < child_count % page_count ? 1 : 0);
+      page_id_t page_id;
+      Page* page = buffer_pool_manager_->NewPage(&page_id);
+      if(page == nullptr){
+        throw std::runtime_error("out of memory");
+      }
+      InternalPage* node = reinterpret_cast<InternalPage*>(page->GetData());
+      node->Init(page_id, INVALID_PAGE_ID, internal_max_size_, key_width_, slotted_keys_);
+      int j = offset;
+      for(; j < end && node->CanAppendChild(level[j].first); j++){
+        node->AppendChild(level[j].first, level[j].second);
+        Page* child_page = buffer_pool_manager_->FetchPage(level[j].second);
+        reinterpret_cast<BPlusTreePage*>(child_page->GetData())->SetParentPageId(page_id);
+        buffer_pool_manager_->UnpinPage(level[j].second, true);
+      }
+      parent_level.emplace_back(level[offset].first, page_id);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      offset = j;
+    }
+    if(slotted_keys_ && parent_level.size() > 1){
+      // the last page only got the children the full pages before it left over, even out the counts of the last two
+      Page* prev_page = buffer_pool_manager_->FetchPage(parent_level[parent_level.size() - 2].second);
+      Page* last_page = buffer_pool_manager_->FetchPage(parent_level.back().second);
+      if(prev_page == nullptr || last_page == nullptr){
+        throw std::runtime_error("out of memory");
+      }
+      InternalPage* prev_node = reinterpret_cast<InternalPage*>(prev_page->GetData());
+      InternalPage* last_node = reinterpret_cast<InternalPage*>(last_page->GetData());
+      while(last_node->GetSize() + 1 < prev_node->GetSize() && last_node->HasRoomForInsert()){
+        prev_node->MoveLastToFrontOf(last_node, parent_level.back().first, buffer_pool_manager_);
+        parent_level.back().first = last_node->KeyAt(0);
+      }
+      buffer_pool_manager_->UnpinPage(prev_node->GetPageId(), true);
+      buffer_pool_manager_->UnpinPage(last_node->GetPageId(), true);
+    }
+    level = std::move(parent_level);
+  }
+  root_page_id_ = level[0].second;
+  UpdateRootPageId(1);
+  return true;
 }
 
 /*
@@ -110,17 +356,20 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
- * @return: since we only support unique key, if user try to insert duplicate
- * keys return false, otherwise return true.
+ * @return: if the tree only supports unique key and user try to insert
+ * duplicate keys return false, otherwise return true.
  */
 
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  // LOG_INFO("ENTER InsertIntoLeaf key=%lld", key.ToString());
   auto [page, root_page_latch_]= FindLeafPageByOperation(key, Operation::INSERT, transaction, false);
+  if(page == nullptr){
+    // the tree was emptied after Insert() looked at it, start over
+    return Insert(key, value, transaction);
+  }
   LeafPage* leaf_page = reinterpret_cast<LeafPage*>(page->GetData());
   // key已经存在
-  if(leaf_page->Lookup(key, nullptr, comparator_)){
+  if(unique_keys_ && leaf_page->Lookup(key, nullptr, comparator_)){
     if(root_page_latch_){
       root_latch_.unlock();
     }
@@ -130,29 +379,27 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
     return false;
   }
   // key不存在，进行插入
-  // LOG_INFO("ENTER InsertIntoLeaf key=%lld", key.ToString());
-  int new_size = leaf_page->Insert(key, value, comparator_);
+  int new_size = leaf_page->Insert(key, value, comparator_, unique_keys_);
   // 需要进行分裂
-  LOG_INFO("new_size is %d and leaf_max_size is %d", new_size, leaf_max_size_);
-  if(new_size < leaf_max_size_){
+  if(!leaf_page->IsFull()){
     if(root_page_latch_){
       root_latch_.unlock();
     }
-    // UnlockUnpinPages(transaction);
+    UnlockUnpinPages(transaction);
     page->WUnlatch();
     buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
-    LOG_INFO("END InsertIntoLeaf no split! key=%lld ", key.ToString());
     return true;
   } 
-  LOG_INFO("END InsertIntoLeaf with split! key=%lld", key.ToString());
-  LeafPage* new_leaf_page =  Split(leaf_page);
-  bool pointer_root_page_latch_ = root_page_latch_;
-  InsertIntoParent(leaf_page, new_leaf_page->KeyAt(0), new_leaf_page, transaction, pointer_root_page_latch_);
+  // appending at the end of the right most leaf: keep it nearly full, the keys that follow go to the new leaf
+  bool right_edge = leaf_page->GetNextPageId() == INVALID_PAGE_ID &&
+                    comparator_(leaf_page->KeyAt(new_size - 1), key) == 0;
+  LeafPage* new_leaf_page =  Split(leaf_page, right_edge);
+  KeyType separator = comparator_.Separator(leaf_page->KeyAt(leaf_page->GetSize() - 1), new_leaf_page->KeyAt(0));
+  InsertIntoParent(leaf_page, separator, new_leaf_page, transaction, root_page_latch_);
 
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
   buffer_pool_manager_->UnpinPage(new_leaf_page->GetPageId(), true);
-  // LOG_INFO("END InsertIntoLeaf with split! key=%lld", key.ToString());
   return true;
 }
 
@@ -168,7 +415,7 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-N *BPLUSTREE_TYPE::Split(N *node) {
+N *BPLUSTREE_TYPE::Split(N *node, bool right_edge) {
   page_id_t page_id = INVALID_PAGE_ID;
   Page* new_page = buffer_pool_manager_->NewPage(&page_id);
   if(new_page == nullptr){
@@ -178,17 +425,28 @@ N *BPLUSTREE_TYPE::Split(N *node) {
   if(node->IsLeafPage()){
     LeafPage* new_leaf_node = reinterpret_cast<LeafPage*>(new_node);
     LeafPage* old_leaf_node = reinterpret_cast<LeafPage*>(node);
-    new_leaf_node->Init(page_id, old_leaf_node->GetParentPageId(), leaf_max_size_);
-    old_leaf_node->MoveHalfTo(new_leaf_node);
+    new_leaf_node->Init(page_id, old_leaf_node->GetParentPageId(), leaf_max_size_, leaf_fingerprints_, key_width_, slotted_keys_);
+    if(right_edge){
+      // 90/10 split
+      old_leaf_node->MoveTailTo(new_leaf_node, std::max(1, old_leaf_node->GetSize() / 10));
+    }else{
+      old_leaf_node->MoveHalfTo(new_leaf_node);
+    }
     page_id_t next_page_id = old_leaf_node->GetNextPageId();
     old_leaf_node->SetNextPageId(new_leaf_node->GetPageId());
     new_leaf_node->SetNextPageId(next_page_id);
+    new_leaf_node->SetPrevPageId(old_leaf_node->GetPageId());
+    RelinkPrevPageId(next_page_id, new_leaf_node->GetPageId());
+    if(next_page_id == INVALID_PAGE_ID){
+      last_leaf_page_id_.store(page_id);
+    }
 
     new_node = reinterpret_cast<N*>(new_leaf_node);
   }else{
     InternalPage* old_internal_node = reinterpret_cast<InternalPage*>(node);
     InternalPage* new_internal_node = reinterpret_cast<InternalPage*>(new_node);
-    new_internal_node->Init(page_id, old_internal_node->GetParentPageId(), internal_max_size_);
+    new_internal_node->Init(page_id, old_internal_node->GetParentPageId(), internal_max_size_, key_width_,
+                            slotted_keys_);
     old_internal_node->MoveHalfTo(new_internal_node, buffer_pool_manager_);
     new_node = reinterpret_cast<N*>(new_internal_node);
   }
@@ -211,10 +469,13 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
 
     page_id_t new_page_id = INVALID_PAGE_ID;
     Page* new_page = buffer_pool_manager_->NewPage(&new_page_id);
+    if(new_page == nullptr){
+      throw std::runtime_error("out of memory");
+    }
     root_page_id_ = new_page_id;
     InternalPage* new_root_node = reinterpret_cast<InternalPage*>(new_page->GetData());
 
-    new_root_node->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_);// 初始化
+    new_root_node->Init(new_page_id, INVALID_PAGE_ID, internal_max_size_, key_width_, slotted_keys_);// 初始化
     new_root_node->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
     old_node->SetParentPageId(root_page_id_);
     new_node->SetParentPageId(root_page_id_);
@@ -222,45 +483,48 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
 
     UpdateRootPageId(0);
     if(root_page_latch_){
-      root_page_latch_ = false;
       root_latch_.unlock();
     }
-    Unlock(transaction);
+    UnlockUnpinPages(transaction);
     return;
-  }else{
-    LOG_INFO("InsertIntoParent old node is NOT root: completed key=%lld ", key.ToString());
-    page_id_t parent_page_id = old_node->GetParentPageId();
-    Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
-    InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
+  }
+  // the parent is still write latched in the transaction's page set, this fetch only pins it once more
+  page_id_t parent_page_id = old_node->GetParentPageId();
+  Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
+  InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
 
-    parent_node->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  parent_node->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
 
-    if(parent_node->GetSize() < parent_node->GetMaxSize() + 1){
-      // InternalPage* new_parent_node = Split(parent_node);
-      // InsertIntoParent(parent_node, new_parent_node->KeyAt(0), new_parent_node);
-      if(root_page_latch_){
-        root_page_latch_ = false;
-        root_latch_.unlock();
-      }
-      Unlock(transaction);
-      buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);      // unpin parent page
-      // buffer_pool_manager_->UnpinPage(new_parent_node->GetPageId(), true);  // unpin new parent node
-      LOG_INFO("InsertIntoParent old node is NOT root: completed key=%lld ", key.ToString());
-      return;
+  if(!parent_node->IsFull()){
+    if(root_page_latch_){
+      root_latch_.unlock();
     }
-    InternalPage* new_parent_node = Split(parent_node);
-    InsertIntoParent(parent_node, new_parent_node->KeyAt(0), new_parent_node, transaction, root_page_latch_);
-    //UnlockUnpinPages(transaction);
-    buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true); 
-    
-    buffer_pool_manager_->UnpinPage(new_parent_node->GetPageId(), true);  
+    UnlockUnpinPages(transaction);
+    buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);      // unpin parent page
+    return;
   }
+  InternalPage* new_parent_node = Split(parent_node);
+  InsertIntoParent(parent_node, new_parent_node->KeyAt(0), new_parent_node, transaction, root_page_latch_);
+  buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true); 
+  buffer_pool_manager_->UnpinPage(new_parent_node->GetPageId(), true);  
 }
 
+/*
+ * Point the prev link of leaf page_id at prev_page_id. The leaf is not latched:
+ * the caller holds its left neighbour, and latching right to left would deadlock
+ * with forward scans, so the link is stored atomically and treated as a hint.
+ */
 INDEX_TEMPLATE_ARGUMENTS
-template <typename N>
-int BPLUSTREE_TYPE::maxSize(N *node) {
-  return node->IsLeafPage() ? leaf_max_size_ - 1 : internal_max_size_;
+void BPLUSTREE_TYPE::RelinkPrevPageId(page_id_t page_id, page_id_t prev_page_id) {
+  if(page_id == INVALID_PAGE_ID){
+    return;
+  }
+  Page* page = buffer_pool_manager_->FetchPage(page_id);
+  if(page == nullptr){
+    throw std::runtime_error("out of memory");
+  }
+  reinterpret_cast<LeafPage*>(page->GetData())->SetPrevPageId(prev_page_id);
+  buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
 /*****************************************************************************
@@ -275,35 +539,295 @@ int BPLUSTREE_TYPE::maxSize(N *node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  LOG_INFO("ENTER Remove key %lld", key.ToString());
-  auto [leaf_page, root_page_latch_] = FindLeafPageByOperation(key, Operation::DELETE, transaction, false);
-  LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  int old_size = leaf_node->GetSize();
-  int size = leaf_node->RemoveAndDeleteRecord(key, comparator_);
+  RemoveEntry(key, nullptr, transaction);
+}
 
-  if(size == old_size){
-    if(root_page_latch_){
-      root_page_latch_ = false;
-      root_latch_.unlock();
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  RemoveEntry(key, &value, transaction);
+}
+
+/*
+ * Delete the first entry with key, or the entry with key and *value if value is
+ * not nullptr. With duplicates the entry may sit in any leaf of the run of key,
+ * only the first of them is reached by latch crabbing; the others are handed to
+ * RemoveFromRun().
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RemoveEntry(const KeyType &key, const ValueType *value, Transaction *transaction) {
+  while(true){
+    auto [leaf_page, root_page_latch_] =
+        FindLeafPageByOperation(key, Operation::DELETE, transaction, false, false, !unique_keys_);
+    if(leaf_page == nullptr){
+      return;
     }
-    UnlockUnpinPages(transaction);
+    LeafPage* leaf_node = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+    int old_size = leaf_node->GetSize();
+    int size = value == nullptr ? leaf_node->RemoveAndDeleteRecord(key, comparator_)
+                                : leaf_node->RemoveAndDeleteRecord(key, *value, comparator_);
+
+    if(size == old_size){
+      // the run of key may go on in the next leaf; latch it before letting go of this one, but only try,
+      // a writer holding it may be waiting for this leaf to merge
+      page_id_t next_page_id = leaf_node->GetNextPageId();
+      bool may_continue = !unique_keys_ && next_page_id != INVALID_PAGE_ID &&
+                          (size == 0 || comparator_(leaf_node->KeyAt(size - 1), key) <= 0);
+      Page* next_page = nullptr;
+      if(may_continue){
+        next_page = buffer_pool_manager_->FetchPage(next_page_id);
+        if(next_page == nullptr){
+          throw std::runtime_error("out of memory");
+        }
+        if(!next_page->TryWLatch()){
+          buffer_pool_manager_->UnpinPage(next_page_id, false);
+          next_page = nullptr;
+        }
+      }
+      if(root_page_latch_){
+        root_latch_.unlock();
+      }
+      UnlockUnpinPages(transaction);
+      leaf_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
+      if(!may_continue || (next_page != nullptr && RemoveFromRun(next_page, key, value, transaction))){
+        return;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    bool leaf_delete = CoalesceOrRedistribute(leaf_node, transaction, root_page_latch_);
     leaf_page->WUnlatch();
-    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), false);
+    if(leaf_delete){
+      transaction->AddIntoDeletedPageSet(leaf_node->GetPageId());
+    }
+
+    buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
+    for (page_id_t page_id : *transaction->GetDeletedPageSet()) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    transaction->GetDeletedPageSet()->clear();
     return;
   }
-  bool leaf_delete = CoalesceOrRedistribute(leaf_node, transaction, root_page_latch_);
-  leaf_page->WUnlatch();
-  if(leaf_delete){
-    transaction->AddIntoDeletedPageSet(leaf_node->GetPageId());
-    // buffer_pool_manager_->DeletePage(leaf_node->GetPageId());
+}
+
+/*
+ * Continue a removal along the leaf chain, starting at the pinned and write
+ * latched page. A leaf past the first of the run is not on the path of a
+ * descent, so if the removal leaves it below its min size it is rebalanced from
+ * the leaf up by RebalanceLeaf().
+ * @return : false if the next leaf could not be latched and the removal has to
+ * start over from the root
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RemoveFromRun(Page *page, const KeyType &key, const ValueType *value, Transaction *transaction) {
+  while(true){
+    LeafPage* leaf_node = reinterpret_cast<LeafPage*>(page->GetData());
+    int old_size = leaf_node->GetSize();
+    int size = value == nullptr ? leaf_node->RemoveAndDeleteRecord(key, comparator_)
+                                : leaf_node->RemoveAndDeleteRecord(key, *value, comparator_);
+    page_id_t next_page_id = leaf_node->GetNextPageId();
+    if(size != old_size || next_page_id == INVALID_PAGE_ID ||
+       (size > 0 && comparator_(leaf_node->KeyAt(size - 1), key) > 0)){
+      if(size != old_size){
+        RebalanceLeaf(page, Operation::DELETE, transaction);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), size != old_size);
+      for(page_id_t page_id : *transaction->GetDeletedPageSet()){
+        buffer_pool_manager_->DeletePage(page_id);
+      }
+      transaction->GetDeletedPageSet()->clear();
+      return true;
+    }
+    Page* next_page = buffer_pool_manager_->FetchPage(next_page_id);
+    if(next_page == nullptr){
+      throw std::runtime_error("out of memory");
+    }
+    bool latched = next_page->TryWLatch();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if(!latched){
+      buffer_pool_manager_->UnpinPage(next_page_id, false);
+      return false;
+    }
+    page = next_page;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::SetMergePolicy(MergePolicy policy, int lazy_min_size) {
+  merge_policy_ = policy;
+  lazy_min_size_ = std::max(lazy_min_size, 1);
+}
+
+/*
+ * Walk the leaf chain and rebalance every leaf below its min size, empty ones
+ * included. The walk holds each leaf read latched and upgrades it to a write
+ * latch when it needs work; the pin on the leaf keeps it from being deleted in
+ * between, and whether it still needs work is decided again by RebalanceLeaf().
+ * @return : the number of leaves that were merged or refilled
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t BPLUSTREE_TYPE::Compact() {
+  size_t changed = 0;
+  Transaction transaction(INVALID_TXN_ID);
+  Page* page = FindLeafPage(KeyType(), true);
+  while(page != nullptr){
+    LeafPage* leaf_node = reinterpret_cast<LeafPage*>(page->GetData());
+    bool underfull = !leaf_node->IsRootPage() && leaf_node->IsUnderfull(leaf_node->GetMinSize());
+    // pin the next leaf before letting go of this one so that a merge cannot delete it in between
+    page_id_t next_page_id = leaf_node->GetNextPageId();
+    Page* next_page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+    page->RUnlatch();
+    if(underfull){
+      page->WLatch();
+      changed += RebalanceLeaf(page, Operation::COMPACT, &transaction) ? 1 : 0;
+      if(transaction.GetDeletedPageSet()->count(page->GetPageId()) == 0 &&
+         leaf_node->GetNextPageId() != next_page_id){
+        // the next leaf has been merged into this one, by the rebalance or while the leaf was not latched
+        if(next_page != nullptr){
+          buffer_pool_manager_->UnpinPage(next_page_id, false);
+        }
+        next_page_id = leaf_node->GetNextPageId();
+        next_page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+      }
+      page->WUnlatch();
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), underfull);
+    for(page_id_t page_id : *transaction.GetDeletedPageSet()){
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+    transaction.GetDeletedPageSet()->clear();
+    if(next_page != nullptr){
+      next_page->RLatch();
+    }
+    page = next_page;
   }
+  return changed;
+}
 
-  buffer_pool_manager_->UnpinPage(leaf_node->GetPageId(), true);
-  for (page_id_t page_id : *transaction->GetDeletedPageSet()) {
-    buffer_pool_manager_->DeletePage(page_id);
+/*
+ * Merge or refill the pinned and write latched leaf until it is no longer below
+ * the size op rebalances at. The leaf stays latched and pinned; if it has been
+ * merged away it is left in the transaction's deleted page set for the caller.
+ * @return : true if the tree was changed
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::RebalanceLeaf(Page *page, Operation op, Transaction *transaction) {
+  LeafPage* leaf_node = reinterpret_cast<LeafPage*>(page->GetData());
+  bool changed = false;
+  while(!leaf_node->IsRootPage() && IsUnderfull(leaf_node, op)){
+    bool root_page_latch_ = false;
+    bool detached = false;
+    if(!LatchAncestors(leaf_node, op, transaction, &root_page_latch_, &detached)){
+      if(detached){
+        break;
+      }
+      // a descent holding one of the ancestors may be waiting for this leaf
+      page->WUnlatch();
+      std::this_thread::yield();
+      page->WLatch();
+      continue;
+    }
+    int size = leaf_node->GetSize();
+    if(CoalesceOrRedistribute(leaf_node, transaction, root_page_latch_, op)){
+      transaction->AddIntoDeletedPageSet(leaf_node->GetPageId());
+      return true;
+    }
+    // nothing moves if a slotted parent has no room for the new separator
+    if(leaf_node->GetSize() == size){
+      break;
+    }
+    changed = true;
   }
-  transaction->GetDeletedPageSet()->clear();
+  return changed;
+}
 
+/*
+ * Write latch the ancestors of the write latched node that rebalancing it may
+ * change, from the node up, into the transaction's page set; root_latch_ is
+ * taken as well if the root may shrink. This is the reverse of the order a
+ * descent latches in, so every latch is only tried. A parent id only changes
+ * while the parent is write latched, so a latched parent that the node still
+ * points at is its parent for as long as it is held.
+ * @return : false with nothing latched if a latch was busy, or with *detached
+ * set if the node has been merged away and is no longer in the tree
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::LatchAncestors(BPlusTreePage *node, Operation op, Transaction *transaction,
+                                    bool *root_page_latch, bool *detached) {
+  BPlusTreePage* child = node;
+  bool latched = true;
+  while(true){
+    page_id_t parent_page_id = child->GetParentPageId();
+    if(parent_page_id == INVALID_PAGE_ID){
+      latched = root_latch_.try_lock();
+      if(latched && root_page_id_.load() != child->GetPageId()){
+        root_latch_.unlock();
+        latched = false;
+        *detached = true;
+      }
+      *root_page_latch = latched;
+      break;
+    }
+    Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
+    if(parent_page == nullptr){
+      throw std::runtime_error("out of memory");
+    }
+    if(!parent_page->TryWLatch()){
+      buffer_pool_manager_->UnpinPage(parent_page_id, false);
+      latched = false;
+      break;
+    }
+    transaction->AddIntoPageSet(parent_page);
+    InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
+    if(child->GetParentPageId() != parent_page_id){
+      latched = false;
+      break;
+    }
+    if(parent_node->ValueIndex(child->GetPageId()) < 0){
+      latched = false;
+      *detached = true;
+      break;
+    }
+    if(IsSafe(parent_node, op)){
+      break;
+    }
+    child = parent_node;
+  }
+  if(!latched){
+    UnlockUnpinPages(transaction);
+  }
+  return latched;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StartMaintenance(std::chrono::milliseconds interval) {
+  StopMaintenance();
+  maintenance_interval_ = interval;
+  enable_maintenance_ = true;
+  maintenance_thread_ = new std::thread(&BPLUSTREE_TYPE::RunMaintenance, this);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::StopMaintenance() {
+  if(maintenance_thread_ == nullptr){
+    return;
+  }
+  enable_maintenance_ = false;
+  maintenance_thread_->join();
+  delete maintenance_thread_;
+  maintenance_thread_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RunMaintenance() {
+  while(enable_maintenance_){
+    std::this_thread::sleep_for(maintenance_interval_);
+    if(enable_maintenance_){
+      Compact();
+    }
+  }
 }
 
 /*
@@ -315,15 +839,23 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction, bool root_page_latch_) {
+bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction, bool root_page_latch_, Operation op) {
   if(node->IsRootPage()){
+    bool root_delete = AdjustRoot(node, root_page_latch_);
+    if(root_page_latch_){
+      root_latch_.unlock();
+    }
     UnlockUnpinPages(transaction);
-    return AdjustRoot(node, root_page_latch_);
+    return root_delete;
   }
-  if(node->GetSize() >= node->GetMinSize()){
+  if(!IsUnderfull(node, op)){
+    if(root_page_latch_){
+      root_latch_.unlock();
+    }
     UnlockUnpinPages(transaction);
     return false;
   }
+  // the parent is still write latched in the transaction's page set, this fetch only pins it once more
   page_id_t parent_page_id = node->GetParentPageId();
   Page* parent_page = buffer_pool_manager_->FetchPage(parent_page_id);
   InternalPage* parent_node = reinterpret_cast<InternalPage*>(parent_page->GetData());
@@ -333,23 +865,35 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction, b
   N* sibling_node = reinterpret_cast<N*>(sibling_page->GetData());
   sibling_page->WLatch();
 
-  if(sibling_node->GetSize() + node->GetSize() > maxSize(node)){
+  bool fits = node->IsLeafPage()
+                  ? reinterpret_cast<LeafPage*>(node)->CanMergeWith(reinterpret_cast<LeafPage*>(sibling_node))
+                  : reinterpret_cast<InternalPage*>(node)->CanMergeWith(reinterpret_cast<InternalPage*>(sibling_node),
+                                                                        parent_node->KeyAt(index == 0 ? 1 : index));
+  if(!fits){
     Redistribute(sibling_node, node, index, root_page_latch_);
+    if(root_page_latch_){
+      root_latch_.unlock();
+    }
     UnlockUnpinPages(transaction);
     sibling_page->WUnlatch();
     buffer_pool_manager_->UnpinPage(sibling_node->GetPageId(), true);
-    buffer_pool_manager_->UnpinPage(node->GetPageId(), true);
+    buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
     return false;
   }
 
   bool delete_parent = Coalesce(&sibling_node, &node, &parent_node, index, transaction,root_page_latch_);
   if(delete_parent){
     transaction->AddIntoDeletedPageSet(parent_node->GetPageId());
-    // buffer_pool_manager_->DeletePage(parent_node->GetPageId());
   }
   sibling_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), true);
-  buffer_pool_manager_->UnpinPage(sibling_node->GetPageId(), true);
+  // once unpinned the frame may already hold another page, so do not read the id from it afterwards
+  buffer_pool_manager_->UnpinPage(sibling_page_id, true);
+  if(index == 0){
+    // node was the left most child, so its right sibling has been merged into it
+    transaction->AddIntoDeletedPageSet(sibling_page_id);
+    return false;
+  }
   return true;
 }
 
@@ -381,6 +925,10 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
     page_id_t page_id = leaf_node->GetNextPageId();
     leaf_node->MoveAllTo(neighbor_leaf_node);
     neighbor_leaf_node->SetNextPageId(page_id);
+    RelinkPrevPageId(page_id, neighbor_leaf_node->GetPageId());
+    if(page_id == INVALID_PAGE_ID){
+      last_leaf_page_id_.store(neighbor_leaf_node->GetPageId());
+    }
   }else{
     InternalPage* internal_node = reinterpret_cast<InternalPage*>(*node);
     InternalPage* neighbor_internal_node = reinterpret_cast<InternalPage*>(*neighbor_node);
@@ -403,21 +951,28 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index, bool root_page_latch_) {
-  if(root_page_latch_){
-    root_latch_.unlock();
-  }
   page_id_t page_id = node->GetParentPageId();
   Page* page = buffer_pool_manager_->FetchPage(page_id);
   InternalPage* parent_node = reinterpret_cast<InternalPage*>(page->GetData());
+  // the separator that will replace the one in the parent, a slotted parent may have no room for a longer one
+  KeyType separator = index == 0 ? neighbor_node->KeyAt(1) : neighbor_node->KeyAt(neighbor_node->GetSize() - 1);
+  if(node->IsLeafPage()){
+    // leaf separators only have to lie between the entries on either side of the new boundary
+    separator = comparator_.Separator(neighbor_node->KeyAt(index == 0 ? 0 : neighbor_node->GetSize() - 2), separator);
+  }
+  if(!parent_node->CanSetKeyAt(index == 0 ? 1 : index, separator)){
+    buffer_pool_manager_->UnpinPage(parent_node->GetPageId(), false);
+    return;
+  }
   if(node->IsLeafPage()){
     LeafPage* leaf_node = reinterpret_cast<LeafPage*>(node);
     LeafPage* neighbor_leaf_node = reinterpret_cast<LeafPage*>(neighbor_node);
     if(index == 0){
       neighbor_leaf_node->MoveFirstToEndOf(leaf_node);
-      parent_node->SetKeyAt(1, neighbor_leaf_node->KeyAt(0));
+      parent_node->SetKeyAt(1, separator);
     }else{
       neighbor_leaf_node->MoveLastToFrontOf(leaf_node);
-      parent_node->SetKeyAt(index, leaf_node->KeyAt(0));
+      parent_node->SetKeyAt(index, separator);
     }
   }else{
     InternalPage* internal_node = reinterpret_cast<InternalPage*>(node);
@@ -451,9 +1006,6 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, bool root_page_lat
     root_page_id_ = child_page_id;
     UpdateRootPageId(0);
 
-    if(root_page_latch_){
-      root_latch_.unlock();
-    }
     Page* new_root_page = buffer_pool_manager_->FetchPage(root_page_id_);
     InternalPage* new_root_node = reinterpret_cast<InternalPage*>(new_root_page->GetData());
     new_root_node->SetParentPageId(INVALID_PAGE_ID);
@@ -462,11 +1014,9 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, bool root_page_lat
   }
   // case 2:old_root_node是叶结点，大小为0
   if(old_root_node->IsLeafPage() && old_root_node->GetSize() == 0){
+    last_leaf_page_id_.store(INVALID_PAGE_ID);
     root_page_id_ = INVALID_PAGE_ID;
     UpdateRootPageId(0);
-    if(root_page_latch_){
-      root_latch_.unlock();
-    }
     return true;
   }
 
@@ -483,10 +1033,8 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node, bool root_page_lat
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
-  // root_latch_.RLock();
   Page* page = FindLeafPageByOperation(KeyType(), Operation::FIND, nullptr, true).first;
-  //LeafPage* leaf = reinterpret_cast<LeafPage*>(page->GetData());
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, 0, page);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, 0, page, this);
 }
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -495,11 +1043,13 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  // root_latch_.RLock();
-  Page* page = FindLeafPageByOperation(key, Operation::FIND, nullptr, false).first;
+  Page* page = FindLeafPageByOperation(key, Operation::FIND, nullptr, false, false, !unique_keys_).first;
+  if(page == nullptr){
+    return end();
+  }
   LeafPage* leaf = reinterpret_cast<LeafPage*>(page->GetData());
   int index = leaf->KeyIndex(key, comparator_);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, index, page);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, index, page, this);
 }
 
 /*
@@ -509,16 +1059,50 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
-  // root_latch_.RLock();
-  Page* leaf_page = FindLeafPageByOperation(KeyType(), Operation::FIND, nullptr, true).first;
-  LeafPage* leaf = reinterpret_cast<LeafPage*>(leaf_page->GetData());
-  while(leaf->GetNextPageId() != INVALID_PAGE_ID){
-    Page* next_page = buffer_pool_manager_->FetchPage(leaf->GetNextPageId());
-    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
-    leaf_page = next_page;
-    leaf = reinterpret_cast<LeafPage*>(leaf_page->GetData());
+  // the end iterator holds no page, so it never blocks writers
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, 0, nullptr);
+}
+
+/*
+ * Find the right most leaf page first, then construct a reverse index iterator
+ * positioned on the largest key
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::rbegin() {
+  Page* page = FindLeafPageByOperation(KeyType(), Operation::FIND, nullptr, false, true).first;
+  if(page == nullptr){
+    return rend();
   }
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, leaf->GetSize(), leaf_page);
+  int index = reinterpret_cast<LeafPage*>(page->GetData())->GetSize() - 1;
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, index, page, this, true);
+}
+
+/*
+ * Input parameter is high key, construct a reverse index iterator positioned on
+ * the largest key that is <= the input key
+ * @return : reverse index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  Page* page = FindLeafPageByOperation(key, Operation::FIND, nullptr, false).first;
+  if(page == nullptr){
+    return rend();
+  }
+  LeafPage* leaf = reinterpret_cast<LeafPage*>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  if(index == leaf->GetSize() || comparator_(leaf->KeyAt(index), key) != 0){
+    index--;
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, index, page, this, true, &key);
+}
+
+/*
+ * Construct the iterator a reverse scan ends at, it holds no page just like end()
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::rend() {
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, 0, nullptr, nullptr, true);
 }
 
 /*****************************************************************************
@@ -532,43 +1116,60 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::end() {
 
 
 INDEX_TEMPLATE_ARGUMENTS
-Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  return FindLeafPageByOperation(key, Operation::FIND, nullptr, leftMost).first;
+Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, bool rightMost) {
+  return FindLeafPageByOperation(key, Operation::FIND, nullptr, leftMost, rightMost).first;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-std::pair<Page*, bool> BPLUSTREE_TYPE::FindLeafPageByOperation(const KeyType &key, Operation op, Transaction* transaction, bool leftMost) {
-  // throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
-  if(root_page_id_ == INVALID_PAGE_ID){
-    throw std::runtime_error("Unexpected. root_page_id is INVALID_PAGE_ID");
-  }
-  // LOG_INFO("ENTER FindLeaf1 key=%lld", key.ToString()); 
-  root_latch_.try_lock();
-  // LOG_INFO("Lock is %d", a);
-  bool root_page_latch_ = true;
-  // LOG_INFO("ENTER FindLeaf2 key=%lld", key.ToString());
-  Page* page = buffer_pool_manager_->FetchPage(root_page_id_);
-  BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
-  // assert(node->IsRootPage() == true);
+std::pair<Page*, bool> BPLUSTREE_TYPE::FindLeafPageByOperation(const KeyType &key, Operation op, Transaction* transaction, bool leftMost,
+                                                              bool rightMost, bool firstDuplicate) {
+  bool root_page_latch_ = false;
+  Page* page;
   if(op == Operation::FIND){
-    root_latch_.unlock();
-    root_page_latch_ = false;
-    page->RLatch();
+    // readers do not take root_latch_. The root only changes while the old root is write latched, so a root that is
+    // still published after it has been read latched stays the root until it is released.
+    while(true){
+      page_id_t root_page_id = root_page_id_.load();
+      if(root_page_id == INVALID_PAGE_ID){
+        return std::make_pair(nullptr, false);
+      }
+      page = buffer_pool_manager_->FetchPage(root_page_id);
+      page->RLatch();
+      if(root_page_id_.load() == root_page_id){
+        break;
+      }
+      page->RUnlatch();
+      buffer_pool_manager_->UnpinPage(root_page_id, false);
+    }
   }else{
-    // LOG_INFO("ENTER FindLeaf1 key=%lld, page = %d", key.ToString(), page->GetPageId());
+    root_latch_.lock();
+    root_page_latch_ = true;
+    if(IsEmpty()){
+      root_latch_.unlock();
+      return std::make_pair(nullptr, false);
+    }
+    page = buffer_pool_manager_->FetchPage(root_page_id_);
     page->WLatch();
-    // LOG_INFO("ENTER FindLeaf2 key=%lld", key.ToString());
-    if(IsSafe(node, op)){
+    if(IsSafe(reinterpret_cast<BPlusTreePage*>(page->GetData()), op)){
       root_page_latch_ = false;
       root_latch_.unlock();
     }
   }
+  BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
   while(!node->IsLeafPage()){
     InternalPage *internal_node = reinterpret_cast<InternalPage*>(node);
-    auto next_page_id = leftMost ? internal_node->ValueAt(0) : internal_node->Lookup(key, comparator_);
+    page_id_t next_page_id;
+    if(leftMost){
+      next_page_id = internal_node->ValueAt(0);
+    }else if(rightMost){
+      next_page_id = internal_node->ValueAt(internal_node->GetSize() - 1);
+    }else if(firstDuplicate){
+      next_page_id = internal_node->LookupFirst(key, comparator_);
+    }else{
+      next_page_id = internal_node->Lookup(key, comparator_);
+    }
     Page* next_page = buffer_pool_manager_->FetchPage(next_page_id);
     BPlusTreePage* next_node = reinterpret_cast<BPlusTreePage*>(next_page->GetData());
-    // buffer_pool_manager_->UnpinPage(node->GetPageId(),false);
     if(op == Operation::FIND){
       next_page->RLatch();
       page->RUnlatch();
@@ -587,7 +1188,6 @@ std::pair<Page*, bool> BPLUSTREE_TYPE::FindLeafPageByOperation(const KeyType &ke
     page = next_page;
     node = next_node;
   }
-  LOG_INFO("ENTER FindLeafPageByOPeration key=%lld ", key.ToString());
   return std::make_pair(page, root_page_latch_);
 }
 
@@ -602,11 +1202,8 @@ void BPLUSTREE_TYPE::Unlock(Transaction* transaction){
   transaction->GetPageSet()->clear();
 }
 
-
-
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UnlockUnpinPages(Transaction* transaction){
-  // root_latch_.WUnlock();
   if(transaction == nullptr){
     return;
   }
@@ -617,20 +1214,43 @@ void BPLUSTREE_TYPE::UnlockUnpinPages(Transaction* transaction){
   transaction->GetPageSet()->clear();
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+int BPLUSTREE_TYPE::RebalanceSize(N* node, Operation op){
+  // the maintenance task fills its leaf up to the eager min size, the pages above it follow the policy
+  if(merge_policy_ == MergePolicy::EAGER || (op == Operation::COMPACT && node->IsLeafPage())){
+    return node->GetMinSize();
+  }
+  if(node->IsLeafPage()){
+    return std::min(lazy_min_size_, node->GetMinSize());
+  }
+  return std::min(2, node->GetMinSize());
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::IsSafe(N* Node, Operation op){
-  if(Node->IsRootPage()){
-    return (op == Operation::INSERT && Node->GetSize() < maxSize(Node)) ||
-           (op == Operation::DELETE && Node->GetSize() > 2);
+  if(op == Operation::FIND){
+    return true;
   }
   if(op == Operation::INSERT){
-    return Node->GetSize() < maxSize(Node);
+    return Node->IsLeafPage() ? reinterpret_cast<LeafPage*>(Node)->HasRoomForInsert()
+                              : reinterpret_cast<InternalPage*>(Node)->HasRoomForInsert();
   }
-  if(op == Operation::DELETE){
-    return Node->GetSize() > Node->GetMinSize();
+  if(Node->IsRootPage()){
+    return Node->GetSize() > 2;
   }
-  return true;
+  // DELETE and COMPACT: one entry less must not make the page rebalance
+  return !IsUnderfull(Node, op, 1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N>
+bool BPLUSTREE_TYPE::IsUnderfull(N* node, Operation op, int removed){
+  if(node->IsLeafPage()){
+    return reinterpret_cast<LeafPage*>(node)->IsUnderfull(RebalanceSize(node, op), removed);
+  }
+  return reinterpret_cast<InternalPage*>(node)->IsUnderfull(RebalanceSize(node, op), removed);
 }
 
 /*
@@ -640,18 +1260,27 @@ bool BPLUSTREE_TYPE::IsSafe(N* Node, Operation op){
  * @parameter: insert_record      defualt value is false. When set to true,
  * insert a record <index_name, root_page_id> into header page instead of
  * updating it.
+ * The header page is shared by every index, so it is write latched while the record changes, and it is only dirtied
+ * when the stored root really differs. It is a buffer pool page, so the changes between two flushes of it reach the
+ * disk in a single write.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
+  page_id_t root_page_id = root_page_id_;
+  page_id_t stored_root_id;
+  bool is_dirty = true;
+  header_page->WLatch();
+  if (insert_record != 0 && header_page->InsertRecord(index_name_, root_page_id)) {
+    // created a new record<index_name + root_page_id> in header_page
+  } else if (header_page->GetRootId(index_name_, &stored_root_id) && stored_root_id != root_page_id) {
+    // update root_page_id in header_page, a tree started again after it was emptied already has its record
+    header_page->UpdateRecord(index_name_, root_page_id);
   } else {
-    // update root_page_id in header_page
-    header_page->UpdateRecord(index_name_, root_page_id_);
+    is_dirty = false;
   }
-  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+  header_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, is_dirty);
 }
 
 /*
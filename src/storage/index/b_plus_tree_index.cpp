@@ -19,7 +19,8 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, LEAF_PAGE_SIZE, INTERNAL_PAGE_SIZE,
+                 metadata->IsUnique()) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -36,7 +37,7 @@ void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *t
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.Remove(index_key, transaction);
+  container_.Remove(index_key, rid, transaction);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -48,6 +49,91 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   container_.GetValue(index_key, result, transaction);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys, std::vector<std::vector<RID>> *results,
+                                    Transaction *transaction) {
+  // construct scan index keys, the tree sorts them and probes with one leaf cursor
+  std::vector<KeyType> index_keys(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    index_keys[i].SetFromKey(keys[i]);
+  }
+
+  container_.GetValues(index_keys, results, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                     bool high_inclusive, std::vector<RID> *result, Transaction *transaction,
+                                     ScanDirection direction, std::vector<Tuple> *entries, uint32_t bound_columns) {
+  KeyType low_index_key;
+  KeyType high_index_key;
+  if (low_key != nullptr) {
+    low_index_key.SetFromKey(*low_key);
+  }
+  if (high_key != nullptr) {
+    high_index_key.SetFromKey(*high_key);
+  }
+  if (bound_columns == 0) {
+    bound_columns = GetKeyAttrs().size();
+  }
+  auto below_low = [&](const KeyType &key) {
+    int cmp = comparator_.ComparePrefix(key, low_index_key, bound_columns);
+    return cmp < 0 || (cmp == 0 && !low_inclusive);
+  };
+  auto above_high = [&](const KeyType &key) {
+    int cmp = comparator_.ComparePrefix(key, high_index_key, bound_columns);
+    return cmp > 0 || (cmp == 0 && !high_inclusive);
+  };
+
+  if (direction == ScanDirection::BACKWARD) {
+    // start at the upper bound and walk the prev links down to the lower bound. A prefix bound has no key to start
+    // at, the keys past it are skipped from the end instead.
+    bool prefix_bound = bound_columns < GetKeyAttrs().size();
+    auto iter = high_key != nullptr && !prefix_bound ? container_.RBegin(high_index_key) : container_.rbegin();
+    for (; !iter.isEnd(); ++iter) {
+      const auto &entry = *iter;
+      if (high_key != nullptr && above_high(entry.first)) {
+        continue;
+      }
+      if (low_key != nullptr && below_low(entry.first)) {
+        break;
+      }
+      result->push_back(entry.second);
+      if (entries != nullptr) {
+        entries->push_back(EntryToTuple(entry.first));
+      }
+    }
+    return;
+  }
+
+  // start at the first leaf that can hold the lower bound and stop at the first key past the upper bound
+  auto iter = low_key != nullptr ? container_.Begin(low_index_key) : container_.begin();
+  for (; !iter.isEnd(); ++iter) {
+    const auto &entry = *iter;
+    if (low_key != nullptr && below_low(entry.first)) {
+      continue;
+    }
+    if (high_key != nullptr && above_high(entry.first)) {
+      break;
+    }
+    result->push_back(entry.second);
+    if (entries != nullptr) {
+      entries->push_back(EntryToTuple(entry.first));
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+Tuple BPLUSTREE_INDEX_TYPE::EntryToTuple(const KeyType &key) const {
+  Schema *entry_schema = GetEntrySchema();
+  std::vector<Value> values;
+  values.reserve(entry_schema->GetColumnCount());
+  for (uint32_t i = 0; i < entry_schema->GetColumnCount(); i++) {
+    values.push_back(key.ToValue(entry_schema, i));
+  }
+  return Tuple(values, entry_schema);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() { return container_.begin(); }
 
@@ -57,6 +143,12 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.end(); }
 
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator() { return container_.rbegin(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetReverseBeginIterator(const KeyType &key) { return container_.RBegin(key); }
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
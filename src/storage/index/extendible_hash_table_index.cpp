@@ -0,0 +1,82 @@
+#include <vector>
+
+#include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+EXTENDIBLE_HASH_TABLE_INDEX_TYPE::ExtendibleHashTableIndex(IndexMetadata *metadata,
+                                                           BufferPoolManager *buffer_pool_manager,
+                                                           const HashFunction<KeyType> &hash_fn)
+    : Index(metadata),
+      comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, hash_fn, metadata->IsUnique()) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(transaction, index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Remove(transaction, index_key, rid);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.GetValue(transaction, index_key, result);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_INDEX_TYPE::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                                 bool high_inclusive, std::vector<RID> *result,
+                                                 Transaction *transaction, ScanDirection direction,
+                                                 std::vector<Tuple> *entries, uint32_t bound_columns) {
+  KeyType low_index_key;
+  KeyType high_index_key;
+  if (low_key == nullptr || high_key == nullptr || !low_inclusive || !high_inclusive ||
+      (bound_columns != 0 && bound_columns < GetKeyAttrs().size())) {
+    throw NotImplementedException("hash index " + GetName() + " only supports equality lookups");
+  }
+  low_index_key.SetFromKey(*low_key);
+  high_index_key.SetFromKey(*high_key);
+  if (comparator_(low_index_key, high_index_key) != 0) {
+    throw NotImplementedException("hash index " + GetName() + " only supports equality lookups");
+  }
+
+  size_t begin = result->size();
+  container_.GetValue(transaction, low_index_key, result);
+  if (entries != nullptr) {
+    // without included columns an entry is just the key
+    entries->insert(entries->end(), result->size() - begin, *low_key);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void EXTENDIBLE_HASH_TABLE_INDEX_TYPE::BulkInsert(const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  for (const auto &entry : entries) {
+    container_.Insert(nullptr, entry.first, entry.second);
+  }
+}
+template class ExtendibleHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class ExtendibleHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class ExtendibleHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class ExtendibleHashTableIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class ExtendibleHashTableIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -3,6 +3,8 @@
  */
 #include <cassert>
 
+#include "common/exception.h"
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
@@ -12,48 +14,239 @@ namespace bustub {
  * set your own input parameters
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager* bpm, int index, Page* page)
-    :buffer_pool_manager_(bpm), page_(page), index_(index){
-    leaf_page = reinterpret_cast<LeafPage*>(page_->GetData());
+INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager* bpm, int index, Page* page, Tree* tree, bool reverse,
+                                  const KeyType* high_key)
+    :buffer_pool_manager_(bpm), page_(page), index_(index), leaf_page(nullptr), tree_(tree), reverse_(reverse){
+    if(high_key != nullptr){
+        bound_ = *high_key;
+        has_bound_ = true;
+    }
+    if(page_ != nullptr){
+        leaf_page = reinterpret_cast<LeafPage*>(page_->GetData());
+        if(reverse_){
+            SkipExhaustedLeavesBackward();
+        }else{
+            SkipExhaustedLeaves();
+        }
+    }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator(){
-    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    :buffer_pool_manager_(other.buffer_pool_manager_), page_(other.page_), index_(other.index_),
+     leaf_page(other.leaf_page), tree_(other.tree_), reverse_(other.reverse_), bound_(other.bound_),
+     has_bound_(other.has_bound_), has_last_(other.has_last_), last_value_(other.last_value_),
+     seeking_(other.seeking_){
+    other.page_ = nullptr;
+    other.leaf_page = nullptr;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::isEnd() {
-    if(leaf_page->GetNextPageId() == INVALID_PAGE_ID && index_ == leaf_page->GetSize()){
-        return true;
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+    if(this != &other){
+        Release();
+        buffer_pool_manager_ = other.buffer_pool_manager_;
+        page_ = other.page_;
+        index_ = other.index_;
+        leaf_page = other.leaf_page;
+        tree_ = other.tree_;
+        reverse_ = other.reverse_;
+        bound_ = other.bound_;
+        has_bound_ = other.has_bound_;
+        has_last_ = other.has_last_;
+        last_value_ = other.last_value_;
+        seeking_ = other.seeking_;
+        other.page_ = nullptr;
+        other.leaf_page = nullptr;
     }
-    return false;
+    return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() {
-    return leaf_page->GetItem(index_);
+INDEXITERATOR_TYPE::~IndexIterator(){
+    Release();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-    index_++;
-    if(leaf_page->GetNextPageId() != INVALID_PAGE_ID && index_ == leaf_page->GetSize()){
-        Page* next_page = buffer_pool_manager_->FetchPage(leaf_page->GetNextPageId());
+void INDEXITERATOR_TYPE::Release() {
+    if(page_ != nullptr){
+        page_->RUnlatch();
         buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+        page_ = nullptr;
+        leaf_page = nullptr;
+    }
+    index_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+    while(page_ != nullptr && index_ >= leaf_page->GetSize()){
+        page_id_t next_page_id = leaf_page->GetNextPageId();
+        if(next_page_id == INVALID_PAGE_ID){
+            Release();
+            return;
+        }
+        Page* next_page = buffer_pool_manager_->FetchPage(next_page_id);
+        if(next_page == nullptr){
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch next leaf page");
+        }
+        if(next_page->TryRLatch()){
+            // crab left to right, nothing can move between the two leaves in the meantime
+            Release();
+            page_ = next_page;
+            leaf_page = reinterpret_cast<LeafPage*>(page_->GetData());
+            continue;
+        }
+        // a writer holds the sibling and may be waiting for this leaf (merges latch right to left),
+        // so give this leaf up before blocking and skip whatever a redistribution pushed over in between
+        bool has_last = leaf_page->GetSize() > 0;
+        MappingType last{};
+        if(has_last){
+            last = leaf_page->GetItem(leaf_page->GetSize() - 1);
+        }
+        Release();
+        next_page->RLatch();
         page_ = next_page;
         leaf_page = reinterpret_cast<LeafPage*>(page_->GetData());
-        index_ = 0;
+        if(has_last && tree_ != nullptr){
+            // entries only arrive here as a suffix of the leaf we left, so they end with the one returned
+            // last; equal keys can be duplicates not returned yet, only skip them up to that entry
+            const KeyComparator &comparator = tree_->GetComparator();
+            int index = 0;
+            int cmp;
+            while(index < leaf_page->GetSize() && (cmp = comparator(leaf_page->KeyAt(index), last.first)) <= 0){
+                index++;
+                if(cmp < 0){
+                    index_ = index;
+                }else if(leaf_page->GetItem(index - 1).second == last.second){
+                    index_ = index;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeavesBackward() {
+    while(page_ != nullptr){
+        if(index_ >= 0){
+            if(!seeking_){
+                return;
+            }
+            // after a re-descend, skip the duplicates of the bound returned before, up to the last one
+            const KeyComparator &comparator = tree_->GetComparator();
+            MappingType item = leaf_page->GetItem(index_);
+            if(comparator(item.first, bound_) != 0){
+                seeking_ = false;
+                return;
+            }
+            seeking_ = !(item.second == last_value_);
+            index_--;
+            continue;
+        }
+        page_id_t prev_page_id = leaf_page->GetPrevPageId();
+        if(prev_page_id == INVALID_PAGE_ID){
+            Release();
+            return;
+        }
+        // latching right to left may deadlock with writers, so only try; the prev link is a hint and is
+        // trusted only while both leaves are latched and the previous leaf still points back here
+        Page* prev_page = buffer_pool_manager_->FetchPage(prev_page_id);
+        if(prev_page == nullptr){
+            throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch previous leaf page");
+        }
+        if(prev_page->TryRLatch()){
+            auto prev_leaf = reinterpret_cast<LeafPage*>(prev_page->GetData());
+            if(prev_leaf->GetNextPageId() == page_->GetPageId()){
+                Release();
+                page_ = prev_page;
+                leaf_page = prev_leaf;
+                index_ = leaf_page->GetSize() - 1;
+                continue;
+            }
+            prev_page->RUnlatch();
+            Release();
+        }else{
+            // wait for the writer holding the previous leaf without holding anything ourselves
+            Release();
+            prev_page->RLatch();
+            prev_page->RUnlatch();
+        }
+        buffer_pool_manager_->UnpinPage(prev_page_id, false);
+
+        // slow path: descend again to the leaf holding the bound, entries may have moved across leaves
+        if(tree_ == nullptr){
+            return;
+        }
+        page_ = tree_->FindLeafPage(bound_, false, !has_bound_);
+        if(page_ == nullptr){
+            return;
+        }
+        leaf_page = reinterpret_cast<LeafPage*>(page_->GetData());
+        if(!has_bound_){
+            index_ = leaf_page->GetSize() - 1;
+            continue;
+        }
+        index_ = leaf_page->UpperKeyIndex(bound_, tree_->GetComparator()) - 1;
+        seeking_ = has_last_;
     }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::SeekForward(const KeyType &key) {
+    const KeyComparator &comparator = tree_->GetComparator();
+    for(int hops = 0; page_ != nullptr; hops++){
+        int size = leaf_page->GetSize();
+        if(size > 0 && comparator(leaf_page->KeyAt(size - 1), key) >= 0){
+            // search the whole leaf, key may repeat the previous one
+            index_ = leaf_page->KeyIndex(key, comparator);
+            return true;
+        }
+        if(hops == 1){
+            return false;
+        }
+        index_ = size;
+        SkipExhaustedLeaves();
+    }
+    // past the last leaf, nothing is >= key
+    return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::isEnd() {
+    return page_ == nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+MappingType INDEXITERATOR_TYPE::operator*() {
+    return leaf_page->GetItem(index_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+    if(reverse_){
+        bound_ = leaf_page->KeyAt(index_);
+        last_value_ = leaf_page->GetItem(index_).second;
+        has_bound_ = true;
+        has_last_ = true;
+        index_--;
+        SkipExhaustedLeavesBackward();
+        return *this;
+    }
+    index_++;
+    SkipExhaustedLeaves();
     return *this;
 }
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const{
-    return (leaf_page->GetPageId() == itr.leaf_page->GetPageId() && index_ == itr.index_);
+    if(page_ == nullptr || itr.page_ == nullptr){
+        return page_ == itr.page_;
+    }
+    return (page_->GetPageId() == itr.page_->GetPageId() && index_ == itr.index_);
 }
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const{
-    //return (leaf_page->GetPageId() != itr.leaf_page->GetPageID() || index_ != itr.index_);
     return !(*this == itr);
 }
 
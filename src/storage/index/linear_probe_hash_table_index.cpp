@@ -11,7 +11,7 @@ HASH_TABLE_INDEX_TYPE::LinearProbeHashTableIndex(IndexMetadata *metadata, Buffer
                                                  size_t num_buckets, const HashFunction<KeyType> &hash_fn)
     : Index(metadata),
       comparator_(metadata->GetKeySchema()),
-      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn) {}
+      container_(metadata->GetName(), buffer_pool_manager, comparator_, num_buckets, hash_fn, metadata->IsUnique()) {}
 
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
@@ -39,6 +39,40 @@ void HASH_TABLE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result,
 
   container_.GetValue(transaction, index_key, result);
 }
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::ScanRange(const Tuple *low_key, bool low_inclusive, const Tuple *high_key,
+                                      bool high_inclusive, std::vector<RID> *result, Transaction *transaction,
+                                      ScanDirection direction, std::vector<Tuple> *entries, uint32_t bound_columns) {
+  KeyType low_index_key;
+  KeyType high_index_key;
+  if (low_key == nullptr || high_key == nullptr || !low_inclusive || !high_inclusive ||
+      (bound_columns != 0 && bound_columns < GetKeyAttrs().size())) {
+    throw NotImplementedException("hash index " + GetName() + " only supports equality lookups");
+  }
+  low_index_key.SetFromKey(*low_key);
+  high_index_key.SetFromKey(*high_key);
+  if (comparator_(low_index_key, high_index_key) != 0) {
+    throw NotImplementedException("hash index " + GetName() + " only supports equality lookups");
+  }
+
+  size_t begin = result->size();
+  container_.GetValue(transaction, low_index_key, result);
+  if (entries != nullptr) {
+    // without included columns an entry is just the key
+    entries->insert(entries->end(), result->size() - begin, *low_key);
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::BulkInsert(const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  if (entries.size() * 4 > container_.GetSize() * 3) {
+    container_.Resize(entries.size());
+  }
+  for (const auto &entry : entries) {
+    container_.Insert(nullptr, entry.first, entry.second);
+  }
+}
 template class LinearProbeHashTableIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class LinearProbeHashTableIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class LinearProbeHashTableIndex<GenericKey<16>, RID, GenericComparator<16>>;
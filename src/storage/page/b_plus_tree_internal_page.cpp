@@ -9,10 +9,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <array>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -21,16 +24,20 @@ namespace bustub {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
- * max page size
+ * Including set page type, set current size, set page id, set parent id, set
+ * max page size and set the number of key bytes kept per separator
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, int key_width,
+                                          bool slotted) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetSize(0);
   SetMaxSize(max_size);
+  key_width_ = key_width;
+  heap_begin_ = slotted ? Capacity() : 0;
+  key_bytes_ = 0;
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -38,12 +45,166 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code
-  return array[index].first;
+  KeyType key{};
+  if(IsSlotted()){
+    uint16_t offset;
+    memcpy(&offset, SlotAt(index), sizeof(uint16_t));
+    memcpy(&key, data_ + offset, KeyLengthAt(index));
+    return key;
+  }
+  memcpy(&key, EntryAt(index), key_width_);
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  if(IsSlotted()){
+    // the old bytes stay in the heap until it is compacted
+    key_bytes_ -= KeyLengthAt(index);
+    uint16_t length = 0;
+    memcpy(SlotAt(index) + sizeof(uint16_t), &length, sizeof(uint16_t));
+    PutKey(index, key);
+    return;
+  }
+  memcpy(EntryAt(index), &key, key_width_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint16_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyLengthAt(int index) const {
+  uint16_t length;
+  memcpy(&length, SlotAt(index) + sizeof(uint16_t), sizeof(uint16_t));
+  return length;
+}
+
+/*
+ * The bytes of key past the returned length are all zero. KeyAt zero fills
+ * the key before copying the stored bytes, so every key reads back exactly and
+ * two keys that differ never store the same bytes.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::StoredLength(const KeyType &key) const {
+  const char *bytes = reinterpret_cast<const char *>(&key);
+  int length = key_width_;
+  while(length > 0 && bytes[length - 1] == 0){
+    length--;
+  }
+  return length;
+}
+
+/*
+ * Write key into the heap of a slotted page and point the slot at index to it,
+ * the slot must not refer to any bytes yet
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PutKey(int index, const KeyType &key) {
+  uint16_t length = StoredLength(key);
+  if(heap_begin_ - GetSize() * SlotSize() < length){
+    CompactKeys();
+  }
+  heap_begin_ -= length;
+  memcpy(data_ + heap_begin_, &key, length);
+  memcpy(SlotAt(index), &heap_begin_, sizeof(uint16_t));
+  memcpy(SlotAt(index) + sizeof(uint16_t), &length, sizeof(uint16_t));
+  key_bytes_ += length;
+}
+
+/*
+ * Move the key bytes still referred to by a slot to the end of the page, so
+ * that all free space is between the slots and the heap
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CompactKeys() {
+  std::array<char, Capacity()> heap;
+  uint16_t end = Capacity();
+  for(int i = 0; i < GetSize(); i++){
+    uint16_t offset;
+    uint16_t length = KeyLengthAt(i);
+    memcpy(&offset, SlotAt(i), sizeof(uint16_t));
+    end -= length;
+    memcpy(heap.data() + end, data_ + offset, length);
+    memcpy(SlotAt(i), &end, sizeof(uint16_t));
+  }
+  memcpy(data_ + end, heap.data() + end, Capacity() - end);
+  heap_begin_ = end;
 }
 
+/*
+ * Make room for an entry at index and fill it in
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertEntry(int index, const KeyType &key, const ValueType &value) {
+  if(!IsSlotted()){
+    memmove(EntryAt(index + 1), EntryAt(index), (GetSize() - index) * EntrySize());
+    IncreaseSize(1);
+    SetKeyAt(index, key);
+    SetValueAt(index, value);
+    return;
+  }
+  if(heap_begin_ - (GetSize() + 1) * SlotSize() < StoredLength(key)){
+    CompactKeys();
+  }
+  memmove(SlotAt(index + 1), SlotAt(index), (GetSize() - index) * SlotSize());
+  IncreaseSize(1);
+  SetValueAt(index, value);
+  PutKey(index, key);
+}
+
+/*
+ * Drop the entries from size on
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Truncate(int size) {
+  if(IsSlotted()){
+    for(int i = size; i < GetSize(); i++){
+      key_bytes_ -= KeyLengthAt(i);
+    }
+    if(size == 0){
+      heap_begin_ = Capacity();
+    }
+  }
+  SetSize(size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsFull() const {
+  return GetSize() > GetMaxSize() || (IsSlotted() && FreeSpace() < MaxEntrySize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomForInsert() const {
+  return GetSize() < GetMaxSize() && (!IsSlotted() || FreeSpace() >= 2 * MaxEntrySize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderfull(int min_size, int removed) const {
+  if(GetSize() - removed >= min_size){
+    return false;
+  }
+  // with short keys a slotted page reaches its space before max size, then the space decides
+  return !IsSlotted() || UsedSpace() - removed * MaxEntrySize() < (Capacity() - MaxEntrySize()) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMergeWith(const BPlusTreeInternalPage *sibling,
+                                                  const KeyType &middle_key) const {
+  if(GetSize() + sibling->GetSize() > GetMaxSize()){
+    return false;
+  }
+  return !IsSlotted() || UsedSpace() + sibling->UsedSpace() + StoredLength(middle_key) + MaxEntrySize() <= Capacity();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanSetKeyAt(int index, const KeyType &key) const {
+  return !IsSlotted() || FreeSpace() + KeyLengthAt(index) - StoredLength(key) >= MaxEntrySize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanAppendChild(const KeyType &key) const {
+  if(GetSize() >= GetMaxSize()){
+    return false;
+  }
+  return !IsSlotted() || FreeSpace() - SlotSize() - StoredLength(key) >= MaxEntrySize();
+}
 
 /*
  * Helper method to find and return array index(or offset), so that its value
@@ -52,7 +213,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { a
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
   for(int i = 0; i < GetSize(); i++){
-    if(array[i].second == value){
+    if(ValueAt(i) == value){
       return i;
     }
   }
@@ -64,7 +225,24 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return array[index].second; }
+ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
+  ValueType value;
+  if(IsSlotted()){
+    memcpy(&value, SlotAt(index) + 2 * sizeof(uint16_t), sizeof(ValueType));
+    return value;
+  }
+  memcpy(&value, EntryAt(index) + key_width_, sizeof(ValueType));
+  return value;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  if(IsSlotted()){
+    memcpy(SlotAt(index) + 2 * sizeof(uint16_t), &value, sizeof(ValueType));
+    return;
+  }
+  memcpy(EntryAt(index) + key_width_, &value, sizeof(ValueType));
+}
 
 /*****************************************************************************
  * LOOKUP
@@ -76,6 +254,12 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return arra
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
+  int width = comparator.IntegerKeyWidth();
+  if(width != 0 && !IsSlotted()){
+    // the child to follow is the one left of the first key greater than the search key
+    int upper = IntegerKeySearch<true>(data_, EntrySize(), 1, GetSize(), reinterpret_cast<const char*>(&key), width);
+    return ValueAt(upper - 1);
+  }
   int left = 1;
   int right = GetSize()-1;
   int index = 0;
@@ -91,6 +275,34 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCo
   return ValueAt(index);// ?
 }
 
+/*
+ * Find and return the left most child that may contain input "key". With
+ * duplicate keys a run of equal keys can span several children, and the
+ * separator in front of a child may equal the first key it holds, so follow
+ * the child left of the first key that is not less than the search key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::LookupFirst(const KeyType &key, const KeyComparator &comparator) const {
+  int width = comparator.IntegerKeyWidth();
+  if(width != 0 && !IsSlotted()){
+    int lower = IntegerKeySearch(data_, EntrySize(), 1, GetSize(), reinterpret_cast<const char*>(&key), width);
+    return ValueAt(lower - 1);
+  }
+  int left = 1;
+  int right = GetSize()-1;
+  int index = 0;
+  while(left <= right){
+    int mid = (left + right) / 2;
+    if(comparator(KeyAt(mid), key) >= 0){
+      right = mid - 1;
+    }else{
+      left = mid + 1;
+      index = mid;
+    }
+  }
+  return ValueAt(index);
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -103,11 +315,18 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCo
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
                                                      const ValueType &new_value) {
-  array[0].second = old_value;
-  array[1].first = new_key;
-  array[1].second = new_value;
-  SetSize(2);
+  InsertEntry(0, KeyType{}, old_value);
+  InsertEntry(1, new_key, new_value);
+}
+/*
+ * Append new_key & new_value pair after the last entry, the key of the first
+ * entry is never read
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::AppendChild(const KeyType &key, const ValueType &value) {
+  InsertEntry(GetSize(), key, value);
 }
+
 /*
  * Insert new_key & new_value pair right after the pair with its value ==
  * old_value
@@ -116,13 +335,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
                                                     const ValueType &new_value) {
-  int insert_index = ValueIndex(old_value);
-  insert_index++;
-  for(int i = GetSize(); i > insert_index; i--){
-    array[i] = array[i-1];
-  }
-  array[insert_index] = MappingType{new_key, new_value};
-  IncreaseSize(1);
+  InsertEntry(ValueIndex(old_value) + 1, new_key, new_value);
   return GetSize();
 }
 
@@ -136,9 +349,17 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
                                                 BufferPoolManager *buffer_pool_manager) {
   int size = GetSize() / 2;
-  recipient->CopyNFrom(array + size, GetSize() - size, buffer_pool_manager);
-  IncreaseSize(-GetSize() + size);
-  
+  if(IsSlotted() && GetSize() <= GetMaxSize()){
+    // full by space rather than by size, split where the used space halves, keeping a child on either side
+    int used = SlotSize() + KeyLengthAt(0);
+    size = 1;
+    while(size < GetSize() - 1 && used < UsedSpace() / 2){
+      used += SlotSize() + KeyLengthAt(size);
+      size++;
+    }
+  }
+  recipient->CopyNFrom(this, size, GetSize() - size, buffer_pool_manager);
+  Truncate(size);
 }
 
 /* Copy entries into me, starting from {items} and copy {size} entries.
@@ -146,15 +367,24 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient
  * So I need to 'adopt' them by changing their parent page id, which needs to be persisted with BufferPoolManger
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
-  std::copy(items, items + size, array + GetSize());
-  for(int i = GetSize(); i < size + GetSize(); i++){
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(const BPlusTreeInternalPage *source, int index, int size,
+                                               BufferPoolManager *buffer_pool_manager) {
+  // both pages belong to the same tree, so the entries have the same layout
+  int start = GetSize();
+  if(IsSlotted()){
+    for(int i = index; i < index + size; i++){
+      InsertEntry(GetSize(), source->KeyAt(i), source->ValueAt(i));
+    }
+  }else{
+    memcpy(EntryAt(start), source->EntryAt(index), size * EntrySize());
+    IncreaseSize(size);
+  }
+  for(int i = start; i < GetSize(); i++){
     Page* page = buffer_pool_manager->FetchPage(ValueAt(i));
     BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
     node->SetParentPageId(GetPageId());
     buffer_pool_manager->UnpinPage(page->GetPageId(),true);// page经过修改
   }
-  IncreaseSize(size);
 }
 
 /*****************************************************************************
@@ -167,8 +397,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
-  for(int i = index; i < GetSize() - 1; i++){
-    array[i] = array[i+1];
+  if(IsSlotted()){
+    key_bytes_ -= KeyLengthAt(index);
+    memmove(SlotAt(index), SlotAt(index + 1), (GetSize() - index - 1) * SlotSize());
+  }else{
+    memmove(EntryAt(index), EntryAt(index + 1), (GetSize() - index - 1) * EntrySize());
   }
   IncreaseSize(-1);
 }
@@ -180,7 +413,7 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
   ValueType ret = ValueAt(0);
-  SetSize(0);
+  Truncate(0);
   return ret;
 }
 /*****************************************************************************
@@ -198,8 +431,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
                                                BufferPoolManager *buffer_pool_manager) {
   // 由于array[0].first没有意义，将父节点的middle key 进行赋值
   SetKeyAt(0, middle_key);
-  recipient->CopyNFrom(array, GetSize(), buffer_pool_manager);
-  SetSize(0);
+  recipient->CopyNFrom(this, 0, GetSize(), buffer_pool_manager);
+  Truncate(0);
 
 }
 
@@ -218,7 +451,7 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                       BufferPoolManager *buffer_pool_manager) {
   SetKeyAt(0, middle_key);
-  recipient->CopyLastFrom(array[0], buffer_pool_manager);
+  recipient->CopyLastFrom(KeyAt(0), ValueAt(0), buffer_pool_manager);
   Remove(0);
 }
 
@@ -227,13 +460,13 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *rec
  * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-  // array[GetSize()] = pair;
-  Page* page = buffer_pool_manager->FetchPage(ValueAt(GetSize()));
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const KeyType &key, const ValueType &value,
+                                                  BufferPoolManager *buffer_pool_manager) {
+  InsertEntry(GetSize(), key, value);
+  Page* page = buffer_pool_manager->FetchPage(value);
   BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
   node->SetParentPageId(GetPageId());
   buffer_pool_manager->UnpinPage(page->GetPageId(), true);
-  IncreaseSize(1);
 }
 
 /*
@@ -247,9 +480,8 @@ INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                                                        BufferPoolManager *buffer_pool_manager) {
   recipient ->SetKeyAt(0, middle_key);
-  auto pair = array[GetSize() - 1];
-  recipient->CopyFirstFrom(pair, buffer_pool_manager);
-  IncreaseSize(-1);// 不需要remove
+  recipient->CopyFirstFrom(KeyAt(GetSize() - 1), ValueAt(GetSize() - 1), buffer_pool_manager);
+  Truncate(GetSize() - 1);// 不需要remove
 }
 
 /* Append an entry at the beginning.
@@ -257,16 +489,13 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
  * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-  for(int i = GetSize(); i >=1; i--){
-    array[i] = array[i-1];
-  }
-  array[0] = pair;
-  Page* page = buffer_pool_manager->FetchPage(ValueAt(0));
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const KeyType &key, const ValueType &value,
+                                                   BufferPoolManager *buffer_pool_manager) {
+  InsertEntry(0, key, value);
+  Page* page = buffer_pool_manager->FetchPage(value);
   BPlusTreePage* node = reinterpret_cast<BPlusTreePage*>(page->GetData());
   node->SetParentPageId(GetPageId());
   buffer_pool_manager->UnpinPage(page->GetPageId(), true);
-  IncreaseSize(1);
 
 }
 
@@ -9,10 +9,14 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <array>
 #include <sstream>
 
 #include "common/exception.h"
+#include "common/macros.h"
 #include "common/rid.h"
+#include "storage/index/key_search.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -24,16 +28,31 @@ namespace bustub {
 /**
  * Init method after creating a new leaf page
  * Including set page type, set current size to zero, set page id/parent id, set
- * next page id and set max size
+ * next page id and set max size. A slotted page keeps its fingerprints at the
+ * end of the page, behind the key heap.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size, bool fingerprints,
+                                      int key_width, bool slotted) {
   SetPageType(IndexPageType::LEAF_PAGE);
   SetPageId(page_id);
   SetParentPageId(parent_id);
   SetSize(0);
   SetMaxSize(max_size);
   SetNextPageId(INVALID_PAGE_ID);
+  SetPrevPageId(INVALID_PAGE_ID);
+  BUSTUB_ASSERT(!fingerprints || max_size <= (slotted ? MaxSizeForSlottedKeys(true) : MaxSizeWithFingerprints()),
+                "no room for the fingerprints");
+  if(!fingerprints){
+    fingerprint_offset_ = 0;
+  }else if(slotted){
+    fingerprint_offset_ = static_cast<uint16_t>(PAGE_SIZE - max_size);
+  }else{
+    fingerprint_offset_ = static_cast<uint16_t>(LEAF_PAGE_HEADER_SIZE + max_size * sizeof(MappingType));
+  }
+  fingerprint_width_ = static_cast<uint16_t>(key_width);
+  heap_begin_ = slotted ? Capacity() : 0;
+  key_bytes_ = 0;
 }
 
 /**
@@ -47,6 +66,14 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const { return __atomic_load_n(&prev_page_id_, __ATOMIC_RELAXED); }
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  __atomic_store_n(&prev_page_id_, prev_page_id, __ATOMIC_RELAXED);
+}
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
  * NOTE: This method is only used when generating index iterator
@@ -58,6 +85,11 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator
       return i;
     }
   }*/
+  int width = comparator.IntegerKeyWidth();
+  if(width != 0 && !IsSlotted()){
+    return IntegerKeySearch(reinterpret_cast<const char*>(&array[0].first), sizeof(MappingType), 0, GetSize(),
+                            reinterpret_cast<const char*>(&key), width);
+  }
   int left = 0;
   int right = GetSize() - 1;
   while(left <= right){
@@ -71,46 +103,277 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator
   return right + 1;
 }
 
+/**
+ * Helper method to find the first index i so that array[i].first > key, i.e.
+ * one past the last entry equal to key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::UpperKeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  int width = comparator.IntegerKeyWidth();
+  if(width != 0 && !IsSlotted()){
+    return IntegerKeySearch<true>(reinterpret_cast<const char*>(&array[0].first), sizeof(MappingType), 0, GetSize(),
+                                  reinterpret_cast<const char*>(&key), width);
+  }
+  int left = 0;
+  int right = GetSize() - 1;
+  while(left <= right){
+    int mid = (left + right) / 2;
+    if(comparator(KeyAt(mid), key) > 0){
+      right = mid - 1;
+    }else{
+      left = mid + 1;
+    }
+  }
+  return right + 1;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+uint8_t B_PLUS_TREE_LEAF_PAGE_TYPE::Fingerprint(const KeyType &key) const {
+  const char *bytes = reinterpret_cast<const char*>(&key);
+  uint64_t hash = 0;
+  size_t i = 0;
+  for(; i + sizeof(uint64_t) <= fingerprint_width_; i += sizeof(uint64_t)){
+    uint64_t word;
+    memcpy(&word, bytes + i, sizeof(uint64_t));
+    hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 32;
+  }
+  for(; i < fingerprint_width_; i++){
+    hash = (hash ^ static_cast<uint8_t>(bytes[i])) * 0x9E3779B97F4A7C15ULL;
+  }
+  return static_cast<uint8_t>(hash >> 56);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::FindEntry(const KeyType &key, const ValueType *value,
+                                          const KeyComparator &comparator) const {
+  if(HasFingerprints()){
+    // equal keys are adjacent and scanned in order, so the first match is the first equal entry
+    return FingerprintSearch(Fingerprints(), 0, GetSize(), Fingerprint(key), [&](int i) {
+      return comparator(KeyAt(i), key) == 0 && (value == nullptr || ValueAt(i) == *value);
+    });
+  }
+  for(int index = KeyIndex(key, comparator); index < GetSize() && comparator(key, KeyAt(index)) == 0; index++){
+    if(value == nullptr || ValueAt(index) == *value){
+      return index;
+    }
+  }
+  return GetSize();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertFingerprint(int index, const KeyType &key) {
+  if(HasFingerprints()){
+    uint8_t *fingerprints = Fingerprints();
+    memmove(fingerprints + index + 1, fingerprints + index, GetSize() - index);
+    fingerprints[index] = Fingerprint(key);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveFingerprint(int index) {
+  if(HasFingerprints()){
+    uint8_t *fingerprints = Fingerprints();
+    memmove(fingerprints + index, fingerprints + index + 1, GetSize() - index - 1);
+  }
+}
+
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code
+  if(IsSlotted()){
+    KeyType key{};
+    uint16_t offset;
+    memcpy(&offset, SlotAt(index), sizeof(uint16_t));
+    memcpy(&key, Data() + offset, KeyLengthAt(index));
+    return key;
+  }
   return array[index].first;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const {
+  if(IsSlotted()){
+    ValueType value;
+    memcpy(&value, SlotAt(index) + 2 * sizeof(uint16_t), sizeof(ValueType));
+    return value;
+  }
+  return array[index].second;
+}
+
 /*
  * Helper method to find and return the key & value pair associated with input
  * "index"(a.k.a array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
-  // replace with your own code
+MappingType B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const {
+  if(IsSlotted()){
+    return MappingType{KeyAt(index), ValueAt(index)};
+  }
   return array[index];
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+uint16_t B_PLUS_TREE_LEAF_PAGE_TYPE::KeyLengthAt(int index) const {
+  uint16_t length;
+  memcpy(&length, SlotAt(index) + sizeof(uint16_t), sizeof(uint16_t));
+  return length;
+}
+
+/*
+ * The bytes of key past the returned length are all zero, KeyAt zero fills the
+ * key before copying the stored bytes. The whole KeyType is considered, the
+ * bytes past the key columns may hold included columns.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::StoredLength(const KeyType &key) {
+  const char *bytes = reinterpret_cast<const char *>(&key);
+  int length = sizeof(KeyType);
+  while(length > 0 && bytes[length - 1] == 0){
+    length--;
+  }
+  return length;
+}
+
+/*
+ * Move the key bytes still referred to by a slot to the end of the heap, so
+ * that all free space is between the slots and the heap
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CompactKeys() {
+  std::array<char, PAGE_SIZE> heap;
+  uint16_t end = Capacity();
+  for(int i = 0; i < GetSize(); i++){
+    uint16_t offset;
+    uint16_t length = KeyLengthAt(i);
+    memcpy(&offset, SlotAt(i), sizeof(uint16_t));
+    end -= length;
+    memcpy(heap.data() + end, Data() + offset, length);
+    memcpy(SlotAt(i), &end, sizeof(uint16_t));
+  }
+  memcpy(Data() + end, heap.data() + end, Capacity() - end);
+  heap_begin_ = end;
+}
+
+/*
+ * Make room for an entry at index and fill it in, the fingerprints have to be
+ * updated by the caller
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertEntry(int index, const KeyType &key, const ValueType &value) {
+  if(!IsSlotted()){
+    std::copy_backward(array + index, array + GetSize(), array + GetSize() + 1);
+    array[index] = MappingType{key, value};
+    IncreaseSize(1);
+    return;
+  }
+  uint16_t length = StoredLength(key);
+  if(heap_begin_ - (GetSize() + 1) * SlotSize() < length){
+    CompactKeys();
+  }
+  memmove(SlotAt(index + 1), SlotAt(index), (GetSize() - index) * SlotSize());
+  heap_begin_ -= length;
+  memcpy(Data() + heap_begin_, &key, length);
+  memcpy(SlotAt(index), &heap_begin_, sizeof(uint16_t));
+  memcpy(SlotAt(index) + sizeof(uint16_t), &length, sizeof(uint16_t));
+  memcpy(SlotAt(index) + 2 * sizeof(uint16_t), &value, sizeof(ValueType));
+  key_bytes_ += length;
+  IncreaseSize(1);
+}
+
+/*
+ * Close the gap left by the entry at index, the fingerprints have to be updated
+ * by the caller
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveEntry(int index) {
+  if(IsSlotted()){
+    // the key bytes stay in the heap until it is compacted
+    key_bytes_ -= KeyLengthAt(index);
+    memmove(SlotAt(index), SlotAt(index + 1), (GetSize() - index - 1) * SlotSize());
+  }else{
+    std::copy(array + index + 1, array + GetSize(), array + index);
+  }
+  IncreaseSize(-1);
+}
+
+/*
+ * Drop the entries from size on
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Truncate(int size) {
+  if(IsSlotted()){
+    for(int i = size; i < GetSize(); i++){
+      key_bytes_ -= KeyLengthAt(i);
+    }
+    if(size == 0){
+      heap_begin_ = Capacity();
+    }
+  }
+  SetSize(size);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsFull() const {
+  return GetSize() >= GetMaxSize() || (IsSlotted() && FreeSpace() < MaxEntrySize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomForInsert() const {
+  return GetSize() + 1 < GetMaxSize() && (!IsSlotted() || FreeSpace() >= 2 * MaxEntrySize());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderfull(int min_size, int removed) const {
+  if(GetSize() - removed >= min_size){
+    return false;
+  }
+  // with short keys a slotted page reaches its space before max size, then the space decides
+  return !IsSlotted() || UsedSpace() - removed * MaxEntrySize() < (Capacity() - MaxEntrySize()) / 2;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanMergeWith(const BPlusTreeLeafPage *sibling) const {
+  if(GetSize() + sibling->GetSize() >= GetMaxSize()){
+    return false;
+  }
+  return !IsSlotted() || UsedSpace() + sibling->UsedSpace() + MaxEntrySize() <= Capacity();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanAppend(const KeyType &key) const {
+  if(GetSize() + 1 >= GetMaxSize()){
+    return false;
+  }
+  return !IsSlotted() || FreeSpace() - SlotSize() - StoredLength(key) >= MaxEntrySize();
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
 /*
  * Insert key & value pair into leaf page ordered by key
+ * If unique is false, a duplicate key is inserted after the entries equal to it
  * @return  page size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-  int index = KeyIndex(key, comparator);
-  if (comparator(KeyAt(index), key) == 0) {  // 重复的key
-    return GetSize();
-  }
-
-  for(int i = GetSize(); i > index; i--){
-    array[i] = array[i-1];
+int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator,
+                                       bool unique) {
+  int index;
+  if(unique){
+    index = KeyIndex(key, comparator);
+    if (index < GetSize() && comparator(KeyAt(index), key) == 0) {  // 重复的key
+      return GetSize();
+    }
+  }else{
+    index = UpperKeyIndex(key, comparator);
   }
-  array[index] = MappingType{key, value};
 
-  IncreaseSize(1);
+  InsertFingerprint(index, key);
+  InsertEntry(index, key, value);
   return GetSize();
 }
 
@@ -123,17 +386,50 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
   int size = GetSize() / 2;
-  int move_num = GetSize() - size;
-  recipient->CopyNFrom(array + size, move_num);
-  IncreaseSize(-move_num);
+  if(IsSlotted() && GetSize() < GetMaxSize()){
+    // full by space rather than by size, split where the used space halves, keeping an entry on either side
+    int used = SlotSize() + KeyLengthAt(0);
+    size = 1;
+    while(size < GetSize() - 1 && used < UsedSpace() / 2){
+      used += SlotSize() + KeyLengthAt(size);
+      size++;
+    }
+  }
+  MoveTailTo(recipient, GetSize() - size);
+}
+
+/*
+ * Remove the last size key & value pairs from this page to "recipient" page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveTailTo(BPlusTreeLeafPage *recipient, int size) {
+  if(IsSlotted()){
+    for(int i = GetSize() - size; i < GetSize(); i++){
+      recipient->CopyLastFrom(GetItem(i));
+    }
+  }else{
+    recipient->CopyNFrom(array + GetSize() - size, size);
+  }
+  Truncate(GetSize() - size);
 }
 
 /*
  * Copy starting from items, and copy {size} number of elements into me.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(const MappingType *items, int size) {
+  if(IsSlotted()){
+    for(int i = 0; i < size; i++){
+      CopyLastFrom(items[i]);
+    }
+    return;
+  }
   std::copy(items, items + size, array + GetSize());
+  if(HasFingerprints()){
+    for(int i = 0; i < size; i++){
+      Fingerprints()[GetSize() + i] = Fingerprint(items[i].first);
+    }
+  }
   IncreaseSize(size);
 }
 
@@ -147,11 +443,13 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
-  int index = KeyIndex(key, comparator);
-  if(index == GetSize() || comparator(key, KeyAt(index)) != 0){
+  int index = FindEntry(key, nullptr, comparator);
+  if(index == GetSize()){
     return false;
   }
-  *value = array[index].second;
+  if(value != nullptr){
+    *value = ValueAt(index);
+  }
   return true;
 }
 
@@ -166,15 +464,29 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-  int index = KeyIndex(key, comparator);
-  if(index == GetSize() || comparator(key, KeyAt(index)) != 0){
+  int index = FindEntry(key, nullptr, comparator);
+  if(index == GetSize()){
     return GetSize();
   }
-  for(int i = index; i <= GetSize() - 2; i++){
-    array[i] = array[i+1];
+  RemoveFingerprint(index);
+  RemoveEntry(index);
+  return GetSize();
+}
+
+/*
+ * Same as above, but only delete the entry holding both key and value, so a
+ * single duplicate can be removed
+ * @return   page size after deletion
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const ValueType &value,
+                                                      const KeyComparator &comparator) {
+  int index = FindEntry(key, &value, comparator);
+  if(index == GetSize()){
+    return GetSize();
   }
-  
-  IncreaseSize(-1);
+  RemoveFingerprint(index);
+  RemoveEntry(index);
   return GetSize();
 }
 
@@ -188,9 +500,8 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
   // page_id_t page_id = GetNextPageId();
-  recipient->CopyNFrom(array, GetSize());
+  MoveTailTo(recipient, GetSize());
   // recipient->SetNextPageId(page_id);
-  SetSize(0);
 }
 
 /*****************************************************************************
@@ -202,10 +513,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
   recipient->CopyLastFrom(GetItem(0));
-  for(int i = 0; i < GetSize() - 1; i++){
-    array[i] = array[i+1];
-  }
-  IncreaseSize(-1);
+  RemoveFingerprint(0);
+  RemoveEntry(0);
 }
 
 /*
@@ -213,8 +522,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
-  array[GetSize()] = item;
-  IncreaseSize(1);
+  InsertFingerprint(GetSize(), item.first);
+  InsertEntry(GetSize(), item.first, item.second);
 }
 
 /*
@@ -223,7 +532,7 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
   recipient->CopyFirstFrom(GetItem(GetSize()-1));
-  IncreaseSize(-1);
+  Truncate(GetSize() - 1);
 }
 
 /*
@@ -231,12 +540,8 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient)
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
-  for(int i = GetSize(); i > 0; i--){
-    array[i] = array[i-1];
-  }
-  array[0] = item;
-  IncreaseSize(1);
-
+  InsertFingerprint(0, item.first);
+  InsertEntry(0, item.first, item.second);
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
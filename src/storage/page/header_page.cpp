@@ -12,6 +12,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "murmur3/MurmurHash3.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -23,21 +24,23 @@ bool HeaderPage::InsertRecord(const std::string &name, const page_id_t root_id)
   assert(name.length() < 32);
   assert(root_id > INVALID_PAGE_ID);
 
+  ConvertToHashed();
   int record_num = GetRecordCount();
-  int offset = 4 + record_num * 36;
   // check for duplicate name
-  if (FindRecord(name) != -1) {
+  if (FindRecord(name) != -1 || record_num == (IsHashed() ? MAX_RECORD_COUNT : UNHASHED_MAX_RECORD_COUNT)) {
     return false;
   }
   // copy record content
-  memcpy(GetData() + offset, name.c_str(), (name.length() + 1));
-  memcpy((GetData() + offset + 32), &root_id, 4);
+  memcpy(RecordAt(record_num), name.c_str(), (name.length() + 1));
+  memcpy(RecordAt(record_num) + 32, &root_id, 4);
+  InsertSlot(name, record_num);
 
   SetRecordCount(record_num + 1);
   return true;
 }
 
 bool HeaderPage::DeleteRecord(const std::string &name) {
+  ConvertToHashed();
   int record_num = GetRecordCount();
   assert(record_num > 0);
 
@@ -46,24 +49,25 @@ bool HeaderPage::DeleteRecord(const std::string &name) {
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
-  memmove(GetData() + offset, GetData() + offset + 36, (record_num - index - 1) * 36);
+  memmove(RecordAt(index), RecordAt(index + 1), (record_num - index - 1) * RECORD_SIZE);
 
   SetRecordCount(record_num - 1);
+  // the records behind the deleted one moved, so their slots are stale
+  RebuildSlots();
   return true;
 }
 
 bool HeaderPage::UpdateRecord(const std::string &name, const page_id_t root_id) {
   assert(name.length() < 32);
 
+  ConvertToHashed();
   int index = FindRecord(name);
   // record does not exsit
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
   // update record content, only root_id
-  memcpy((GetData() + offset + 32), &root_id, 4);
+  memcpy(RecordAt(index) + 32, &root_id, 4);
 
   return true;
 }
@@ -76,8 +80,7 @@ bool HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) {
   if (index == -1) {
     return false;
   }
-  int offset = (index + 1) * 36;
-  *root_id = *reinterpret_cast<page_id_t *>(GetData() + offset);
+  memcpy(root_id, RecordAt(index) + 32, 4);
 
   return true;
 }
@@ -86,19 +89,68 @@ bool HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) {
  * helper functions
  */
 // record count
-int HeaderPage::GetRecordCount() { return *reinterpret_cast<int *>(GetData()); }
+int HeaderPage::GetRecordCount() { return static_cast<int>(CountWord() & ~HASHED_FORMAT); }
 
-void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData(), &record_count, 4); }
+void HeaderPage::SetRecordCount(int record_count) {
+  SetCountWord(static_cast<uint32_t>(record_count) | (CountWord() & HASHED_FORMAT));
+}
 
-int HeaderPage::FindRecord(const std::string &name) {
+void HeaderPage::ConvertToHashed() {
   int record_num = GetRecordCount();
+  if (IsHashed() || record_num > MAX_RECORD_COUNT) {
+    return;
+  }
+  memmove(GetData() + RECORDS_OFFSET, GetData() + UNHASHED_RECORDS_OFFSET, record_num * RECORD_SIZE);
+  SetCountWord(static_cast<uint32_t>(record_num) | HASHED_FORMAT);
+  RebuildSlots();
+}
 
-  for (int i = 0; i < record_num; i++) {
-    char *raw_name = reinterpret_cast<char *>(GetData() + (4 + i * 36));
-    if (strcmp(raw_name, name.c_str()) == 0) {
-      return i;
+int HeaderPage::HomeSlot(const std::string &name) {
+  uint32_t hash = murmur3::MurmurHash3_x86_32(name.data(), static_cast<uint32_t>(name.length()), HASH_SEED);
+  return static_cast<int>(hash % HASH_SLOT_COUNT);
+}
+
+int HeaderPage::FindRecord(const std::string &name) {
+  int record_num = GetRecordCount();
+  if (!IsHashed()) {
+    for (int i = 0; i < record_num; i++) {
+      if (strcmp(RecordAt(i), name.c_str()) == 0) {
+        return i;
+      }
+    }
+    return -1;
+  }
+  uint8_t *slots = Slots();
+  // there are more slots than records, so the probe always reaches a free slot
+  for (int slot = HomeSlot(name); slots[slot] != 0; slot = (slot + 1) % HASH_SLOT_COUNT) {
+    int index = slots[slot] - 1;
+    if (strcmp(RecordAt(index), name.c_str()) == 0) {
+      return index;
     }
   }
   return -1;
 }
+
+void HeaderPage::InsertSlot(const std::string &name, int index) {
+  if (!IsHashed()) {
+    return;
+  }
+  uint8_t *slots = Slots();
+  int slot = HomeSlot(name);
+  while (slots[slot] != 0) {
+    slot = (slot + 1) % HASH_SLOT_COUNT;
+  }
+  slots[slot] = static_cast<uint8_t>(index + 1);
+}
+
+void HeaderPage::RebuildSlots() {
+  if (!IsHashed()) {
+    return;
+  }
+  memset(Slots(), 0, HASH_SLOT_COUNT);
+  int record_num = GetRecordCount();
+  for (int i = 0; i < record_num; i++) {
+    InsertSlot(RecordAt(i), i);
+  }
+}
 }  // namespace bustub
@@ -16,7 +16,9 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "concurrency/transaction.h"
 #include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -48,4 +50,149 @@ TEST(CatalogTest, DISABLED_CreateTableTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+TEST(CatalogTest, DISABLED_ParallelIndexBuildTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  // page 0 holds the index roots
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+  Transaction txn(0);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema(columns);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  // A is unique and inserted in reverse, B repeats every 100 tuples
+  const int count = 20000;
+  for (int i = 0; i < count; i++) {
+    RID rid;
+    Tuple tuple({ValueFactory::GetIntegerValue(count - i), ValueFactory::GetIntegerValue(i % 100)}, &schema);
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rid, &txn));
+  }
+
+  catalog->SetIndexBuildThreads(3);
+  IndexBuildProgress last{0, 0, false};
+  Schema key_schema_a(std::vector<Column>{columns[0]});
+  auto *index_a = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "potato", schema, key_schema_a, {0}, 8, true, {},
+      [&last](const IndexBuildProgress &progress) { last = progress; });
+  EXPECT_EQ("index_a", index_a->name_);
+  EXPECT_EQ(index_a, catalog->GetIndex("index_a", "potato"));
+  EXPECT_TRUE(last.done_);
+  EXPECT_EQ(count, last.tuples_scanned_);
+  EXPECT_GT(last.pages_scanned_, 1);
+
+  std::vector<RID> rids;
+  index_a->index_->ScanRange(nullptr, true, nullptr, true, &rids, &txn);
+  ASSERT_EQ(count, rids.size());
+  for (int i = 0; i < count; i++) {
+    Tuple tuple;
+    ASSERT_TRUE(table_metadata->table_->GetTuple(rids[i], &tuple, &txn));
+    EXPECT_EQ(i + 1, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+
+  catalog->SetIndexBuildThreads(4);
+  Schema key_schema_b(std::vector<Column>{columns[1]});
+  auto *index_b = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(&txn, "index_b", "potato", schema,
+                                                                                 key_schema_b, {1}, 8, false);
+  for (int b = 0; b < 100; b++) {
+    rids.clear();
+    index_b->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(b)}, &key_schema_b), &rids, &txn);
+    EXPECT_EQ(count / 100, rids.size());
+    // the entries of a key are in table order, whichever worker scanned their pages
+    for (size_t i = 1; i < rids.size(); i++) {
+      EXPECT_LT(rids[i - 1].Get(), rids[i].Get());
+    }
+  }
+
+  // a unique index keeps the first tuple of a key in table order, the one with B = b is inserted as A = count - b
+  for (size_t threads : {size_t{2}, size_t{4}}) {
+    catalog->SetIndexBuildThreads(threads);
+    auto *index_b_unique = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+        &txn, "index_b_unique" + std::to_string(threads), "potato", schema, key_schema_b, {1}, 8, true);
+    for (int b = 0; b < 100; b++) {
+      rids.clear();
+      index_b_unique->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(b)}, &key_schema_b), &rids, &txn);
+      ASSERT_EQ(1, rids.size());
+      Tuple tuple;
+      ASSERT_TRUE(table_metadata->table_->GetTuple(rids[0], &tuple, &txn));
+      EXPECT_EQ(count - b, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+  }
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(CatalogTest, DISABLED_HashIndexTest) {
+  auto disk_manager = new DiskManager("catalog_test.db");
+  auto bpm = new BufferPoolManager(64, disk_manager);
+  auto catalog = new Catalog(bpm, nullptr, nullptr);
+  Transaction txn(0);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::INTEGER);
+  Schema schema(columns);
+  auto *table_metadata = catalog->CreateTable(&txn, "potato", schema);
+  // more tuples than the initial buckets of a hash index, A is unique and B repeats every 100 tuples
+  const int count = 5000;
+  for (int i = 0; i < count; i++) {
+    RID rid;
+    Tuple tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(i % 100)}, &schema);
+    ASSERT_TRUE(table_metadata->table_->InsertTuple(tuple, &rid, &txn));
+  }
+
+  catalog->SetIndexBuildThreads(2);
+  Schema key_schema_a(std::vector<Column>{columns[0]});
+  auto *index_a = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_a", "potato", schema, key_schema_a, {0}, 8, true, {}, nullptr, IndexType::HASH);
+  Schema key_schema_b(std::vector<Column>{columns[1]});
+  auto *index_b = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_b", "potato", schema, key_schema_b, {1}, 8, false, {}, nullptr, IndexType::HASH);
+  auto *index_c = catalog->CreateIndex<GenericKey<8>, RID, GenericComparator<8>>(
+      &txn, "index_c", "potato", schema, key_schema_b, {1}, 8, false, {}, nullptr, IndexType::EXTENDIBLE_HASH);
+
+  std::vector<RID> rids;
+  for (int i = 0; i < count; i++) {
+    rids.clear();
+    index_a->index_->ScanKey(Tuple({ValueFactory::GetIntegerValue(i)}, &key_schema_a), &rids, &txn);
+    ASSERT_EQ(1, rids.size());
+    Tuple tuple;
+    ASSERT_TRUE(table_metadata->table_->GetTuple(rids[0], &tuple, &txn));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  }
+  for (int b = 0; b < 100; b++) {
+    rids.clear();
+    Tuple key({ValueFactory::GetIntegerValue(b)}, &key_schema_b);
+    index_b->index_->ScanRange(&key, true, &key, true, &rids, &txn);
+    EXPECT_EQ(count / 100, rids.size());
+    rids.clear();
+    index_c->index_->ScanRange(&key, true, &key, true, &rids, &txn);
+    EXPECT_EQ(count / 100, rids.size());
+  }
+
+  // a unique index rejects a second entry for a key, a range other than a single key is not supported
+  Tuple key({ValueFactory::GetIntegerValue(7)}, &key_schema_a);
+  index_a->index_->InsertEntry(key, RID(0, 0), &txn);
+  rids.clear();
+  index_a->index_->ScanKey(key, &rids, &txn);
+  EXPECT_EQ(1, rids.size());
+  EXPECT_THROW(index_a->index_->ScanRange(&key, true, nullptr, true, &rids, &txn), NotImplementedException);
+  index_a->index_->DeleteEntry(key, rids[0], &txn);
+  rids.clear();
+  index_a->index_->ScanKey(key, &rids, &txn);
+  EXPECT_TRUE(rids.empty());
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
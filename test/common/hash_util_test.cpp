@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_util_test.cpp
+//
+// Identification: test/common/hash_util_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashValueTest) {
+  auto hash = [](const Value &value) { return HashUtil::HashValue(&value); };
+  // equal values of the integer types hash the same, so that they can be compared across types
+  EXPECT_EQ(hash(ValueFactory::GetIntegerValue(-7)), hash(ValueFactory::GetBigIntValue(-7)));
+  EXPECT_EQ(hash(ValueFactory::GetTinyIntValue(12)), hash(ValueFactory::GetSmallIntValue(12)));
+  EXPECT_NE(hash(ValueFactory::GetIntegerValue(1)), hash(ValueFactory::GetIntegerValue(2)));
+
+  std::string text(100, 'x');
+  Value a = ValueFactory::GetVarcharValue(text);
+  Value b = ValueFactory::GetVarcharValue(text);
+  EXPECT_EQ(hash(a), hash(b));
+  text[99] = 'y';
+  Value c = ValueFactory::GetVarcharValue(text);
+  EXPECT_NE(hash(a), hash(c));
+
+  // combining is order sensitive
+  hash_t one = hash(ValueFactory::GetIntegerValue(1));
+  hash_t two = hash(ValueFactory::GetIntegerValue(2));
+  EXPECT_NE(HashUtil::CombineHashes(one, two), HashUtil::CombineHashes(two, one));
+}
+
+// NOLINTNEXTLINE
+TEST(HashUtilTest, HashBytesTest) {
+  // every length up to a few words, including the tail bytes the word loops load separately
+  std::string bytes = "the quick brown fox jumps over the lazy dog";
+  std::unordered_set<hash_t> murmur;
+  std::unordered_set<hash_t> crc;
+  for (size_t length = 0; length <= bytes.size(); length++) {
+    EXPECT_EQ(HashUtil::HashBytes(bytes.data(), length), HashUtil::HashBytes(bytes.substr(0, length).data(), length));
+    EXPECT_EQ(HashUtil::HashBytesCrc(bytes.data(), length),
+              HashUtil::HashBytesCrc(bytes.substr(0, length).data(), length));
+    murmur.insert(HashUtil::HashBytes(bytes.data(), length));
+    crc.insert(HashUtil::HashBytesCrc(bytes.data(), length));
+  }
+  EXPECT_EQ(bytes.size() + 1, murmur.size());
+  EXPECT_EQ(bytes.size() + 1, crc.size());
+  // a string and the same string padded with zero bytes differ
+  std::string padded("ab\0\0", 4);
+  EXPECT_NE(HashUtil::HashBytesCrc(padded.data(), 2), HashUtil::HashBytesCrc(padded.data(), 4));
+}
+
+namespace {
+
+// the byte at a time hash HashUtil::HashBytes used before
+hash_t LegacyHashBytes(const char *bytes, size_t length) {
+  hash_t hash = length;
+  for (size_t i = 0; i < length; ++i) {
+    hash = ((hash << 5) ^ (hash >> 27)) ^ bytes[i];
+  }
+  return hash;
+}
+
+template <typename F>
+void RunHashBenchmark(const char *name, const std::vector<std::string> &keys, F &&hash) {
+  const int rounds = 20;
+  size_t bytes = 0;
+  hash_t sink = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (const auto &key : keys) {
+      sink ^= hash(key.data(), key.size());
+      bytes += key.size();
+    }
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  // collisions in a power of two table with as many buckets as keys, the way the hash tables use the low bits
+  const size_t buckets = 1 << 16;
+  std::vector<int> used(buckets, 0);
+  size_t collisions = 0;
+  for (size_t i = 0; i < buckets && i < keys.size(); i++) {
+    collisions += used[hash(keys[i].data(), keys[i].size()) & (buckets - 1)]++ > 0 ? 1 : 0;
+  }
+  printf("%-8s %8.1f MB/s %6.1f ns/key, %5.2f%% of %zu keys collide (%zx)\n", name, bytes / elapsed.count() / 1e6,
+         elapsed.count() * 1e9 / (rounds * keys.size()), 100.0 * collisions / std::min(buckets, keys.size()),
+         std::min(buckets, keys.size()), sink & 0xf);
+}
+
+}  // namespace
+
+/*
+ * Microbenchmark of the byte string hashes on group by keys of a few shapes. Prints the throughput and the share of
+ * keys that land in an occupied bucket of a table with as many buckets as keys, about 37% for a uniform hash.
+ */
+// NOLINTNEXTLINE
+TEST(HashUtilTest, DISABLED_HashBenchmark) {
+  const size_t count = 1 << 16;
+  std::vector<std::pair<const char *, std::vector<std::string>>> workloads(3);
+  workloads[0].first = "8 byte integers";
+  workloads[1].first = "short strings";
+  workloads[2].first = "100 byte strings";
+  for (size_t i = 0; i < count; i++) {
+    auto value = static_cast<int64_t>(i);
+    workloads[0].second.emplace_back(reinterpret_cast<const char *>(&value), sizeof(value));
+    workloads[1].second.push_back("customer#" + std::to_string(i));
+    workloads[2].second.push_back(std::string(90, 'a') + std::to_string(i * 7919));
+  }
+  for (const auto &[name, keys] : workloads) {
+    printf("%s:\n", name);
+    RunHashBenchmark("legacy", keys, LegacyHashBytes);
+    RunHashBenchmark("murmur3", keys, HashUtil::HashBytes);
+    RunHashBenchmark("crc32c", keys, HashUtil::HashBytesCrc);
+  }
+  std::vector<std::string> integers = workloads[0].second;
+  RunHashBenchmark("hashint", integers, [](const char *bytes, size_t length) {
+    int64_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return HashUtil::Hash(&value);
+  });
+}
+
+}  // namespace bustub
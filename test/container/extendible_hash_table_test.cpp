@@ -0,0 +1,181 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// extendible_hash_table_test.cpp
+//
+// Identification: test/container/extendible_hash_table_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "container/hash/extendible_hash_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, SampleTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, 2 * i + 1));
+  }
+  // the same (key, value) is only stored once
+  EXPECT_FALSE(ht.Insert(nullptr, 3, 3));
+  for (int i = 0; i < 5; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    std::sort(res.begin(), res.end());
+    EXPECT_EQ((std::vector<int>{i, 2 * i + 1}), res);
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, 20, &res));
+
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((std::vector<int>{2 * i + 1}), res);
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  EXPECT_TRUE(ht.VerifyIntegrity());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, GrowShrinkTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>(), true);
+
+  // many times the keys of one bucket page, the directory has to double a few times
+  const int count = 20000;
+  std::vector<int> keys(count);
+  for (int i = 0; i < count; i++) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (int key : keys) {
+    EXPECT_TRUE(ht.Insert(nullptr, key, key * 3));
+  }
+  EXPECT_FALSE(ht.Insert(nullptr, 5, 0));
+  EXPECT_GT(ht.GetGlobalDepth(), 4);
+  EXPECT_TRUE(ht.VerifyIntegrity());
+  for (int i = 0; i < count; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i * 3, res[0]);
+  }
+
+  // removing half of the keys keeps the rest reachable, removing the rest merges everything back into one bucket
+  for (int i = 0; i < count; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i * 3));
+  }
+  EXPECT_TRUE(ht.VerifyIntegrity());
+  for (int i = 0; i < count; i++) {
+    std::vector<int> res;
+    EXPECT_EQ(i % 2 == 1, ht.GetValue(nullptr, i, &res));
+  }
+  for (int i = 1; i < count; i += 2) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i * 3));
+  }
+  EXPECT_EQ(0, ht.GetGlobalDepth());
+  EXPECT_TRUE(ht.VerifyIntegrity());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, OverflowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // no split separates the values of one key, they go to overflow pages
+  const int count = 1500;
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, 42, i));
+    EXPECT_EQ(i != 42, ht.Insert(nullptr, i, i));
+  }
+  EXPECT_TRUE(ht.VerifyIntegrity());
+  std::vector<int> res;
+  ht.GetValue(nullptr, 42, &res);
+  EXPECT_EQ(count, res.size());
+
+  for (int i = 0; i < count; i += 3) {
+    EXPECT_TRUE(ht.Remove(nullptr, 42, i));
+  }
+  res.clear();
+  ht.GetValue(nullptr, 42, &res);
+  EXPECT_EQ(count - count / 3, res.size());
+  for (int value : res) {
+    EXPECT_NE(0, value % 3);
+  }
+  EXPECT_TRUE(ht.VerifyIntegrity());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(ExtendibleHashTableTest, ConcurrentInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  const int num_threads = 4;
+  const int count = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t; i < count; i += num_threads) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        if (i % 5 == 0) {
+          EXPECT_TRUE(ht.Remove(nullptr, i, i));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(ht.VerifyIntegrity());
+  for (int i = 0; i < count; i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 5 == 0 ? 0 : 1, res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+}  // namespace bustub
@@ -104,4 +104,106 @@ TEST(HashTableTest, DISABLED_SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_GrowTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  // a single block to start with, the table has to grow several times
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 10, HashFunction<int>());
+  size_t initial_size = ht.GetSize();
+  const int count = 20000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&ht, t] {
+      for (int i = t; i < count; i += 4) {
+        EXPECT_TRUE(ht.Insert(nullptr, i, i));
+        if (i % 2 == 0) {
+          EXPECT_TRUE(ht.Insert(nullptr, i, -i - 1));
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_GT(ht.GetSize(), initial_size);
+
+  for (int i = 0; i < count; i++) {
+    std::vector<int> res;
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    ASSERT_EQ(i % 2 == 0 ? 2 : 1, res.size());
+  }
+  std::vector<int> res;
+  EXPECT_FALSE(ht.GetValue(nullptr, count, &res));
+
+  // removes leave tombstones behind, the probes have to run through them
+  for (int i = 0; i < count; i += 3) {
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    EXPECT_FALSE(ht.Remove(nullptr, i, i));
+  }
+  for (int i = 0; i < count; i++) {
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((i % 2 == 0 ? 2 : 1) - (i % 3 == 0 ? 1 : 0), res.size());
+  }
+
+  // a resize keeps every entry
+  ht.Resize(ht.GetSize());
+  for (int i = 0; i < count; i += 7) {
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ((i % 2 == 0 ? 2 : 1) - (i % 3 == 0 ? 1 : 0), res.size());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
+// NOLINTNEXTLINE
+TEST(HashTableTest, DISABLED_IncrementalResizeTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManager(50, disk_manager);
+
+  LinearProbeHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), 4000, HashFunction<int>());
+  const int count = 2000;
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(ht.Insert(nullptr, i, i));
+  }
+
+  // the resize only allocates the new table, the entries move over during the following inserts and removes
+  size_t old_size = ht.GetSize();
+  ht.Resize(old_size);
+  EXPECT_GE(ht.GetSize(), 2 * old_size);
+  std::vector<int> res;
+  for (int i = 0; i < count; i++) {
+    res.clear();
+    EXPECT_TRUE(ht.GetValue(nullptr, i, &res));
+    EXPECT_EQ(1, res.size());
+  }
+
+  // each operation below runs while entries are still spread over both tables
+  for (int i = 0; i < count; i += 2) {
+    EXPECT_FALSE(ht.Insert(nullptr, i, i));
+    EXPECT_TRUE(ht.Insert(nullptr, i, i + count));
+    EXPECT_TRUE(ht.Remove(nullptr, i, i));
+    res.clear();
+    ht.GetValue(nullptr, i + 1, &res);
+    EXPECT_EQ(1, res.size());
+  }
+  for (int i = 0; i < count; i++) {
+    res.clear();
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size());
+    EXPECT_EQ(i % 2 == 0 ? i + count : i, res[0]);
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,213 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_queue_test.cpp
+//
+// Identification: test/execution/batch_queue_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/exception.h"
+#include "execution/batch_queue.h"
+#include "execution/exchange_channel.h"
+#include "execution/query_worker_pool.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+/** @return a batch of one integer column holding value in each of rows rows */
+TupleBatch MakeBatch(int32_t value, uint32_t rows) {
+  TupleBatch batch;
+  batch.Reset(1);
+  for (uint32_t i = 0; i < rows; i++) {
+    batch.GetColumn(0).push_back(ValueFactory::GetIntegerValue(value));
+    batch.AppendRow(RID());
+  }
+  return batch;
+}
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(BatchQueueTest, BoundedFifoTest) {
+  BatchQueue queue(3);
+  // the capacity is rounded up to 4
+  for (int32_t i = 0; i < 4; i++) {
+    TupleBatch batch = MakeBatch(i, 1);
+    ASSERT_TRUE(queue.TryPush(&batch));
+  }
+  TupleBatch batch = MakeBatch(4, 1);
+  ASSERT_FALSE(queue.TryPush(&batch));
+  for (int32_t turn = 0; turn < 3; turn++) {
+    for (int32_t i = 0; i < 4; i++) {
+      ASSERT_TRUE(queue.TryPop(&batch));
+      EXPECT_EQ(turn * 4 + i, batch.GetValue(0, 0).GetAs<int32_t>());
+      TupleBatch next = MakeBatch((turn + 1) * 4 + i, 1);
+      ASSERT_TRUE(queue.TryPush(&next));
+    }
+  }
+  for (int32_t i = 0; i < 4; i++) {
+    ASSERT_TRUE(queue.TryPop(&batch));
+  }
+  ASSERT_FALSE(queue.TryPop(&batch));
+}
+
+// NOLINTNEXTLINE
+TEST(BatchQueueTest, ConcurrentTest) {
+  // every batch pushed by some producer is popped by exactly one consumer
+  const int32_t producers = 4;
+  const int32_t batches = 2000;
+  BatchQueue queue(8);
+  std::atomic<int32_t> producers_done{0};
+  std::vector<std::vector<int32_t>> popped(producers);
+  std::vector<std::thread> threads;
+  for (int32_t p = 0; p < producers; p++) {
+    threads.emplace_back([&, p] {
+      for (int32_t i = 0; i < batches; i++) {
+        TupleBatch batch = MakeBatch(p * batches + i, 1);
+        while (!queue.TryPush(&batch)) {
+          std::this_thread::yield();
+        }
+      }
+      producers_done++;
+    });
+    threads.emplace_back([&, p] {
+      TupleBatch batch;
+      while (true) {
+        if (queue.TryPop(&batch)) {
+          popped[p].push_back(batch.GetValue(0, 0).GetAs<int32_t>());
+        } else if (producers_done == producers) {
+          if (!queue.TryPop(&batch)) {
+            break;
+          }
+          popped[p].push_back(batch.GetValue(0, 0).GetAs<int32_t>());
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  std::vector<int32_t> seen(producers * batches, 0);
+  for (const auto &values : popped) {
+    for (int32_t value : values) {
+      seen[value]++;
+    }
+  }
+  for (int32_t count : seen) {
+    ASSERT_EQ(1, count);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BatchQueueTest, ExchangeChannelTest) {
+  // producers on the pool fill a channel of two queues, a failing producer's exception reaches the consumers
+  QueryWorkerPool pool;
+  for (bool fail : {false, true}) {
+    ExchangeChannel channel(2, 3);
+    ASSERT_TRUE(channel.MarkStarted());
+    ASSERT_FALSE(channel.MarkStarted());
+    for (int32_t p = 0; p < 3; p++) {
+      pool.Submit([&, p] {
+        std::exception_ptr error;
+        for (int32_t i = 0; i < 100; i++) {
+          TupleBatch batch = MakeBatch(p, 10);
+          // the others stop early once a producer failed
+          if (!channel.Push(i % 2, &batch)) {
+            ASSERT_TRUE(fail);
+            break;
+          }
+        }
+        if (fail && p == 1) {
+          error = std::make_exception_ptr(Exception("producer failed"));
+        }
+        channel.FinishProducer(error);
+      });
+    }
+    // a consumer per queue, the producers block on a full queue until it is read
+    std::atomic<uint32_t> rows{0};
+    std::atomic<uint32_t> errors{0};
+    std::vector<std::thread> consumers;
+    for (uint32_t queue = 0; queue < 2; queue++) {
+      consumers.emplace_back([&, queue] {
+        TupleBatch batch;
+        try {
+          while (channel.Pop(queue, &batch)) {
+            rows += batch.Size();
+          }
+        } catch (Exception &e) {
+          errors++;
+        }
+      });
+    }
+    for (auto &consumer : consumers) {
+      consumer.join();
+    }
+    if (fail) {
+      EXPECT_EQ(2, errors);
+    } else {
+      EXPECT_EQ(3 * 100 * 10, rows);
+      EXPECT_EQ(0, errors);
+    }
+    channel.Cancel();
+  }
+  // the producers of the first channel filled both queues before they were read, so each had a thread of its own
+  EXPECT_GE(pool.GetThreadCount(), 3);
+}
+
+// NOLINTNEXTLINE
+TEST(BatchQueueTest, ParkedThreadTest) {
+  // threads that wait longer than their spins park, and the other side wakes them up
+  ExchangeChannel channel(1, 1);
+  ASSERT_TRUE(channel.MarkStarted());
+  std::thread producer([&] {
+    // the consumer parks on the empty queue first
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int32_t i = 0; i < 100; i++) {
+      TupleBatch batch = MakeBatch(i, 1);
+      ASSERT_TRUE(channel.Push(0, &batch));
+    }
+    channel.FinishProducer(nullptr);
+  });
+  TupleBatch batch;
+  for (int32_t i = 0; i < 100; i++) {
+    ASSERT_TRUE(channel.Pop(0, &batch));
+    EXPECT_EQ(i, batch.GetValue(0, 0).GetAs<int32_t>());
+    // and the producer parks on the full queue
+    if (i == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+  }
+  ASSERT_FALSE(channel.Pop(0, &batch));
+  producer.join();
+
+  // a producer parked on a full queue stops once its consumer closes the queue
+  ExchangeChannel closed_channel(1, 1);
+  ASSERT_TRUE(closed_channel.MarkStarted());
+  std::thread blocked([&] {
+    for (int32_t i = 0; i < 100; i++) {
+      TupleBatch batch = MakeBatch(i, 1);
+      if (!closed_channel.Push(0, &batch)) {
+        break;
+      }
+    }
+    closed_channel.FinishProducer(nullptr);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  closed_channel.Close(0);
+  blocked.join();
+  ASSERT_TRUE(closed_channel.IsCancelled());
+}
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_key_test.cpp
+//
+// Identification: test/execution/sort_key_test.cpp
+//
+// Copyright (c) 2015-2019, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/loser_tree.h"
+#include "execution/sort_key.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(SortKeyTest, ValueOrderTest) {
+  // values in ascending order, each type sorted by the byte order of its normalized keys
+  std::vector<std::vector<Value>> ascending{
+      {ValueFactory::GetNullValueByType(TypeId::INTEGER), ValueFactory::GetIntegerValue(-1000000),
+       ValueFactory::GetIntegerValue(-1), ValueFactory::GetIntegerValue(0), ValueFactory::GetIntegerValue(1),
+       ValueFactory::GetIntegerValue(256), ValueFactory::GetIntegerValue(1000000)},
+      {ValueFactory::GetBigIntValue(-(1LL << 40)), ValueFactory::GetBigIntValue(-3), ValueFactory::GetBigIntValue(7),
+       ValueFactory::GetBigIntValue(1LL << 40)},
+      {ValueFactory::GetSmallIntValue(-300), ValueFactory::GetSmallIntValue(-2), ValueFactory::GetSmallIntValue(5)},
+      {ValueFactory::GetDecimalValue(-1e10), ValueFactory::GetDecimalValue(-2.5), ValueFactory::GetDecimalValue(-0.5),
+       ValueFactory::GetDecimalValue(0), ValueFactory::GetDecimalValue(0.25), ValueFactory::GetDecimalValue(3e8)},
+      {ValueFactory::GetVarcharValue(""), ValueFactory::GetVarcharValue("a"), ValueFactory::GetVarcharValue("ab"),
+       ValueFactory::GetVarcharValue("abc"), ValueFactory::GetVarcharValue("b"), ValueFactory::GetVarcharValue("ba")},
+  };
+  for (const auto &values : ascending) {
+    for (size_t i = 1; i < values.size(); i++) {
+      std::string smaller;
+      std::string larger;
+      SortKeyEncoder::AppendValue(values[i - 1], OrderByType::ASC, &smaller);
+      SortKeyEncoder::AppendValue(values[i], OrderByType::ASC, &larger);
+      EXPECT_LT(smaller, larger) << values[i - 1].ToString() << " " << values[i].ToString();
+      smaller.clear();
+      larger.clear();
+      SortKeyEncoder::AppendValue(values[i - 1], OrderByType::DESC, &smaller);
+      SortKeyEncoder::AppendValue(values[i], OrderByType::DESC, &larger);
+      EXPECT_GT(smaller, larger) << values[i - 1].ToString() << " " << values[i].ToString();
+    }
+  }
+
+  // a shorter string orders first as a key column too, before the keys after it are looked at
+  std::string a;
+  std::string ab;
+  SortKeyEncoder::AppendValue(ValueFactory::GetVarcharValue("a"), OrderByType::ASC, &a);
+  SortKeyEncoder::AppendValue(ValueFactory::GetIntegerValue(1000), OrderByType::ASC, &a);
+  SortKeyEncoder::AppendValue(ValueFactory::GetVarcharValue("ab"), OrderByType::ASC, &ab);
+  SortKeyEncoder::AppendValue(ValueFactory::GetIntegerValue(0), OrderByType::ASC, &ab);
+  EXPECT_LT(a, ab);
+}
+
+// NOLINTNEXTLINE
+TEST(SortKeyTest, LoserTreeTest) {
+  std::mt19937 gen(15445);
+  for (size_t k = 1; k <= 9; k++) {
+    // runs of (value, run) pairs sorted by value alone, so that the merge must keep runs in order among equal values
+    std::vector<std::vector<std::pair<int, size_t>>> runs(k);
+    std::vector<std::pair<int, size_t>> expected;
+    for (size_t run = 0; run < k; run++) {
+      size_t size = gen() % 50;
+      for (size_t i = 0; i < size; i++) {
+        runs[run].emplace_back(gen() % 20, run);
+      }
+      std::sort(runs[run].begin(), runs[run].end());
+      expected.insert(expected.end(), runs[run].begin(), runs[run].end());
+    }
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<size_t> cursors(k, 0);
+    auto less = [&](size_t a, size_t b) {
+      bool a_done = cursors[a] == runs[a].size();
+      bool b_done = cursors[b] == runs[b].size();
+      if (a_done || b_done) {
+        return !a_done && b_done;
+      }
+      return runs[a][cursors[a]].first < runs[b][cursors[b]].first;
+    };
+    LoserTree<decltype(less)> tree(k, less);
+    tree.Init();
+    std::vector<std::pair<int, size_t>> merged;
+    while (cursors[tree.Top()] < runs[tree.Top()].size()) {
+      size_t top = tree.Top();
+      merged.push_back(runs[top][cursors[top]++]);
+      tree.Replay(top);
+    }
+    EXPECT_EQ(expected, merged);
+  }
+}
+
+}  // namespace bustub
@@ -92,6 +92,26 @@ void DeleteHelperSplit(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree
   delete transaction;
 }
 
+// helper function to insert or remove one copy of every key in a tree with duplicate keys, the copy is the rid's
+// page id
+void DuplicateHelper(BPlusTree<GenericKey<8>, RID, GenericComparator<8>> *tree, const std::vector<int64_t> &keys,
+                     bool remove, uint64_t thread_itr) {
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(thread_itr), key);
+    index_key.SetFromInteger(key);
+    if (remove) {
+      tree->Remove(index_key, rid, transaction);
+    } else {
+      tree->Insert(index_key, rid, transaction);
+    }
+  }
+  delete transaction;
+}
+
 TEST(BPlusTreeConcurrentTest, DISABLED_InsertTest1) {
   // create KeyComparator and index schema
   Schema *key_schema = ParseCreateStatement("a bigint");
@@ -330,4 +350,185 @@ TEST(BPlusTreeConcurrentTest, DISABLED_MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, DISABLED_ReverseScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, small pages so that the scans cross many leaves while they split
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+  GenericKey<8> index_key;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // odd keys first, the even keys are inserted while scanning
+  std::vector<int64_t> keys;
+  std::vector<int64_t> concurrent_keys;
+  int64_t scale_factor = 1000;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    (key % 2 == 1 ? keys : concurrent_keys).push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  std::thread inserter(InsertHelperSplit, &tree, concurrent_keys, 1, 0);
+  for (int round = 0; round < 20; round++) {
+    // every odd key is visible, in descending order, whatever the inserter is doing
+    int64_t previous = scale_factor + 1;
+    int64_t odd_keys = 0;
+    for (auto iterator = tree.rbegin(); !iterator.isEnd(); ++iterator) {
+      int64_t current = (*iterator).first.ToString();
+      ASSERT_LT(current, previous);
+      odd_keys += current % 2;
+      previous = current;
+    }
+    EXPECT_EQ(odd_keys, keys.size());
+  }
+  inserter.join();
+
+  // start in the middle of the tree, both on an existing key and between keys
+  int64_t current_key = 500;
+  index_key.SetFromInteger(current_key);
+  for (auto iterator = tree.RBegin(index_key); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key - 1;
+  }
+  EXPECT_EQ(current_key, 0);
+
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 2; key <= scale_factor; key += 2) {
+    remove_keys.push_back(key);
+  }
+  DeleteHelper(&tree, remove_keys);
+  current_key = 499;
+  index_key.SetFromInteger(500);
+  for (auto iterator = tree.RBegin(index_key); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key = current_key - 2;
+  }
+  EXPECT_EQ(current_key, -1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, DISABLED_BatchedLookupTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree, small pages so that the inserts split leaves and internal pages all the time
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // odd keys first, the even keys are inserted while probing
+  std::vector<int64_t> keys;
+  std::vector<int64_t> concurrent_keys;
+  int64_t scale_factor = 2000;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    (key % 2 == 1 ? keys : concurrent_keys).push_back(key);
+  }
+  InsertHelper(&tree, keys);
+
+  // the probes are far apart, so the cursor descends from the root again for most of them
+  auto prober = [&](uint64_t thread_itr) {
+    std::vector<GenericKey<8>> probes;
+    for (int64_t key = 1 + 2 * static_cast<int64_t>(thread_itr); key <= scale_factor; key += 50) {
+      GenericKey<8> index_key;
+      index_key.SetFromInteger(key);
+      probes.push_back(index_key);
+    }
+    std::vector<std::vector<RID>> results;
+    for (int round = 0; round < 50; round++) {
+      tree.GetValues(probes, &results);
+      for (auto &rids : results) {
+        ASSERT_EQ(rids.size(), 1);
+      }
+    }
+  };
+  std::thread inserter(InsertHelperSplit, &tree, concurrent_keys, 1, 0);
+  LaunchParallelTest(2, prober);
+  inserter.join();
+
+  std::vector<RID> rids;
+  GenericKey<8> index_key;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, DISABLED_DuplicateKeyTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree that allows duplicate keys
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 5, false);
+  GenericKey<8> index_key;
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  std::vector<int64_t> keys;
+  int64_t scale_factor = 200;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    keys.push_back(key);
+  }
+  // every thread inserts its own copy of each key, then the first two threads take theirs out again
+  LaunchParallelTest(4, DuplicateHelper, &tree, keys, false);
+  LaunchParallelTest(2, DuplicateHelper, &tree, keys, true);
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    ASSERT_EQ(rids.size(), 2);
+    for (auto &location : rids) {
+      EXPECT_GE(location.GetPageId(), 2);
+      EXPECT_EQ(location.GetSlotNum(), key);
+    }
+  }
+
+  int64_t size = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    size = size + 1;
+  }
+  EXPECT_EQ(size, 2 * scale_factor);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
@@ -170,4 +170,136 @@ TEST(BPlusTreeTests, DISABLED_DeleteTest2) {
   remove("test.db");
   remove("test.log");
 }
+
+// count the non root leaves that hold fewer entries than their min size
+template <typename Tree>
+int CountUnderfullLeaves(Tree *tree, BufferPoolManager *bpm) {
+  int count = 0;
+  Page *page = tree->FindLeafPage(GenericKey<8>(), true);
+  page->RUnlatch();
+  while (page != nullptr) {
+    auto *leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(page->GetData());
+    if (!leaf->IsRootPage() && leaf->GetSize() < leaf->GetMinSize()) {
+      count++;
+    }
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : bpm->FetchPage(next_page_id);
+  }
+  return count;
+}
+
+TEST(BPlusTreeTests, DISABLED_LazyMergeTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 8, 6);
+  tree.SetMergePolicy(MergePolicy::LAZY);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t scale = 2000;
+  for (int64_t key = 1; key <= scale; key++) {
+    rid.Set(0, static_cast<int32_t>(key));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  // thin out the leaves without emptying them, a lazy tree does not rebalance any of them
+  for (int64_t key = 1; key <= scale; key++) {
+    if (key % 4 != 0) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  EXPECT_GT(CountUnderfullLeaves(&tree, bpm), 0);
+
+  EXPECT_GT(tree.Compact(), 0);
+  EXPECT_EQ(0, CountUnderfullLeaves(&tree, bpm));
+  EXPECT_EQ(0, tree.Compact());
+
+  // empty leaves are merged right away, the rest is left to the background task
+  tree.StartMaintenance(std::chrono::milliseconds(5));
+  for (int64_t key = 8; key <= scale; key += 8) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  tree.StopMaintenance();
+  tree.Compact();
+  EXPECT_EQ(0, CountUnderfullLeaves(&tree, bpm));
+
+  int64_t current_key = 4;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    EXPECT_EQ(current_key, (*iterator).second.GetSlotNum());
+    current_key += 8;
+  }
+  EXPECT_EQ(scale + 4, current_key);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+TEST(BPlusTreeTests, DISABLED_DuplicateRunDeleteTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // key 10 gets a run of duplicates over many leaves, later copies end up in later leaves of the run
+  const int64_t copies = 30;
+  for (int64_t key = 1; key <= 20; key++) {
+    rid.Set(0, static_cast<int32_t>(key));
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  index_key.SetFromInteger(10);
+  for (int64_t copy = 1; copy < copies; copy++) {
+    rid.Set(static_cast<int32_t>(copy), 10);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // deleting from the back of the run never reaches its first leaf by a descent
+  for (int64_t copy = copies - 1; copy >= 2; copy--) {
+    rid.Set(static_cast<int32_t>(copy), 10);
+    tree.Remove(index_key, rid, transaction);
+    EXPECT_EQ(0, CountUnderfullLeaves(&tree, bpm));
+  }
+  std::vector<RID> rids;
+  EXPECT_TRUE(tree.GetValue(index_key, &rids));
+  EXPECT_EQ(2, rids.size());
+  EXPECT_EQ(0, tree.Compact());
+
+  int64_t count = 0;
+  for (auto iterator = tree.begin(); iterator != tree.end(); ++iterator) {
+    count++;
+  }
+  EXPECT_EQ(21, count);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
 }  // namespace bustub
@@ -4,11 +4,14 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <random>
 
 #include "b_plus_tree_test_util.h"  // NOLINT
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 #include "storage/index/b_plus_tree.h"
+#include "type/value_factory.h"
 
 namespace bustub {
 
@@ -139,4 +142,867 @@ TEST(BPlusTreeTests, DISABLED_InsertTest2) {
   remove("test.db");
   remove("test.log");
 }
+TEST(BPlusTreeTests, DISABLED_DuplicateKeyTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree that allows duplicate keys, small enough for every key's duplicates to span leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 4, false);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // every key gets one entry per copy, the copy number is the page id of its rid
+  const int64_t copies = 5;
+  std::mt19937 rng(15445);
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 30; key++) {
+    keys.push_back(key);
+  }
+  for (int64_t copy = 0; copy < copies; copy++) {
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto key : keys) {
+      rid.Set(static_cast<int32_t>(copy), key);
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+    }
+  }
+
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, &rids));
+    ASSERT_EQ(rids.size(), copies);
+    std::vector<int32_t> copy_ids;
+    for (auto &location : rids) {
+      EXPECT_EQ(location.GetSlotNum(), key);
+      copy_ids.push_back(location.GetPageId());
+    }
+    std::sort(copy_ids.begin(), copy_ids.end());
+    for (int64_t copy = 0; copy < copies; copy++) {
+      EXPECT_EQ(copy_ids[copy], copy);
+    }
+  }
+
+  // both directions see every entry, grouped by key
+  int64_t count = 0;
+  int64_t previous = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    int64_t current = (*iterator).first.ToString();
+    EXPECT_LE(previous, current);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current);
+    previous = current;
+    count++;
+  }
+  EXPECT_EQ(count, copies * keys.size());
+  count = 0;
+  previous = keys.size() + 1;
+  for (auto iterator = tree.rbegin(); !iterator.isEnd(); ++iterator) {
+    int64_t current = (*iterator).first.ToString();
+    EXPECT_GE(previous, current);
+    previous = current;
+    count++;
+  }
+  EXPECT_EQ(count, copies * keys.size());
+
+  // a scan starting at a key sees all of its duplicates first
+  index_key.SetFromInteger(17);
+  auto iterator = tree.Begin(index_key);
+  for (int64_t copy = 0; copy < copies; copy++, ++iterator) {
+    ASSERT_FALSE(iterator.isEnd());
+    EXPECT_EQ((*iterator).first.ToString(), 17);
+  }
+  EXPECT_EQ((*iterator).first.ToString(), 18);
+  iterator = tree.end();
+
+  // remove single duplicates by rid: copy 2 of every key, copy 0 of the even keys, and a rid that is not there
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    rid.Set(2, key);
+    tree.Remove(index_key, rid, transaction);
+    if (key % 2 == 0) {
+      rid.Set(0, key);
+      tree.Remove(index_key, rid, transaction);
+    }
+    rid.Set(copies, key);
+    tree.Remove(index_key, rid, transaction);
+  }
+  for (auto key : keys) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    EXPECT_EQ(rids.size(), key % 2 == 0 ? copies - 2 : copies - 1);
+    for (auto &location : rids) {
+      EXPECT_NE(location.GetPageId(), 2);
+      EXPECT_TRUE(key % 2 == 1 || location.GetPageId() != 0);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_TruncatedSeparatorTest) {
+  // a bigint key in an oversized GenericKey<64>
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with the default page sizes
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+  GenericKey<64> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // enough keys for a root with a few hundred children
+  int64_t scale_factor = 20000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // separators keep 8 bytes each, so a 64 byte key type does not shrink the fan-out
+  page_id_t root_page_id;
+  auto header = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  ASSERT_TRUE(header->GetRootId("foo_pk", &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  auto root = reinterpret_cast<BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>> *>(
+      bpm->FetchPage(root_page_id)->GetData());
+  ASSERT_FALSE(root->IsLeafPage());
+  EXPECT_EQ(root->GetKeyWidth(), 8);
+  EXPECT_EQ(root->GetMaxSize(), (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (8 + sizeof(page_id_t)) - 1);
+  EXPECT_TRUE(root->IsRootPage());
+  for (int i = 1; i < root->GetSize(); i++) {
+    EXPECT_LT(root->KeyAt(i - 1).ToString(), root->KeyAt(i).ToString());
+  }
+  bpm->UnpinPage(root_page_id, false);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_SequentialInsertTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 50, 10);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // ascending keys, as an auto increment column produces them
+  int64_t scale_factor = 10000;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  index_key.SetFromInteger(scale_factor);
+  EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+
+  // splits at the right edge leave the left leaf nearly full
+  int64_t leaves = 0;
+  int64_t current_key = 1;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key = current_key + 1;
+  }
+  EXPECT_EQ(current_key, scale_factor + 1);
+  Page *page = tree.FindLeafPage(index_key, true);
+  page_id_t leaf_page_id = page->GetPageId();
+  page->RUnlatch();
+  bpm->UnpinPage(leaf_page_id, false);
+  while (leaf_page_id != INVALID_PAGE_ID) {
+    auto leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(
+        bpm->FetchPage(leaf_page_id)->GetData());
+    page_id_t next_page_id = leaf->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      EXPECT_GE(leaf->GetSize(), 44);
+    }
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = next_page_id;
+    leaves++;
+  }
+  EXPECT_LE(leaves, scale_factor / 44 + 1);
+
+  // the cached right most leaf must follow the tree when it shrinks and grows back
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = scale_factor / 2; key <= scale_factor; key++) {
+    remove_keys.push_back(key);
+  }
+  for (auto key : remove_keys) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (auto key : remove_keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, &rids);
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_BulkLoadTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // even keys only, the odd ones are inserted afterwards
+  int64_t scale_factor = 1000;
+  std::vector<std::pair<GenericKey<8>, RID>> entries;
+  for (int64_t key = 0; key < scale_factor; key += 2) {
+    index_key.SetFromInteger(key);
+    entries.emplace_back(index_key, RID(0, key));
+  }
+  EXPECT_TRUE(tree.BulkLoad(entries));
+  EXPECT_FALSE(tree.BulkLoad(entries));
+  for (int64_t key = 1; key < scale_factor; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(0, key), transaction));
+  }
+  for (int64_t key = 0; key < scale_factor; key += 4) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 4 != 0, tree.GetValue(index_key, &rids));
+  }
+  int64_t current_key = 1;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).first.ToString(), current_key);
+    current_key += current_key % 4 == 3 ? 2 : 1;
+  }
+  EXPECT_EQ(current_key, scale_factor + 1);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_BatchedLookupTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree that keeps duplicates, with small pages so that runs of a key span leaves
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 4, 4, false);
+  GenericKey<8> index_key;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // key k is stored k % 4 times
+  int64_t scale_factor = 400;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    for (int64_t copy = 0; copy < key % 4; copy++) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(copy, key), transaction));
+    }
+  }
+
+  // probes in random order, with repeats and keys past both ends
+  std::mt19937 rng(15445);
+  std::vector<GenericKey<8>> keys(1000);
+  for (auto &key : keys) {
+    key.SetFromInteger(static_cast<int64_t>(rng() % (scale_factor + 20)) - 10);
+  }
+  std::vector<std::vector<RID>> results;
+  tree.GetValues(keys, &results, transaction);
+  ASSERT_EQ(results.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    std::vector<RID> expected;
+    tree.GetValue(keys[i], &expected, transaction);
+    int64_t key = keys[i].ToString();
+    EXPECT_EQ(results[i].size(), key >= 0 && key < scale_factor ? key % 4 : 0);
+    EXPECT_EQ(results[i], expected);
+  }
+  tree.GetValues({}, &results, transaction);
+  EXPECT_TRUE(results.empty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_VariableLengthKeyTest) {
+  // short strings in a GenericKey<64>, the pages only keep the bytes each key uses
+  Schema *key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with the default page sizes
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+  GenericKey<64> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  // keys of different lengths, ordered by their number
+  auto make_key = [&](int64_t key) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "key%06ld", static_cast<long>(key));  // NOLINT
+    Tuple tuple({ValueFactory::GetVarcharValue(std::string(buf) + std::string(key % 13, 'x'))}, key_schema);
+    index_key.SetFromKey(tuple);
+  };
+  int64_t scale_factor = 20000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), key & 0xFFFFFFFF);
+    make_key(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // fixed width separators would allow MaxSizeForKeyWidth(64) children per page
+  using InternalPage = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+  page_id_t root_page_id;
+  auto header = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  ASSERT_TRUE(header->GetRootId("foo_pk", &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  auto root = reinterpret_cast<InternalPage *>(bpm->FetchPage(root_page_id)->GetData());
+  ASSERT_FALSE(root->IsLeafPage());
+  EXPECT_TRUE(root->IsSlotted());
+  EXPECT_EQ(root->GetMaxSize(), InternalPage::MaxSizeForSlottedKeys());
+  int max_children = root->GetSize();
+  for (int i = 0; i < root->GetSize(); i++) {
+    auto child = reinterpret_cast<InternalPage *>(bpm->FetchPage(root->ValueAt(i))->GetData());
+    if (!child->IsLeafPage()) {
+      max_children = std::max(max_children, child->GetSize());
+    }
+    bpm->UnpinPage(child->GetPageId(), false);
+  }
+  EXPECT_GT(max_children, InternalPage::MaxSizeForKeyWidth(64));
+
+  // fixed size leaf entries would allow MaxSizeWithFingerprints() entries per leaf
+  using LeafPage = BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+  page_id_t leaf_page_id = root->ValueAt(0);
+  auto node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  while (!node->IsLeafPage()) {
+    page_id_t child_page_id = reinterpret_cast<InternalPage *>(node)->ValueAt(0);
+    bpm->UnpinPage(leaf_page_id, false);
+    leaf_page_id = child_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  }
+  int max_entries = 0;
+  int64_t entries = 0;
+  while (true) {
+    auto leaf = reinterpret_cast<LeafPage *>(node);
+    EXPECT_TRUE(leaf->IsSlotted());
+    EXPECT_LT(leaf->GetSize(), leaf->GetMaxSize());
+    max_entries = std::max(max_entries, leaf->GetSize());
+    entries += leaf->GetSize();
+    page_id_t next_page_id = leaf->GetNextPageId();
+    bpm->UnpinPage(leaf_page_id, false);
+    if (next_page_id == INVALID_PAGE_ID) {
+      break;
+    }
+    leaf_page_id = next_page_id;
+    node = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(leaf_page_id)->GetData());
+  }
+  EXPECT_EQ(entries, scale_factor);
+  EXPECT_GT(max_entries, LeafPage::MaxSizeWithFingerprints());
+  bpm->UnpinPage(root_page_id, false);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    make_key(key);
+    tree.GetValue(index_key, &rids);
+    ASSERT_EQ(rids.size(), 1);
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+
+  // shrink the tree so that the slotted pages merge and redistribute
+  for (auto key : keys) {
+    if (key % 4 != 0) {
+      make_key(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  int64_t current_key = 4;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 4;
+  }
+  EXPECT_EQ(current_key, scale_factor + 4);
+  for (auto key : keys) {
+    if (key % 4 == 0) {
+      make_key(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_SlottedBulkLoadTest) {
+  Schema *key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  using InternalPage = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+  using LeafPage = BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_entries = [&](int64_t count) {
+    std::vector<std::pair<GenericKey<64>, RID>> entries(count);
+    for (int64_t key = 0; key < count; key++) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "key%06ld", static_cast<long>(key));  // NOLINT
+      entries[key].first.SetFromKey(Tuple({ValueFactory::GetVarcharValue(buf)}, key_schema));
+      entries[key].second.Set(0, key);
+    }
+    return entries;
+  };
+  auto fetch_root = [&](const std::string &name) {
+    page_id_t root_page_id;
+    auto header = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+    EXPECT_TRUE(header->GetRootId(name, &root_page_id));
+    bpm->UnpinPage(HEADER_PAGE_ID, false);
+    return reinterpret_cast<InternalPage *>(bpm->FetchPage(root_page_id)->GetData());
+  };
+
+  // a first load finds how many leaves fill a slotted internal page and how many entries fill a leaf
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> probe("probe_pk", bpm, comparator);
+  EXPECT_TRUE(probe.BulkLoad(make_entries(50000)));
+  auto root = fetch_root("probe_pk");
+  ASSERT_FALSE(root->IsLeafPage());
+  auto child = reinterpret_cast<InternalPage *>(bpm->FetchPage(root->ValueAt(0))->GetData());
+  ASSERT_FALSE(child->IsLeafPage());
+  int children = child->GetSize();
+  auto leaf = reinterpret_cast<LeafPage *>(bpm->FetchPage(child->ValueAt(0))->GetData());
+  // slotted leaves are filled by space, the keys all have the same length
+  int leaf_entries = leaf->GetSize();
+  bpm->UnpinPage(leaf->GetPageId(), false);
+  bpm->UnpinPage(child->GetPageId(), false);
+  bpm->UnpinPage(root->GetPageId(), false);
+
+  // one leaf more than a page takes: the second internal page would get a single child
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+  EXPECT_TRUE(tree.BulkLoad(make_entries(static_cast<int64_t>(children + 1) * leaf_entries)));
+  root = fetch_root("foo_pk");
+  ASSERT_EQ(root->GetSize(), 2);
+  std::vector<int> sizes;
+  for (int i = 0; i < root->GetSize(); i++) {
+    child = reinterpret_cast<InternalPage *>(bpm->FetchPage(root->ValueAt(i))->GetData());
+    sizes.push_back(child->GetSize());
+    bpm->UnpinPage(child->GetPageId(), false);
+  }
+  bpm->UnpinPage(root->GetPageId(), false);
+  EXPECT_EQ(sizes[0] + sizes[1], children + 1);
+  EXPECT_LE(std::abs(sizes[0] - sizes[1]), 1);
+
+  int64_t current_key = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key++;
+  }
+  EXPECT_EQ(current_key, static_cast<int64_t>(children + 1) * leaf_entries);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_ShortestSeparatorTest) {
+  // strings with a long common tail, the leading digits alone tell neighbouring keys apart
+  Schema *key_schema = ParseCreateStatement("a varchar(40)");
+  GenericComparator<64> comparator(key_schema);
+  auto to_key = [&](const std::string &value) {
+    GenericKey<64> key;
+    key.SetFromKey(Tuple({ValueFactory::GetVarcharValue(value)}, key_schema));
+    return key;
+  };
+  auto to_string = [&](const GenericKey<64> &key) { return key.ToValue(key_schema, 0).ToString(); };
+  EXPECT_EQ(to_string(comparator.Separator(to_key("apple"), to_key("apricot"))), "apr");
+  EXPECT_EQ(to_string(comparator.Separator(to_key("app"), to_key("apple"))), "appl");
+  EXPECT_EQ(to_string(comparator.Separator(to_key("apple"), to_key("apple"))), "apple");
+  // a key longer than the index key is rejected rather than cut off
+  EXPECT_THROW(to_key(std::string(64, 'x')), Exception);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree with the default page sizes
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm, comparator);
+  GenericKey<64> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_key = [&](int64_t key) {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%06ld", static_cast<long>(key));  // NOLINT
+    index_key = to_key(std::string(buf) + std::string(30, 'x'));
+  };
+  int64_t scale_factor = 20000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    make_key(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+
+  // no separator keeps the tail, the six digits always suffice
+  using InternalPage = BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+  page_id_t root_page_id;
+  auto header = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  ASSERT_TRUE(header->GetRootId("foo_pk", &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  std::vector<page_id_t> pages{root_page_id};
+  int internal_pages = 0;
+  while (!pages.empty()) {
+    auto node = reinterpret_cast<InternalPage *>(bpm->FetchPage(pages.back())->GetData());
+    pages.pop_back();
+    if (!node->IsLeafPage()) {
+      internal_pages++;
+      for (int i = 0; i < node->GetSize(); i++) {
+        if (i > 0) {
+          EXPECT_LE(to_string(node->KeyAt(i)).size(), 6);
+        }
+        pages.push_back(node->ValueAt(i));
+      }
+    }
+    bpm->UnpinPage(node->GetPageId(), false);
+  }
+  EXPECT_GT(internal_pages, 1);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    make_key(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  // redistributions set shortened separators as well
+  for (auto key : keys) {
+    if (key % 4 != 0) {
+      make_key(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  int64_t current_key = 4;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ((*iterator).second.GetSlotNum(), current_key);
+    current_key += 4;
+  }
+  EXPECT_EQ(current_key, scale_factor + 4);
+  for (int64_t key = 1; key <= scale_factor; key++) {
+    rids.clear();
+    make_key(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 4 == 0);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_LeafFingerprintTest) {
+  // a two column key is not searched as an integer, so the leaves keep fingerprints
+  Schema *key_schema = ParseCreateStatement("a bigint,b bigint");
+  GenericComparator<16> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<16>, RID, GenericComparator<16>> tree("foo_pk", bpm, comparator);
+  GenericKey<16> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_key = [&](int64_t key) {
+    Tuple tuple({ValueFactory::GetBigIntValue(key / 7), ValueFactory::GetBigIntValue(key % 7)}, key_schema);
+    index_key.SetFromKey(tuple);
+  };
+  int64_t scale_factor = 5000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    keys.push_back(key * 2);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    make_key(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  // duplicates are found through the fingerprints too
+  for (int64_t key = 0; key < scale_factor; key += 10) {
+    make_key(key * 2);
+    EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+  }
+
+  using LeafPage = BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+  make_key(0);
+  Page *page = tree.FindLeafPage(index_key);
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  EXPECT_TRUE(leaf->HasFingerprints());
+  EXPECT_EQ(leaf->GetMaxSize(), LeafPage::MaxSizeWithFingerprints());
+  page->RUnlatch();
+  bpm->UnpinPage(page->GetPageId(), false);
+
+  // even keys are in the tree, odd keys miss
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < scale_factor * 2; key++) {
+    rids.clear();
+    make_key(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 0);
+    if (key % 2 == 0) {
+      ASSERT_EQ(rids.size(), 1);
+      EXPECT_EQ(rids[0].GetSlotNum(), key);
+    }
+  }
+
+  // removes shift the fingerprints along with the entries and merges move them between leaves
+  for (auto key : keys) {
+    if (key % 3 != 0) {
+      make_key(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  for (int64_t key = 0; key < scale_factor * 2; key += 2) {
+    rids.clear();
+    make_key(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 3 == 0);
+  }
+  for (auto key : keys) {
+    make_key(key);
+    tree.Remove(index_key, transaction);
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, DISABLED_CoveringKeyFingerprintTest) {
+  // a two column key with an included column stored behind it, probes only carry the key columns
+  Schema *key_schema = ParseCreateStatement("a bigint,b bigint");
+  Schema *entry_schema = ParseCreateStatement("a bigint,b bigint,c bigint");
+  GenericComparator<32> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<32>, RID, GenericComparator<32>> tree("foo_pk", bpm, comparator);
+  GenericKey<32> index_key;
+  RID rid;
+  // create transaction
+  Transaction *transaction = new Transaction(0);
+
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  auto make_entry = [&](int64_t key, int64_t included) {
+    Tuple tuple({ValueFactory::GetBigIntValue(key / 7), ValueFactory::GetBigIntValue(key % 7),
+                 ValueFactory::GetBigIntValue(included)},
+                entry_schema);
+    index_key.SetFromKey(tuple);
+  };
+  auto make_probe = [&](int64_t key) {
+    Tuple tuple({ValueFactory::GetBigIntValue(key / 7), ValueFactory::GetBigIntValue(key % 7)}, key_schema);
+    index_key.SetFromKey(tuple);
+  };
+  int64_t scale_factor = 3000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    keys.push_back(key);
+  }
+  std::mt19937 rng(15445);
+  std::shuffle(keys.begin(), keys.end(), rng);
+  for (auto key : keys) {
+    rid.Set(0, key);
+    make_entry(key, key * 3 + 1);
+    EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+  }
+  // the same key with another included value is still a duplicate
+  for (int64_t key = 0; key < scale_factor; key += 10) {
+    make_entry(key, -1);
+    EXPECT_FALSE(tree.Insert(index_key, rid, transaction));
+  }
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < scale_factor; key++) {
+    rids.clear();
+    make_probe(key);
+    ASSERT_TRUE(tree.GetValue(index_key, &rids));
+    EXPECT_EQ(rids[0].GetSlotNum(), key);
+  }
+  for (auto key : keys) {
+    if (key % 2 == 0) {
+      make_probe(key);
+      tree.Remove(index_key, transaction);
+    }
+  }
+  for (int64_t key = 0; key < scale_factor; key++) {
+    rids.clear();
+    make_probe(key);
+    EXPECT_EQ(tree.GetValue(index_key, &rids), key % 2 == 1);
+  }
+  int64_t size = 0;
+  for (auto iterator = tree.begin(); !iterator.isEnd(); ++iterator) {
+    size++;
+  }
+  EXPECT_EQ(size, scale_factor / 2);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete entry_schema;
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 }  // namespace bustub
@@ -0,0 +1,215 @@
+/**
+ * b_plus_tree_search_test.cpp
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "b_plus_tree_test_util.h"  // NOLINT
+#include "common/rid.h"
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/int_comparator.h"
+#include "storage/index/key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+
+namespace bustub {
+
+template <typename IntT>
+void CheckKeySearch(int size, std::mt19937_64 *rng) {
+  std::uniform_int_distribution<int64_t> dist(-1000, 1000);
+  std::vector<IntT> keys(size);
+  for (auto &key : keys) {
+    key = static_cast<IntT>(dist(*rng));
+  }
+  std::sort(keys.begin(), keys.end());
+  // the same keys interleaved with values, as in a B+ tree page
+  std::vector<std::pair<IntT, RID>> entries(size);
+  for (int i = 0; i < size; i++) {
+    entries[i] = {keys[i], RID(i, i)};
+  }
+  const char *base = reinterpret_cast<const char *>(entries.data());
+
+  for (int64_t probe = -1002; probe <= 1002; probe += 7) {
+    auto target = static_cast<IntT>(probe);
+    int lower = std::lower_bound(keys.begin(), keys.end(), target) - keys.begin();
+    int upper = std::upper_bound(keys.begin(), keys.end(), target) - keys.begin();
+    EXPECT_EQ(lower, ContiguousKeySearch(keys.data(), size, target));
+    EXPECT_EQ(upper, (ContiguousKeySearch<IntT, true>(keys.data(), size, target)));
+    EXPECT_EQ(lower, StridedKeySearch(base, sizeof(entries[0]), 0, size, target));
+    EXPECT_EQ(upper, (StridedKeySearch<IntT, true>(base, sizeof(entries[0]), 0, size, target)));
+    EXPECT_EQ(lower, IntegerKeySearch(base, sizeof(entries[0]), 0, size, reinterpret_cast<const char *>(&target),
+                                      sizeof(IntT)));
+  }
+}
+
+TEST(BPlusTreeSearchTest, KeySearchTest) {
+  std::mt19937_64 rng(15445);
+  for (int size : {0, 1, 3, 8, 15, 16, 17, 33, 100, 255}) {
+    CheckKeySearch<int8_t>(size, &rng);
+    CheckKeySearch<int16_t>(size, &rng);
+    CheckKeySearch<int32_t>(size, &rng);
+    CheckKeySearch<int64_t>(size, &rng);
+  }
+}
+
+TEST(BPlusTreeSearchTest, IntegerComparatorTest) {
+  Schema *bigint_schema = ParseCreateStatement("a bigint");
+  Schema *narrow_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(bigint_schema);
+  EXPECT_EQ(8, comparator.IntegerKeyWidth());
+  GenericComparator<4> narrow_comparator(narrow_schema);
+  EXPECT_EQ(0, narrow_comparator.IntegerKeyWidth());
+
+  GenericKey<8> lhs;
+  GenericKey<8> rhs;
+  std::vector<int64_t> values = {INT64_MIN + 1, -4096, -1, 0, 1, 255, 256, 1LL << 40, INT64_MAX};
+  for (auto a : values) {
+    for (auto b : values) {
+      lhs.SetFromInteger(a);
+      rhs.SetFromInteger(b);
+      int expected = (a > b) - (a < b);
+      EXPECT_EQ(expected, comparator(lhs, rhs));
+    }
+  }
+  delete bigint_schema;
+  delete narrow_schema;
+}
+
+template <typename F>
+double TimeLookups(int rounds, F &&lookup) {
+  auto start = std::chrono::steady_clock::now();
+  lookup(rounds);
+  std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+  return elapsed.count() / rounds;
+}
+
+/*
+ * Microbenchmark for the search within one full page. Prints ns per lookup for the scalar binary search used before,
+ * the strided SIMD kernel over the interleaved (key, value) layout and the contiguous key layout.
+ */
+TEST(BPlusTreeSearchTest, DISABLED_SearchBenchmark) {
+  const int rounds = 2000000;
+  std::mt19937 rng(15445);
+
+  // IntComparator over a leaf sized array of int keys
+  {
+    const int size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<int, RID>);
+    std::vector<int> keys(size);
+    std::vector<std::pair<int, RID>> entries(size);
+    for (int i = 0; i < size; i++) {
+      keys[i] = i * 2;
+      entries[i] = {i * 2, RID(i, i)};
+    }
+    std::vector<int> probes(4096);
+    for (auto &probe : probes) {
+      probe = static_cast<int>(rng() % (2 * size));
+    }
+    IntComparator comparator;
+    int64_t sink = 0;
+    double scalar = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        int target = probes[r & 4095];
+        int left = 0;
+        int right = size - 1;
+        while (left <= right) {
+          int mid = (left + right) / 2;
+          if (comparator(entries[mid].first, target) >= 0) {
+            right = mid - 1;
+          } else {
+            left = mid + 1;
+          }
+        }
+        sink += right + 1;
+      }
+    });
+    const char *base = reinterpret_cast<const char *>(entries.data());
+    double strided = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        sink += StridedKeySearch<int32_t>(base, sizeof(entries[0]), 0, size, probes[r & 4095]);
+      }
+    });
+    double contiguous = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        sink += ContiguousKeySearch<int32_t>(keys.data(), size, probes[r & 4095]);
+      }
+    });
+    printf("IntComparator, %d keys: binary %.1f ns, strided simd %.1f ns, contiguous simd %.1f ns (%ld)\n", size,
+           scalar, strided, contiguous, static_cast<long>(sink));  // NOLINT
+  }
+
+  // GenericKey<8> over a full leaf page
+  {
+    Schema *key_schema = ParseCreateStatement("a bigint");
+    GenericComparator<8> comparator(key_schema);
+    using Entry = std::pair<GenericKey<8>, RID>;
+    const int size = (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(Entry);
+    std::vector<Entry> entries(size);
+    std::vector<int64_t> keys(size);
+    for (int i = 0; i < size; i++) {
+      entries[i].first.SetFromInteger(i * 2);
+      keys[i] = i * 2;
+    }
+    std::vector<GenericKey<8>> probes(4096);
+    for (auto &probe : probes) {
+      probe.SetFromInteger(rng() % (2 * size));
+    }
+    int64_t sink = 0;
+    // the comparison GenericComparator used to do for every key: materialize and compare Values
+    double values = TimeLookups(rounds / 10, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        const GenericKey<8> &target = probes[r & 4095];
+        Value target_value = target.ToValue(key_schema, 0);
+        int left = 0;
+        int right = size - 1;
+        while (left <= right) {
+          int mid = (left + right) / 2;
+          if (entries[mid].first.ToValue(key_schema, 0).CompareLessThan(target_value) != CmpBool::CmpTrue) {
+            right = mid - 1;
+          } else {
+            left = mid + 1;
+          }
+        }
+        sink += right + 1;
+      }
+    });
+    double scalar = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        const GenericKey<8> &target = probes[r & 4095];
+        int left = 0;
+        int right = size - 1;
+        while (left <= right) {
+          int mid = (left + right) / 2;
+          if (comparator(entries[mid].first, target) >= 0) {
+            right = mid - 1;
+          } else {
+            left = mid + 1;
+          }
+        }
+        sink += right + 1;
+      }
+    });
+    const char *base = reinterpret_cast<const char *>(entries.data());
+    double strided = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        sink += IntegerKeySearch(base, sizeof(Entry), 0, size,
+                                 reinterpret_cast<const char *>(&probes[r & 4095]), comparator.IntegerKeyWidth());
+      }
+    });
+    double contiguous = TimeLookups(rounds, [&](int n) {
+      for (int r = 0; r < n; r++) {
+        sink += ContiguousKeySearch<int64_t>(keys.data(), size, probes[r & 4095].ToString());
+      }
+    });
+    printf("GenericKey<8>, %d keys: value compare %.1f ns, binary %.1f ns, strided simd %.1f ns, "  // NOLINT
+           "contiguous simd %.1f ns (%ld)\n",
+           size, values, scalar, strided, contiguous, static_cast<long>(sink));  // NOLINT
+    delete key_schema;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// header_page_test.cpp
+//
+// Identification: test/storage/header_page_test.cpp
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, RecordTest) {
+  // a zeroed page is an empty header, the way a fresh database file reads
+  HeaderPage page{};
+  EXPECT_EQ(0, page.GetRecordCount());
+
+  const int count = HeaderPage::MAX_RECORD_COUNT;
+  page_id_t root_id;
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(page.InsertRecord("index_" + std::to_string(i), i + 1));
+  }
+  EXPECT_FALSE(page.InsertRecord("index_0", 1));
+  EXPECT_FALSE(page.InsertRecord("one_too_many", 1));
+  EXPECT_EQ(count, page.GetRecordCount());
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(page.GetRootId("index_" + std::to_string(i), &root_id));
+    EXPECT_EQ(i + 1, root_id);
+  }
+  EXPECT_FALSE(page.GetRootId("index_" + std::to_string(count), &root_id));
+
+  // deleting moves the later records, they must stay reachable
+  for (int i = 0; i < count; i += 2) {
+    EXPECT_TRUE(page.DeleteRecord("index_" + std::to_string(i)));
+  }
+  EXPECT_FALSE(page.DeleteRecord("index_0"));
+  for (int i = 1; i < count; i += 2) {
+    EXPECT_TRUE(page.UpdateRecord("index_" + std::to_string(i), i * 10));
+  }
+  for (int i = 0; i < count; i++) {
+    bool found = page.GetRootId("index_" + std::to_string(i), &root_id);
+    EXPECT_EQ(i % 2 == 1, found);
+    if (found) {
+      EXPECT_EQ(i * 10, root_id);
+    }
+  }
+  EXPECT_FALSE(page.UpdateRecord("index_0", 7));
+  EXPECT_TRUE(page.InsertRecord("index_0", 7));
+  EXPECT_TRUE(page.GetRootId("index_0", &root_id));
+  EXPECT_EQ(7, root_id);
+}
+
+// NOLINTNEXTLINE
+TEST(HeaderPageTest, UnhashedPageTest) {
+  // a page written before the slots existed: the record count and the records right behind it
+  HeaderPage page{};
+  auto write_records = [&page](int count) {
+    memset(page.GetData(), 0, PAGE_SIZE);
+    memcpy(page.GetData(), &count, 4);
+    for (int i = 0; i < count; i++) {
+      std::string name = "index_" + std::to_string(i);
+      page_id_t root_id = i + 1;
+      char *record = page.GetData() + HeaderPage::UNHASHED_RECORDS_OFFSET + i * HeaderPage::RECORD_SIZE;
+      memcpy(record, name.c_str(), name.length() + 1);
+      memcpy(record + 32, &root_id, 4);
+    }
+  };
+  page_id_t root_id;
+  const int count = 40;
+  write_records(count);
+  EXPECT_EQ(count, page.GetRecordCount());
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(page.GetRootId("index_" + std::to_string(i), &root_id));
+    EXPECT_EQ(i + 1, root_id);
+  }
+  // the first write moves the records behind the slots, they are found there afterwards
+  EXPECT_TRUE(page.UpdateRecord("index_3", 100));
+  EXPECT_EQ(count, page.GetRecordCount());
+  for (int i = 0; i < count; i++) {
+    EXPECT_TRUE(page.GetRootId("index_" + std::to_string(i), &root_id));
+    EXPECT_EQ(i == 3 ? 100 : i + 1, root_id);
+  }
+  int inserted = 0;
+  while (page.InsertRecord("more_" + std::to_string(inserted), 1)) {
+    inserted++;
+  }
+  EXPECT_EQ(HeaderPage::MAX_RECORD_COUNT, count + inserted);
+
+  // more records than the hashed format holds stay where they are
+  write_records(HeaderPage::UNHASHED_MAX_RECORD_COUNT - 1);
+  EXPECT_TRUE(page.InsertRecord("last", 9));
+  EXPECT_FALSE(page.InsertRecord("one_too_many", 9));
+  EXPECT_TRUE(page.DeleteRecord("index_0"));
+  EXPECT_TRUE(page.GetRootId("last", &root_id));
+  EXPECT_EQ(9, root_id);
+  EXPECT_TRUE(page.GetRootId("index_1", &root_id));
+  EXPECT_EQ(2, root_id);
+  EXPECT_EQ(HeaderPage::UNHASHED_MAX_RECORD_COUNT - 1, page.GetRecordCount());
+}
+
+}  // namespace bustub